@@ -0,0 +1,54 @@
+QT -= gui
+QT += core network testlib
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = aks_benchmarks
+
+include(../src/core.pri)
+
+INCLUDEPATH += ../headless
+
+SOURCES += \
+    main.cpp \
+    ../headless/AKSService.cpp \
+    AllocationCounter.cpp \
+    AKSServiceBenchmark.cpp \
+    BinaryLogBenchmark.cpp \
+    CoreBenchmark.cpp \
+    EventBusBenchmark.cpp \
+    LinkStatisticsBenchmark.cpp \
+    LivenessBenchmark.cpp \
+    LogArchiverBenchmark.cpp \
+    LoggerBenchmark.cpp \
+    MetricsBenchmark.cpp \
+    NetworkConfigBenchmark.cpp \
+    ProtocolBenchmark.cpp \
+    ReplayBenchmark.cpp \
+    StartupTimelineBenchmark.cpp \
+    TelemetryHistoryBenchmark.cpp \
+    TraceBenchmark.cpp
+
+HEADERS += \
+    ../headless/AKSService.h \
+    AllocationCounter.h \
+    AKSServiceBenchmark.h \
+    BinaryLogBenchmark.h \
+    CoreBenchmark.h \
+    EventBusBenchmark.h \
+    LinkStatisticsBenchmark.h \
+    LivenessBenchmark.h \
+    LogArchiverBenchmark.h \
+    LogLevelGuard.h \
+    LoggerBenchmark.h \
+    MetricsBenchmark.h \
+    NetworkConfigBenchmark.h \
+    ProtocolBenchmark.h \
+    ReplayBenchmark.h \
+    StartupTimelineBenchmark.h \
+    TelemetryHistoryBenchmark.h \
+    TraceBenchmark.h
+
+DISTFILES += \
+    compare_results.py
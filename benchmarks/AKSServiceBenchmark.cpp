@@ -0,0 +1,280 @@
+#include "AKSServiceBenchmark.h"
+#include "AKSService.h"
+#include "MonotonicClock.h"
+#include "Protocol.h"
+#include <QUdpSocket>
+#include <QtTest>
+
+namespace
+{
+    const int REPLY_TIMEOUT_MS = 5000; // Longest wait for a reply or an event line
+    const char MISSILE_CONFIG[] = "0,SOM A,true\n1,J-600T,false\n3,Bora,true\n"; // Missile 2 is not configured
+
+    // An AKSService on a ManualClock with a connected IPC client and a UDP socket standing in for ANS
+    struct ServiceFixture
+    {
+        ManualClock clock;                   // Core time
+        QTemporaryDir directory;             // Holds the missile configuration
+        QUdpSocket ans;                      // Sends as ANS
+        AKSService service{nullptr, &clock}; // Under test
+        QLocalSocket client;                 // IPC client
+        quint16 aksPort = 0;                 // UDP port the core is bound to
+
+        // Bind the sockets, start the service and connect the client; false if any of it failed
+        bool start()
+        {
+            QUdpSocket probe; // Pick a free port for the core
+            if (!directory.isValid() || !probe.bind(QHostAddress::LocalHost, 0) || !ans.bind(QHostAddress::LocalHost, 0))
+            {
+                return false;
+            }
+            aksPort = probe.localPort();
+            probe.close();
+
+            NetworkConfig network;
+            network.bind.port = aksPort;
+            network.ans.port = ans.localPort();
+            service.setNetworkConfig(network);
+
+            const QString configPath = directory.filePath("missiles.conf");
+            QFile config(configPath);
+            if (!config.open(QIODevice::WriteOnly) || config.write(MISSILE_CONFIG) != qint64(sizeof(MISSILE_CONFIG) - 1))
+            {
+                return false;
+            }
+            config.close();
+
+            const QString serverName = QString("aks_benchmark_%1").arg(QCoreApplication::applicationPid());
+            if (!service.start(configPath, serverName) || clock.activeTimerCount() == 0)
+            {
+                return false; // IPC name or UDP port taken
+            }
+            return connect(client, serverName);
+        }
+
+        // Connect another client to the service
+        bool connect(QLocalSocket &socket, const QString &serverName)
+        {
+            socket.connectToServer(serverName);
+            return socket.waitForConnected(REPLY_TIMEOUT_MS);
+        }
+
+        // Send a datagram to the core as ANS
+        void sendAsAns(const QByteArray &datagram)
+        {
+            ans.writeDatagram(datagram, QHostAddress(QHostAddress::LocalHost), aksPort);
+        }
+    };
+
+    // Next line from 'socket' without its '\n', waiting for it; empty if none arrived in time
+    QByteArray nextLine(QLocalSocket &socket)
+    {
+        if (!QTest::qWaitFor([&socket]()
+                             { return socket.canReadLine(); },
+                             REPLY_TIMEOUT_MS))
+        {
+            return QByteArray();
+        }
+        return socket.readLine().chopped(1);
+    }
+
+    // Send 'command' and collect lines up to the one that ends its reply
+    QList<QByteArray> request(QLocalSocket &socket, const QByteArray &command)
+    {
+        socket.write(command + '\n');
+        QList<QByteArray> lines;
+        for (;;)
+        {
+            const QByteArray line = nextLine(socket);
+            lines.append(line);
+            if (line.isEmpty() || line == "OK" || line.startsWith("ERR ") || line.startsWith("STATUS ") || line.startsWith("PLATFORM "))
+            {
+                return lines;
+            }
+        }
+    }
+
+    // A single-line reply as a one-element list
+    QList<QByteArray> reply(const QByteArray &line)
+    {
+        return QList<QByteArray>() << line;
+    }
+
+    // Send a position as ANS and wait until the service reports it
+    bool sendPosition(ServiceFixture &fixture, const QByteArray &position, const QByteArray &reported)
+    {
+        fixture.sendAsAns("PLATFORM_INFO," + position);
+        return QTest::qWaitFor([&fixture, &reported]()
+                               { return request(fixture.client, "PLATFORM") == reply("PLATFORM " + reported); },
+                               REPLY_TIMEOUT_MS);
+    }
+}
+
+// Case, whitespace, pipelined and split lines, unknown commands and QUIT
+void AKSServiceBenchmark::commandParsing()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QLocalSocket &client = fixture.client;
+
+    QCOMPARE(request(client, "STATUS"), reply("STATUS ans=down launcher=down"));
+    QCOMPARE(request(client, "  status\t "), reply("STATUS ans=down launcher=down"));
+    QCOMPARE(request(client, "MISSILES"), QList<QByteArray>() << "MISSILE 0 Healthy SOM A"
+                                                              << "MISSILE 1 Unhealthy J-600T"
+                                                              << "MISSILE 3 Healthy Bora"
+                                                              << "OK");
+    QCOMPARE(request(client, "PLATFORM"), reply("ERR no platform info"));
+    QCOMPARE(request(client, "BOGUS 1 2"), reply("ERR unknown command"));
+    QCOMPARE(request(client, "STATUSX"), reply("ERR unknown command"));
+
+    // Several commands in one write are answered in order
+    QCOMPARE(request(client, "PLATFORM\nLINK"), QList<QByteArray>() << "ERR no platform info");
+    QCOMPARE(nextLine(client), QByteArray("LINK ANS received=0 lost=0 reordered=0 jitter_us=0 rtt_us=0"));
+    QCOMPARE(nextLine(client), QByteArray("LINK Launcher received=0 lost=0 reordered=0 jitter_us=0 rtt_us=0"));
+    QCOMPARE(nextLine(client), QByteArray("OK"));
+
+    // A command split across writes runs once its line is complete
+    client.write("STA");
+    QTest::qWait(50);
+    QCOMPARE(client.bytesAvailable(), qint64(0));
+    QCOMPARE(request(client, "TUS"), reply("STATUS ans=down launcher=down"));
+
+    client.write("quit\n"); // No reply, the service closes the connection
+    QTRY_COMPARE_WITH_TIMEOUT(client.state(), QLocalSocket::UnconnectedState, REPLY_TIMEOUT_MS);
+}
+
+// POWER, TARGET and HISTORY with missing or malformed arguments
+void AKSServiceBenchmark::usageErrors()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QLocalSocket &client = fixture.client;
+
+    const char *power[] = {"POWER", "POWER x", "POWER 1 2", "POWER 1.5"};
+    for (const char *command : power)
+    {
+        QCOMPARE(request(client, command), reply("ERR usage: POWER <index>"));
+    }
+    const char *target[] = {"TARGET", "TARGET 39 32 850 250", "TARGET 39 32 850 250 far", "TARGET 39 32 850 250 1000 1"};
+    for (const char *command : target)
+    {
+        QCOMPARE(request(client, command), reply("ERR usage: TARGET <lat> <lon> <alt> <speed> <distance>"));
+    }
+    const char *history[] = {"HISTORY x", "HISTORY 0", "HISTORY -5", "HISTORY inf", "HISTORY nan"};
+    for (const char *command : history)
+    {
+        QCOMPARE(request(client, command), reply("ERR usage: HISTORY [seconds]"));
+    }
+    QCOMPARE(request(client, "MISSILES").size(), 4); // Nothing was changed by the rejected commands
+    QCOMPARE(request(client, "MISSILES").at(0), QByteArray("MISSILE 0 Healthy SOM A"));
+}
+
+// A refusal raised by AKSCore while a command runs becomes its reply, and only its reply
+void AKSServiceBenchmark::coreErrors()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QLocalSocket &client = fixture.client;
+
+    QCOMPARE(request(client, "POWER 9"), reply("ERR Invalid missile index: 9"));
+    QCOMPARE(request(client, "POWER 1"), reply("ERR Cannot toggle power for missile 1: Missile is unhealthy"));
+    QCOMPARE(request(client, "LAUNCH"), reply("ERR Launcher communication is down. Cannot launch any missile!"));
+    QCOMPARE(request(client, "TARGET 100 32 850 250 1000"), reply("ERR Invalid latitude value"));
+    QCOMPARE(request(client, "TARGET 39 32 -1 250 1000"), reply("ERR Invalid altitude value"));
+
+    // Accepted commands answer OK: the previous error does not linger
+    QCOMPARE(request(client, "TARGET 39.92 32.85 850 250 1000"), reply("OK"));
+    QCOMPARE(request(client, "POWER 0"), reply("OK"));
+    QCOMPARE(request(client, "MISSILES").at(0), QByteArray("MISSILE 0 Powered SOM A"));
+    QCOMPARE(request(client, "power 0"), reply("OK"));
+    QCOMPARE(request(client, "MISSILES").at(0), QByteArray("MISSILE 0 Healthy SOM A"));
+}
+
+// Subscribers get EVENT lines for missiles, errors, links and positions; other clients do not
+void AKSServiceBenchmark::subscribe()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QLocalSocket &subscriber = fixture.client;
+    QLocalSocket other;
+    QVERIFY(fixture.connect(other, subscriber.serverName()));
+
+    QCOMPARE(request(subscriber, "SUBSCRIBE"), reply("OK"));
+    QCOMPARE(request(subscriber, "SUBSCRIBE"), reply("OK")); // Subscribing twice does not double the events
+
+    // Events a command causes arrive before its reply
+    QCOMPARE(request(subscriber, "POWER 0"), QList<QByteArray>() << "EVENT MISSILE 0 Powered SOM A" << "OK");
+    QCOMPARE(request(subscriber, "POWER 1"), QList<QByteArray>() << "EVENT ERROR Cannot toggle power for missile 1: Missile is unhealthy"
+                                                                 << "ERR Cannot toggle power for missile 1: Missile is unhealthy");
+
+    // A command from another client reaches the subscriber as an event only
+    QCOMPARE(request(other, "POWER 3"), reply("OK"));
+    QCOMPARE(nextLine(subscriber), QByteArray("EVENT MISSILE 0 Healthy SOM A")); // Powered off for the new selection
+    QCOMPARE(nextLine(subscriber), QByteArray("EVENT MISSILE 3 Powered Bora"));
+
+    fixture.sendAsAns(Protocol::ANS_HEARTBEAT_TEXT);
+    QCOMPARE(nextLine(subscriber), QByteArray("EVENT COMM ans=up launcher=down"));
+    fixture.sendAsAns("PLATFORM_INFO,39.9208,32.8541,850.5");
+    QCOMPARE(nextLine(subscriber), QByteArray("EVENT PLATFORM 39.920800 32.854100 850.50"));
+
+    QCOMPARE(request(other, "STATUS"), reply("STATUS ans=up launcher=down")); // No EVENT lines before the reply
+    QTest::qWait(50);
+    QCOMPARE(other.bytesAvailable(), qint64(0));
+    QCOMPARE(subscriber.bytesAvailable(), qint64(0));
+}
+
+// HISTORY spans are relative to the newest sample; huge spans are clamped instead of overflowing
+void AKSServiceBenchmark::historyClamp()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QLocalSocket &client = fixture.client;
+    QCOMPARE(request(client, "HISTORY"), reply("OK")); // Nothing received yet
+
+    QVERIFY(sendPosition(fixture, "39.9,32.8,850", "39.900000 32.800000 850.00"));
+    fixture.clock.advanceMs(400);
+    QVERIFY(sendPosition(fixture, "39.91,32.81,860", "39.910000 32.810000 860.00"));
+    fixture.clock.advanceMs(600);
+    QVERIFY(sendPosition(fixture, "39.92,32.82,870", "39.920000 32.820000 870.00"));
+
+    const QList<QByteArray> all = QList<QByteArray>() << "SAMPLE -1000 39.900000 32.800000 850.00"
+                                                      << "SAMPLE -600 39.910000 32.810000 860.00"
+                                                      << "SAMPLE 0 39.920000 32.820000 870.00"
+                                                      << "OK";
+    QCOMPARE(request(client, "HISTORY"), all);
+    QCOMPARE(request(client, "HISTORY 0.5"), QList<QByteArray>() << all[2] << "OK");
+    QCOMPARE(request(client, "HISTORY 0.7"), QList<QByteArray>() << all[1] << all[2] << "OK");
+    QCOMPARE(request(client, "HISTORY 1e300"), all); // Clamped to 1e9 s; the raw span would overflow qint64
+    QCOMPARE(request(client, "HISTORY 9.3e9"), all);
+}
+
+// Cost of one STATUS request and its reply over the local socket
+void AKSServiceBenchmark::statusRoundTrip()
+{
+    ServiceFixture fixture;
+    if (!fixture.start())
+    {
+        QSKIP("The IPC name or a UDP port is in use");
+    }
+    QList<QByteArray> lines;
+    QBENCHMARK
+    {
+        lines = request(fixture.client, "STATUS");
+    }
+    QCOMPARE(lines, reply("STATUS ans=down launcher=down"));
+}
@@ -0,0 +1,20 @@
+#ifndef AKSSERVICEBENCHMARK_H
+#define AKSSERVICEBENCHMARK_H
+
+#include <QObject>
+
+// The headless IPC protocol over a QLocalSocket, with the core on a ManualClock
+class AKSServiceBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void commandParsing();  // Case, whitespace, pipelined and split lines, unknown commands and QUIT
+    void usageErrors();     // POWER, TARGET and HISTORY with missing or malformed arguments
+    void coreErrors();      // A refusal raised by AKSCore while a command runs becomes its reply, and only its reply
+    void subscribe();       // Subscribers get EVENT lines for missiles, errors, links and positions; other clients do not
+    void historyClamp();    // HISTORY spans are relative to the newest sample; huge spans are clamped instead of overflowing
+    void statusRoundTrip(); // Cost of one STATUS request and its reply over the local socket
+};
+
+#endif
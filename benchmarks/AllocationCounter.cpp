@@ -0,0 +1,73 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local quint64 allocationCount = 0; // Allocations made by this thread
+}
+
+#if defined(__GLIBC__)
+// Qt containers allocate with malloc/realloc directly, so on glibc the C allocator itself is interposed
+// and operator new (which calls malloc) is counted through it.
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *block, size_t size);
+
+    void *malloc(size_t size)
+    {
+        ++allocationCount;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t count, size_t size)
+    {
+        ++allocationCount;
+        return __libc_calloc(count, size);
+    }
+
+    void *realloc(void *block, size_t size)
+    {
+        ++allocationCount;
+        return __libc_realloc(block, size);
+    }
+}
+#else
+// Elsewhere only C++ allocations are counted
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    void *block = std::malloc(size ? size : 1);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    std::free(block);
+}
+#endif
+
+namespace AllocationCounter
+{
+    // Allocations made by the calling thread since it started
+    quint64 threadAllocations()
+    {
+        return allocationCount;
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Counts heap allocations made by the calling thread.
+// AllocationCounter.cpp interposes the allocator (malloc on glibc, operator new elsewhere) for the benchmark binary.
+namespace AllocationCounter
+{
+    // Allocations made by the calling thread since it started
+    quint64 threadAllocations();
+
+    // Measures the allocations made by the calling thread while it is alive
+    class Scope
+    {
+    public:
+        Scope() : start(threadAllocations()) {}
+        quint64 allocations() const { return threadAllocations() - start; } // Allocations since construction
+
+    private:
+        quint64 start; // Counter value at construction
+    };
+}
+
+#endif
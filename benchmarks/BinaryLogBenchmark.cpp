@@ -0,0 +1,179 @@
+#include "BinaryLogBenchmark.h"
+#include "BinaryLogFormat.h"
+#include "Logger.h"
+#include <QtTest>
+
+namespace
+{
+    const qint64 MS = 1000000; // Nanoseconds per millisecond
+
+    // A record as the decoder turns it into a log line
+    struct DecodedLine
+    {
+        qint64 timestampMs; // Wall-clock time after applying the session anchor
+        QString level;      // Level name
+        QString message;    // Message text
+    };
+
+    // Append a record encoded the way Logger::logEvent encodes its arguments
+    template <typename... Args>
+    void appendEvent(QByteArray &log, qint64 timestampNs, Logger::LogLevel level, quint16 messageId, const Args &...args)
+    {
+        char payload[BinaryLog::MAX_PAYLOAD_BYTES];
+        BinaryLog::ArgWriter writer(payload, sizeof(payload));
+        int expand[] = {0, (writer.add(args), 0)...}; // Encode each argument in order
+        Q_UNUSED(expand);
+        BinaryLog::appendRecord(log, timestampNs, static_cast<quint8>(level), messageId,
+                                static_cast<quint8>(writer.argCount()), payload, static_cast<quint16>(writer.size()));
+    }
+
+    // Append the anchor record a logger session starts with
+    void appendSessionStart(QByteArray &log, qint64 wallClockMs, qint64 monotonicNs)
+    {
+        appendEvent(log, monotonicNs, Logger::Info, BinaryLog::SessionStart, wallClockMs, monotonicNs);
+    }
+
+    // Decode a binary log the way aks_log_decoder does; 'complete' is false if it ended in a truncated record
+    QVector<DecodedLine> decode(const QByteArray &log, bool *complete)
+    {
+        QVector<DecodedLine> lines;
+        quint32 version = 0;
+        if (!BinaryLog::readFileHeader(log.constData(), log.size(), &version) || version != BinaryLog::FORMAT_VERSION)
+        {
+            *complete = false;
+            return lines;
+        }
+        const char *cursor = log.constData() + BinaryLog::FILE_HEADER_SIZE;
+        const char *end = log.constData() + log.size();
+        qint64 wallClockAnchorMs = 0;
+        qint64 monotonicAnchorNs = 0;
+        BinaryLog::Record record;
+        *complete = true;
+        while (cursor < end)
+        {
+            if (!BinaryLog::readRecord(cursor, end, record))
+            {
+                *complete = false;
+                break;
+            }
+            if (record.messageId == BinaryLog::SessionStart)
+            {
+                BinaryLog::readSessionAnchor(record.payload, record.payloadSize, &wallClockAnchorMs, &monotonicAnchorNs);
+                continue;
+            }
+            lines.append({wallClockAnchorMs + (record.timestampNs - monotonicAnchorNs) / MS, BinaryLog::levelName(record.level),
+                          BinaryLog::formatMessage(record.messageId, record.payload, record.payloadSize, record.argCount)});
+        }
+        return lines;
+    }
+
+    // A binary log holding only the file header
+    QByteArray emptyLog()
+    {
+        QByteArray log;
+        BinaryLog::appendFileHeader(log);
+        return log;
+    }
+}
+
+// Every message id decodes to its template filled in by QString::arg, for every ArgWriter overload
+void BinaryLogBenchmark::catalogedMessages()
+{
+    const QString freeText = "Startup took 12% longer, %2 stays"; // A placeholder inside an argument is not expanded
+    const char missileType[] = "Hisar";
+    const quint32 state = 2;
+
+    QByteArray log = emptyLog();
+    appendSessionStart(log, 0, 0);
+    appendEvent(log, 0, Logger::Info, BinaryLog::FreeText, freeText);
+    appendEvent(log, 0, Logger::Debug, BinaryLog::PlatformInfoReceived, 39.9208, -32.8541, 850.5);
+    appendEvent(log, 0, Logger::Info, BinaryLog::MissileStatusUpdated, 3, state);
+    appendEvent(log, 0, Logger::Info, BinaryLog::MissileStatusChanged, 3, missileType, true, false, true);
+    appendEvent(log, 0, Logger::Warning, BinaryLog::CommunicationStatusChanged, "Connected", QString("Disconnected"));
+    appendEvent(log, 0, Logger::Warning, BinaryLog::LinkStatisticsReport, "ANS", qint64(850), qint64(900), qint64(4200),
+                qint64(35), qint64(6000), qint64(12), qint64(3), qint64(0));
+    appendEvent(log, 0, Logger::Error, quint16(BinaryLog::LinkStatisticsReport + 1), 1); // Written by a newer version
+
+    bool complete = false;
+    const QVector<DecodedLine> lines = decode(log, &complete);
+    QVERIFY(complete);
+    QCOMPARE(lines.size(), 7);
+
+    // What a text log holds for the same call: the template filled in with QString::arg
+    const QString expected[] = {
+        freeText,
+        QString(BinaryLog::messageTemplate(BinaryLog::PlatformInfoReceived)).arg(39.9208).arg(-32.8541).arg(850.5),
+        QString(BinaryLog::messageTemplate(BinaryLog::MissileStatusUpdated)).arg(3).arg(state),
+        QString(BinaryLog::messageTemplate(BinaryLog::MissileStatusChanged)).arg(3).arg(missileType).arg(true).arg(false).arg(true),
+        QString(BinaryLog::messageTemplate(BinaryLog::CommunicationStatusChanged)).arg("Connected", "Disconnected"),
+        QString(BinaryLog::messageTemplate(BinaryLog::LinkStatisticsReport))
+            .arg("ANS").arg(850).arg(900).arg(4200).arg(35).arg(6000).arg(12).arg(3).arg(0),
+        QString("Unknown message %1").arg(BinaryLog::LinkStatisticsReport + 1)};
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        QCOMPARE(lines[i].message, expected[i]);
+    }
+    QCOMPARE(lines[1].message, QString("Platform info received: Lat 39.9208, Lon -32.8541, Alt 850.5"));
+    QCOMPARE(lines[3].message, QString("Missile status changed - Index: 3, Type: Hisar, Healthy: 1, Powered: 0, Fired: 1"));
+    QCOMPARE(lines[1].level, QString("DEBUG"));
+    QCOMPARE(lines[4].level, QString("WARNING"));
+    QCOMPARE(lines[6].level, QString("ERROR"));
+
+    // Arguments that do not fit the inline payload are left out; their placeholders stay
+    QByteArray clipped = emptyLog();
+    appendEvent(clipped, 0, Logger::Info, BinaryLog::MissileStatusUpdated, QString(BinaryLog::MAX_PAYLOAD_BYTES, 'x'), 2);
+    const QVector<DecodedLine> clippedLines = decode(clipped, &complete);
+    QCOMPARE(clippedLines.size(), 1);
+    QCOMPARE(clippedLines[0].message, QString(BinaryLog::messageTemplate(BinaryLog::MissileStatusUpdated))
+                                          .arg(QString(BinaryLog::MAX_PAYLOAD_BYTES - 3, 'x'))); // Tag and length take 3 bytes
+}
+
+// Each SessionStart re-anchors the timestamps after it; a truncated tail ends decoding cleanly
+void BinaryLogBenchmark::sessions()
+{
+    const qint64 firstWallClockMs = 1700000000000;
+    const qint64 secondWallClockMs = firstWallClockMs + 3600 * 1000; // Restarted an hour later
+    QByteArray log = emptyLog();
+    appendSessionStart(log, firstWallClockMs, 500000 * MS);
+    appendEvent(log, 500000 * MS + 1500 * MS, Logger::Info, BinaryLog::MissileStatusUpdated, 1, 1);
+    appendSessionStart(log, secondWallClockMs, 20 * MS); // The monotonic clock starts over with the host
+    appendEvent(log, 20 * MS + 250 * MS, Logger::Info, BinaryLog::MissileStatusUpdated, 2, 1);
+    const int completeSize = log.size();
+    appendEvent(log, 20 * MS + 300 * MS, Logger::Critical, BinaryLog::FreeText, QString("Lost in the crash"));
+
+    bool complete = false;
+    QVector<DecodedLine> lines = decode(log, &complete);
+    QVERIFY(complete);
+    QCOMPARE(lines.size(), 3);
+    QCOMPARE(lines[0].timestampMs, firstWallClockMs + 1500);
+    QCOMPARE(lines[1].timestampMs, secondWallClockMs + 250);
+    QCOMPARE(lines[2].timestampMs, secondWallClockMs + 300);
+
+    // Cut inside the last record's payload, then inside its header
+    const int cuts[] = {log.size() - 1, completeSize + BinaryLog::RECORD_HEADER_SIZE - 1};
+    for (int cut : cuts)
+    {
+        lines = decode(log.left(cut), &complete);
+        QVERIFY(!complete);
+        QCOMPARE(lines.size(), 2);
+        QCOMPARE(lines[1].message, QString("Missile 2 status updated: State 1"));
+    }
+}
+
+// Cost of turning one link statistics record back into text
+void BinaryLogBenchmark::decodeRecord()
+{
+    QByteArray log = emptyLog();
+    appendEvent(log, 0, Logger::Info, BinaryLog::LinkStatisticsReport, "Launcher", qint64(850), qint64(900), qint64(4200),
+                qint64(35), qint64(6000), qint64(12), qint64(3), qint64(0));
+    BinaryLog::Record record;
+    const char *cursor = log.constData() + BinaryLog::FILE_HEADER_SIZE;
+    QVERIFY(BinaryLog::readRecord(cursor, log.constData() + log.size(), record));
+
+    QString message;
+    QBENCHMARK
+    {
+        message = BinaryLog::formatMessage(record.messageId, record.payload, record.payloadSize, record.argCount);
+    }
+    QVERIFY(message.startsWith("Link Launcher - RTT last/mean/max: 850/900/4200 us"));
+}
@@ -0,0 +1,17 @@
+#ifndef BINARYLOGBENCHMARK_H
+#define BINARYLOGBENCHMARK_H
+
+#include <QObject>
+
+// Binary log round trip: records encoded as LOG_EVENT encodes them decode to the text a text log holds
+class BinaryLogBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void catalogedMessages(); // Every message id decodes to its template filled in by QString::arg, for every ArgWriter overload
+    void sessions();          // Each SessionStart re-anchors the timestamps after it; a truncated tail ends decoding cleanly
+    void decodeRecord();      // Cost of turning one link statistics record back into text
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "CoreBenchmark.h"
+#include "AKSCore.h"
+#include "ConfigReader.h"
+#include "MonotonicClock.h"
+#include "PlatformInfoCoalescer.h"
+#include <QFile>
+#include <QLoggingCategory>
+#include <QtTest>
+
+namespace
+{
+    // Same layout as config/missiles.conf
+    const char MISSILE_CONFIG[] =
+        "# File: config/missiles.conf\n"
+        "\n"
+        "# Format: MissileIndex,MissileName,IsHealthy\n"
+        "# MissileIndex: 0-3\n"
+        "# MissileName: String of at most 31 bytes (e.g., \"Standard\", \"LongRange\", \"HighExplosive\")\n"
+        "# IsHealthy: true or false\n"
+        "\n"
+        "0,SOM A,true\n"
+        "1,J-600T,false\n"
+        "2,,\n"
+        "3,Bora,true\n";
+
+    const int FRAME_INTERVAL_MS = 16; // Coalescer pacing of a 60 Hz display
+}
+
+// Write the configuration file
+void CoreBenchmark::initTestCase()
+{
+    QVERIFY(directory.isValid());
+    configPath = directory.filePath("missiles.conf");
+    QFile file(configPath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(MISSILE_CONFIG);
+    file.close();
+}
+
+// AKSCore platform info through the coalescer to AKSGUI, wired as in AKSApp.
+// The virtual clock never advances, so after the first position every submit is superseded before its frame,
+// which is the coalescer's steady state when ANS reports faster than the display refreshes.
+void CoreBenchmark::platformInfoFanOut()
+{
+    ManualClock clock;
+    AKSCore core(nullptr, &clock);
+    core.start();
+    PlatformInfoCoalescer coalescer(&clock, FRAME_INTERVAL_MS);
+    FanOutReceiver gui;
+    core.eventBus()->subscribe<Events::PlatformInfo>(&coalescer, EventBus::Direct, [&coalescer](const Events::PlatformInfo &event)
+                                                     { coalescer.submit(event.latitude, event.longitude, event.altitude); });
+    connect(&coalescer, &PlatformInfoCoalescer::platformInfoReady, &gui, &FanOutReceiver::updatePlatformInfo);
+
+    int received = 0;
+    QBENCHMARK
+    {
+        core.onPlatformInfoReceived(39.925533, 32.866287, 1250.50);
+        ++received;
+    }
+    QCOMPARE(gui.calls, 1);
+    QCOMPARE(coalescer.submittedCount(), quint64(received));
+    core.stop();
+}
+
+// AKSCore missile status to AKSGUI and the audit log, wired as in AKSApp.
+// The status repeats, so the audit log takes its deduplication path after the first update.
+void CoreBenchmark::missileStatusFanOut()
+{
+    ManualClock clock;
+    AKSCore core(nullptr, &clock);
+    core.start();
+    FanOutReceiver gui;
+    core.eventBus()->subscribe<Events::MissileStatus>(&gui, EventBus::Direct, [&gui](const Events::MissileStatus &event)
+                                                      { gui.updateMissileStatus(event.index, event.typeName(), event.healthy, event.powered, event.fired); });
+
+    const QString type("J-600T");
+    int updates = 0;
+    QBENCHMARK
+    {
+        core.updateMissileConfig(1, type, true);
+        ++updates;
+    }
+    QCOMPARE(gui.calls, updates);
+    core.stop();
+}
+
+// A configuration update for the missile in its launch sequence is held back and applied once the launch ends
+void CoreBenchmark::updateDuringLaunch()
+{
+    ManualClock clock;
+    AKSCore core(nullptr, &clock);
+    core.start();
+    FanOutReceiver gui;
+    Events::MissileStatus last = {};
+    core.eventBus()->subscribe<Events::MissileStatus>(&gui, EventBus::Direct, [&last](const Events::MissileStatus &event)
+                                                      { last = event; });
+
+    core.updateMissileConfig(0, "SOM A", true);
+    core.onLauncherHeartbeatReceived();
+    core.toggleMissilePower(0);
+    core.launchMissile();
+    core.updateMissileConfig(0, "SOM B", true); // The file changed during the launch
+    QCOMPARE(last.typeName(), QString("SOM A"));
+    QVERIFY(last.powered);
+
+    clock.advanceMs(5 * 2000); // The five steps of the launch sequence
+    QCOMPARE(last.index, 0);
+    QVERIFY(last.fired);
+    QCOMPARE(last.typeName(), QString("SOM B"));
+    core.stop();
+}
+
+// ConfigReader::loadMissileConfig on the shipped four-missile layout
+void CoreBenchmark::loadMissileConfig()
+{
+    ConfigReader reader;
+    QLoggingCategory::setFilterRules("default.debug=false"); // loadMissileConfig reports every load with qDebug
+    bool ok = false;
+    QBENCHMARK
+    {
+        ok = reader.loadMissileConfig(configPath);
+    }
+    QLoggingCategory::setFilterRules(QString());
+    QVERIFY2(ok, qPrintable(reader.getLastError()));
+    QCOMPARE(reader.getMissileConfigs().size(), 4);
+}
+
+// ConfigReader::diffMissileConfigs for a reload that changes one missile
+void CoreBenchmark::diffMissileConfig()
+{
+    ConfigReader reader;
+    QLoggingCategory::setFilterRules("default.debug=false");
+    QVERIFY2(reader.loadMissileConfig(configPath), qPrintable(reader.getLastError()));
+    QLoggingCategory::setFilterRules(QString());
+    const QVector<MissileConfig> previous = reader.getMissileConfigs();
+    QVector<MissileConfig> next = previous;
+    next[1].healthy = true; // J-600T repaired
+
+    QVector<MissileConfig> changed;
+    QBENCHMARK
+    {
+        changed = ConfigReader::diffMissileConfigs(previous, next);
+    }
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed[0].index, 1);
+    QVERIFY(changed[0].healthy);
+
+    // A missile dropped from the file is reported as unconfigured
+    next.remove(3);
+    changed = ConfigReader::diffMissileConfigs(previous, next);
+    QCOMPARE(changed.size(), 2);
+    QCOMPARE(changed[1].index, 3);
+    QVERIFY(changed[1].type.isEmpty() && !changed[1].healthy);
+}
@@ -0,0 +1,40 @@
+#ifndef COREBENCHMARK_H
+#define COREBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Stands in for AKSGUI on the receiving end of AKSCore's events.
+// The benchmark binary has no QtWidgets, so the slots only count; what is measured is the fan-out itself.
+class FanOutReceiver : public QObject
+{
+    Q_OBJECT
+
+public:
+    int calls = 0; // Slot invocations so far
+
+public slots:
+    void updatePlatformInfo(double, double, double) { ++calls; }                  // AKSGUI::updatePlatformInfo
+    void updateMissileStatus(int, const QString &, bool, bool, bool) { ++calls; } // AKSGUI::updateMissileStatus
+};
+
+// AKSCore event fan-out, missile configuration loading and reloading
+class CoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase(); // Write the configuration file
+
+    void platformInfoFanOut();  // AKSCore platform info through the coalescer to AKSGUI, wired as in AKSApp
+    void missileStatusFanOut(); // AKSCore missile status to AKSGUI and the audit log
+    void updateDuringLaunch();  // A configuration update for the launching missile is applied once the launch ends
+    void loadMissileConfig();   // ConfigReader::loadMissileConfig on the shipped four-missile layout
+    void diffMissileConfig();   // ConfigReader::diffMissileConfigs for a reload that changes one missile
+
+private:
+    QTemporaryDir directory; // Holds the generated configuration file
+    QString configPath;      // Four-missile configuration
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "EventBusBenchmark.h"
+#include "AuditLog.h"
+#include "EventBus.h"
+#include <QCoreApplication>
+#include <QtTest>
+
+namespace
+{
+    const int BURST_EVENTS = 100; // Link status events published between two event loop passes
+
+    // Status of missile 1 as the shipped configuration reports it
+    Events::MissileStatus missileStatus(bool powered)
+    {
+        Events::MissileStatus event = {};
+        event.index = 1;
+        event.healthy = true;
+        event.powered = powered;
+        event.setType("J-600T");
+        return event;
+    }
+}
+
+// Platform info to two Direct subscribers, as the GUI coalescer and the headless service take it
+void EventBusBenchmark::directPublish()
+{
+    EventBus bus;
+    QObject gui;
+    QObject service;
+    int guiCalls = 0;
+    double lastLatitude = 0.0;
+    bus.subscribe<Events::PlatformInfo>(&gui, EventBus::Direct, [&](const Events::PlatformInfo &)
+                                        { ++guiCalls; });
+    bus.subscribe<Events::PlatformInfo>(&service, EventBus::Direct, [&](const Events::PlatformInfo &event)
+                                        { lastLatitude = event.latitude; });
+
+    const Events::PlatformInfo event = {39.925533, 32.866287, 1250.50};
+    QBENCHMARK
+    {
+        bus.publish(event);
+    }
+    QCOMPARE(quint64(guiCalls), bus.publishedCount());
+    QCOMPARE(lastLatitude, event.latitude);
+}
+
+// Missile status to a Queued subscriber; every event is delivered, in order, by the event loop
+void EventBusBenchmark::queuedPublish()
+{
+    EventBus bus;
+    QObject receiver;
+    int calls = 0;
+    bool lastPowered = false;
+    bus.subscribe<Events::MissileStatus>(&receiver, EventBus::Queued, [&](const Events::MissileStatus &event)
+                                         {
+                                             ++calls;
+                                             lastPowered = event.powered;
+                                         });
+
+    bool powered = false;
+    QBENCHMARK
+    {
+        powered = !powered;
+        bus.publish(missileStatus(powered));
+        QCoreApplication::sendPostedEvents(&receiver);
+    }
+    QCOMPARE(quint64(calls), bus.publishedCount());
+    QCOMPARE(lastPowered, powered);
+}
+
+// A burst of link status events to a Coalesced subscriber; only the newest one is delivered
+void EventBusBenchmark::coalescedBurst()
+{
+    EventBus bus;
+    QObject receiver;
+    int calls = 0;
+    Events::CommunicationStatus last = {};
+    bus.subscribe<Events::CommunicationStatus>(&receiver, EventBus::Coalesced, [&](const Events::CommunicationStatus &event)
+                                               {
+                                                   ++calls;
+                                                   last = event;
+                                               });
+
+    int bursts = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < BURST_EVENTS; ++i)
+        {
+            bus.publish(Events::CommunicationStatus{true, i % 2 == 0});
+        }
+        QCoreApplication::sendPostedEvents(&receiver);
+        ++bursts;
+    }
+    QCOMPARE(calls, bursts);
+    QCOMPARE(bus.coalescedCount(), quint64(bursts) * (BURST_EVENTS - 1));
+    QVERIFY(last.ansConnected && !last.launcherConnected); // The last event of the burst
+}
+
+// A repeated missile status reaching the audit log, e.g. from a configuration reload; only the first is logged
+void EventBusBenchmark::auditLogDeduplication()
+{
+    EventBus bus;
+    AuditLog auditLog(&bus);
+
+    bus.publish(missileStatus(false));
+    QCOMPARE(auditLog.loggedCount(), quint64(1));
+
+    const Events::MissileStatus repeated = missileStatus(false);
+    QBENCHMARK
+    {
+        bus.publish(repeated);
+    }
+    QCOMPARE(auditLog.loggedCount(), quint64(1));
+    QCOMPARE(auditLog.suppressedCount(), bus.publishedCount() - 1);
+
+    bus.publish(missileStatus(true)); // Powered: a change
+    bus.publish(Events::CommunicationStatus{true, false});
+    bus.publish(Events::CommunicationStatus{true, false});
+    QCOMPARE(auditLog.loggedCount(), quint64(3));
+}
+
+// A destroyed receiver gets nothing, not even deliveries already posted
+void EventBusBenchmark::unsubscribeOnDestroy()
+{
+    EventBus bus;
+    int calls = 0;
+    QObject *receiver = new QObject();
+    QObject keeper;
+    bus.subscribe<Events::PlatformInfo>(receiver, EventBus::Queued, [&](const Events::PlatformInfo &)
+                                        { ++calls; });
+    bus.subscribe<Events::PlatformInfo>(&keeper, EventBus::Direct, [&](const Events::PlatformInfo &)
+                                        { ++calls; });
+    QCOMPARE(bus.subscriberCount(Events::PlatformInfoChannel), 2);
+
+    bus.publish(Events::PlatformInfo{39.9, 32.8, 1250.0}); // One Direct call now, one delivery posted
+    delete receiver;
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(calls, 1);
+    QCOMPARE(bus.subscriberCount(Events::PlatformInfoChannel), 1);
+
+    bus.publish(Events::PlatformInfo{39.9, 32.8, 1250.0});
+    QCOMPARE(calls, 2);
+}
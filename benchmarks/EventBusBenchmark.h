@@ -0,0 +1,19 @@
+#ifndef EVENTBUSBENCHMARK_H
+#define EVENTBUSBENCHMARK_H
+
+#include <QObject>
+
+// Cost of publishing AKSCore events through the EventBus for each delivery policy, and of the audit log
+class EventBusBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void directPublish();         // Platform info to two Direct subscribers
+    void queuedPublish();         // Missile status to a Queued subscriber, delivered by the event loop
+    void coalescedBurst();        // A burst of link status events to a Coalesced subscriber, one delivery per pass
+    void auditLogDeduplication(); // A repeated missile status reaching the audit log
+    void unsubscribeOnDestroy();  // A destroyed receiver gets nothing, not even deliveries already posted
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include "LinkStatisticsBenchmark.h"
+#include "CommunicationManager.h"
+#include "LinkStatistics.h"
+#include "MonotonicClock.h"
+#include <QtTest>
+
+namespace
+{
+    const qint64 MS = 1000000;          // Nanoseconds per millisecond
+    const qint64 US = 1000;             // Nanoseconds per microsecond
+    const qint64 INTERVAL_NS = 50 * MS; // Peer heartbeat interval used throughout
+
+    // Extended text ANS heartbeat, optionally echoing an AKS heartbeat
+    QByteArray ansHeartbeat(quint32 sequence, qint64 timestampNs)
+    {
+        return QByteArray("ANS_HEARTBEAT,") + QByteArray::number(sequence) + "," + QByteArray::number(timestampNs);
+    }
+    QByteArray ansHeartbeat(quint32 sequence, qint64 timestampNs, quint32 echoSequence, qint64 echoTimestampNs, qint64 echoDelayNs)
+    {
+        return ansHeartbeat(sequence, timestampNs) + "," + QByteArray::number(echoSequence) + "," +
+               QByteArray::number(echoTimestampNs) + "," + QByteArray::number(echoDelayNs);
+    }
+
+    // Heartbeat 'sequence' sent at 'sentNs' arrives one millisecond later, or now if that has already passed
+    void receive(LinkStatistics &link, ManualClock &clock, quint32 sequence, qint64 sentNs)
+    {
+        const qint64 arrivalNs = sentNs + MS;
+        if (arrivalNs > clock.nowNs())
+        {
+            clock.advance(arrivalNs - clock.nowNs());
+        }
+        link.recordHeartbeat(sequence, sentNs, clock.nowNs());
+    }
+}
+
+// Echoed AKS heartbeats give round trips, counted once per echoed sequence
+void LinkStatisticsBenchmark::rttFromEcho()
+{
+    ManualClock clock;
+    CommunicationManager manager(nullptr, &clock);
+
+    // The first AKS heartbeat went out at clock time 0; ANS held it for 1 ms and answers 5 ms later
+    clock.advanceMs(5);
+    QByteArray datagram = ansHeartbeat(1, clock.nowNs(), 0, 0, 1 * MS);
+    manager.handleDatagram(datagram.constData(), datagram.size(), NetworkConfig::DEFAULT_ANS_PORT);
+    LinkStatistics::Snapshot stats = manager.ansLinkStatistics();
+    QCOMPARE(stats.rttSamples, quint64(1));
+    QCOMPARE(stats.rttLastNs, 4 * MS);
+
+    // ANS repeats the echo until the next AKS heartbeat arrives
+    clock.advance(INTERVAL_NS);
+    datagram = ansHeartbeat(2, clock.nowNs(), 0, 0, 1 * MS);
+    manager.handleDatagram(datagram.constData(), datagram.size(), NetworkConfig::DEFAULT_ANS_PORT);
+    QCOMPARE(manager.ansLinkStatistics().rttSamples, quint64(1));
+
+    // The next AKS heartbeat, sent now and echoed 2 ms later without hold time
+    const qint64 sentNs = clock.nowNs();
+    clock.advanceMs(2);
+    datagram = ansHeartbeat(3, clock.nowNs(), 1, sentNs, 0);
+    manager.handleDatagram(datagram.constData(), datagram.size(), NetworkConfig::DEFAULT_ANS_PORT);
+    stats = manager.ansLinkStatistics();
+    QCOMPARE(stats.rttSamples, quint64(2));
+    QCOMPARE(stats.rttLastNs, 2 * MS);
+    QCOMPARE(stats.rttMinNs, 2 * MS);
+    QCOMPARE(stats.rttMaxNs, 4 * MS);
+    QCOMPARE(stats.rttMeanNs, 3 * MS);
+    QCOMPARE(stats.received, quint64(3));
+
+    // An echo from before a restart of the AKS would give a negative round trip
+    LinkStatistics link;
+    link.recordEcho(7, clock.nowNs() + MS, 0, clock.nowNs());
+    QCOMPARE(link.snapshot().rttSamples, quint64(0));
+}
+
+// Late heartbeats undo a loss, repeated ones count as duplicates
+void LinkStatisticsBenchmark::reorderAndDuplicates()
+{
+    ManualClock clock;
+    LinkStatistics link;
+    for (quint32 sequence : {1, 2, 4, 5})
+    {
+        receive(link, clock, sequence, sequence * INTERVAL_NS);
+    }
+    LinkStatistics::Snapshot stats = link.snapshot();
+    QCOMPARE(stats.received, quint64(4));
+    QCOMPARE(stats.lost, quint64(1)); // 3 is missing so far
+    QCOMPARE(stats.lossRatio, 0.2);
+
+    receive(link, clock, 3, 3 * INTERVAL_NS); // Late, not lost after all
+    stats = link.snapshot();
+    QCOMPARE(stats.received, quint64(5));
+    QCOMPARE(stats.lost, quint64(0));
+    QCOMPARE(stats.reordered, quint64(1));
+
+    receive(link, clock, 5, 5 * INTERVAL_NS); // The newest and an older one again
+    receive(link, clock, 3, 3 * INTERVAL_NS);
+    stats = link.snapshot();
+    QCOMPARE(stats.received, quint64(5));
+    QCOMPARE(stats.duplicates, quint64(2));
+    QCOMPARE(stats.reordered, quint64(1));
+}
+
+// A peer restarting its sequence is not counted as loss or reordering
+void LinkStatisticsBenchmark::sequenceRestart()
+{
+    ManualClock clock;
+    LinkStatistics link;
+    for (quint32 sequence : {100, 101, 102})
+    {
+        receive(link, clock, sequence, sequence * INTERVAL_NS);
+    }
+
+    // Back to 1 with newer send times: the peer restarted
+    const qint64 restartNs = clock.nowNs();
+    for (quint32 sequence : {1, 2, 3})
+    {
+        receive(link, clock, sequence, restartNs + sequence * INTERVAL_NS);
+    }
+    LinkStatistics::Snapshot stats = link.snapshot();
+    QCOMPARE(stats.received, quint64(6));
+    QCOMPARE(stats.lost, quint64(0));
+    QCOMPARE(stats.reordered, quint64(0));
+    QCOMPARE(stats.duplicates, quint64(0));
+
+    // A jump far back restarts the sequence whatever the send time says
+    receive(link, clock, 5000, restartNs + 4 * INTERVAL_NS);
+    QCOMPARE(link.snapshot().lost, quint64(4996));
+    receive(link, clock, 7, 0);
+    stats = link.snapshot();
+    QCOMPARE(stats.lost, quint64(4996)); // Not 4993 late heartbeats
+    QCOMPARE(stats.reordered, quint64(0));
+
+    // An older sequence with an older send time is a late heartbeat, not a restart
+    receive(link, clock, 9, restartNs + 6 * INTERVAL_NS);
+    QCOMPARE(link.snapshot().lost, quint64(4997));
+    receive(link, clock, 8, restartNs + 5 * INTERVAL_NS);
+    stats = link.snapshot();
+    QCOMPARE(stats.reordered, quint64(1));
+    QCOMPARE(stats.lost, quint64(4996));
+}
+
+// Round trips land in the bucket whose upper bound they stay below
+void LinkStatisticsBenchmark::histogramBuckets()
+{
+    ManualClock clock;
+    LinkStatistics link;
+    const qint64 rttsNs[] = {50 * US, 99 * US, 100 * US, 999 * US, 1 * MS, 2000 * MS};
+    quint32 sequence = 0;
+    for (qint64 rttNs : rttsNs)
+    {
+        const qint64 sentNs = clock.nowNs();
+        clock.advance(rttNs);
+        link.recordEcho(sequence++, sentNs, 0, clock.nowNs());
+    }
+
+    const LinkStatistics::Snapshot stats = link.snapshot();
+    QCOMPARE(stats.rttSamples, quint64(6));
+    QCOMPARE(stats.rttHistogram[0], quint64(2)); // Below 100 us
+    QCOMPARE(stats.rttHistogram[1], quint64(1)); // 100 us, the first bound, belongs to the next bucket
+    QCOMPARE(stats.rttHistogram[3], quint64(1)); // 999 us
+    QCOMPARE(stats.rttHistogram[4], quint64(1)); // 1 ms
+    QCOMPARE(stats.rttHistogram[LinkStatistics::RTT_BUCKET_COUNT - 1], quint64(1)); // Beyond the last bound
+
+    QCOMPARE(LinkStatistics::rttBucketUpperBoundUs(0), qint64(100));
+    QCOMPARE(LinkStatistics::rttBucketUpperBoundUs(LinkStatistics::RTT_BUCKET_COUNT - 2), qint64(1000000));
+    QCOMPARE(LinkStatistics::rttBucketUpperBoundUs(LinkStatistics::RTT_BUCKET_COUNT - 1), qint64(-1)); // Open-ended
+}
+
+// Cost of accounting for one in-order heartbeat
+void LinkStatisticsBenchmark::recordHeartbeat()
+{
+    LinkStatistics link;
+    quint32 sequence = 0;
+    qint64 nowNs = 0;
+    QBENCHMARK
+    {
+        nowNs += INTERVAL_NS;
+        link.recordHeartbeat(++sequence, nowNs - MS, nowNs);
+    }
+    QCOMPARE(link.snapshot().lost, quint64(0));
+}
@@ -0,0 +1,19 @@
+#ifndef LINKSTATISTICSBENCHMARK_H
+#define LINKSTATISTICSBENCHMARK_H
+
+#include <QObject>
+
+// Heartbeat link statistics on a ManualClock: round trips, sequence tracking and the round-trip histogram
+class LinkStatisticsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rttFromEcho();          // Echoed AKS heartbeats give round trips, counted once per echoed sequence
+    void reorderAndDuplicates(); // Late heartbeats undo a loss, repeated ones count as duplicates
+    void sequenceRestart();      // A peer restarting its sequence is not counted as loss or reordering
+    void histogramBuckets();     // Round trips land in the bucket whose upper bound they stay below
+    void recordHeartbeat();      // Cost of accounting for one in-order heartbeat
+};
+
+#endif
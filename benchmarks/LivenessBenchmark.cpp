@@ -0,0 +1,66 @@
+#include "LivenessBenchmark.h"
+#include "CommunicationManager.h"
+#include "GlobalConstants.h"
+#include "MonotonicClock.h"
+#include "Protocol.h"
+#include <QtTest>
+
+namespace
+{
+    const qint64 ANS_HEARTBEAT_SIZE = sizeof(Protocol::ANS_HEARTBEAT_TEXT) - 1;
+    const int SILENCE_MS = 30000; // Further silence after the loss
+}
+
+// Loss is reported exactly one timeout after the last heartbeat
+void LivenessBenchmark::detectLossInVirtualTime()
+{
+    ManualClock clock;
+    CommunicationManager manager(nullptr, &clock);
+    manager.start();
+    if (clock.activeTimerCount() == 0)
+    {
+        QSKIP("AKS port is in use, the communication timers did not start");
+    }
+    QSignalSpy lost(&manager, &CommunicationManager::ansCommunicationLost);
+
+    // One heartbeat per second keeps the link up
+    for (int second = 0; second < 20; ++second)
+    {
+        manager.handleDatagram(Protocol::ANS_HEARTBEAT_TEXT, ANS_HEARTBEAT_SIZE, NetworkConfig::DEFAULT_ANS_PORT);
+        clock.advanceMs(1000);
+    }
+    QCOMPARE(lost.count(), 0);
+    QVERIFY(manager.hasRecentANSHeartbeat());
+
+    // Then ANS goes silent: the loss is reported exactly one timeout after the last heartbeat
+    QElapsedTimer wallClock;
+    wallClock.start();
+    clock.advanceMs(GlobalConstants::HEARTBEAT_TIMEOUT_MS - 1000 - 1); // The last heartbeat was 1 s ago
+    QCOMPARE(lost.count(), 0);
+    QVERIFY(manager.hasRecentANSHeartbeat());
+    clock.advanceMs(1);
+    QCOMPARE(lost.count(), 1);
+    QVERIFY(!manager.hasRecentANSHeartbeat());
+    clock.advanceMs(SILENCE_MS);
+    qInfo("%d ms of silence simulated in %lld us", GlobalConstants::HEARTBEAT_TIMEOUT_MS + SILENCE_MS,
+          wallClock.nsecsElapsed() / 1000);
+    QCOMPARE(lost.count(), 1); // Reported once, not on every check
+    manager.stop();
+}
+
+// Cost of running one minute of CommunicationManager timers
+void LivenessBenchmark::virtualMinute()
+{
+    ManualClock clock;
+    CommunicationManager manager(nullptr, &clock);
+    manager.start();
+    if (clock.activeTimerCount() == 0)
+    {
+        QSKIP("AKS port is in use, the communication timers did not start");
+    }
+    QBENCHMARK
+    {
+        clock.advanceMs(60000);
+    }
+    manager.stop();
+}
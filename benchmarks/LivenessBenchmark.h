@@ -0,0 +1,16 @@
+#ifndef LIVENESSBENCHMARK_H
+#define LIVENESSBENCHMARK_H
+
+#include <QObject>
+
+// Heartbeat liveness driven in virtual time by a ManualClock
+class LivenessBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void detectLossInVirtualTime(); // Loss is reported exactly one timeout after the last heartbeat
+    void virtualMinute();           // Cost of running one minute of CommunicationManager timers
+};
+
+#endif
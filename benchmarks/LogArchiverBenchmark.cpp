@@ -0,0 +1,200 @@
+#include "LogArchiverBenchmark.h"
+#include "LogArchiver.h"
+#include "MonotonicClock.h"
+#include <QtTest>
+
+namespace
+{
+    const qint64 MB = 1024 * 1024;             // Bytes per megabyte
+    const qint64 MINUTE_NS = 60LL * 1000000000; // Nanoseconds per minute
+
+    // Text resembling a log segment of about 'bytes' bytes
+    QByteArray segmentText(qint64 bytes)
+    {
+        QByteArray text;
+        text.reserve(int(bytes) + 128);
+        for (int line = 0; text.size() < bytes; ++line)
+        {
+            text += "2024-01-31 23:59:59.";
+            text += QByteArray::number(line % 1000).rightJustified(3, '0');
+            text += " [INFO] Missile " + QByteArray::number(line % 8) + " status updated: State " + QByteArray::number(line % 3) + "\n";
+        }
+        return text;
+    }
+
+    // Write 'data' to 'path'
+    bool writeFile(const QString &path, const QByteArray &data)
+    {
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(data) == data.size();
+    }
+
+    // Read the whole file at 'path'
+    QByteArray readFile(const QString &path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    // Bitwise CRC-32 (IEEE 802.3), independent of the archiver's table-driven one
+    quint32 referenceCrc32(const QByteArray &data)
+    {
+        quint32 crc = 0xFFFFFFFFu;
+        for (char byte : data)
+        {
+            crc ^= uchar(byte);
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            }
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // Adler-32, needed to hand the deflate stream back to qUncompress as a zlib stream
+    quint32 adler32(const QByteArray &data)
+    {
+        quint32 a = 1;
+        quint32 b = 0;
+        for (char byte : data)
+        {
+            a = (a + uchar(byte)) % 65521;
+            b = (b + a) % 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    // True when 'gzip' is a single gzip member whose deflate stream, CRC-32 and size all match 'data'
+    bool gunzipsTo(const QByteArray &gzip, const QByteArray &data)
+    {
+        if (gzip.size() < 18 || uchar(gzip[0]) != 0x1f || uchar(gzip[1]) != 0x8b || gzip[2] != 8 || gzip[3] != 0)
+        {
+            return false; // Not gzip, or header flags this reader does not handle
+        }
+        const uchar *trailer = reinterpret_cast<const uchar *>(gzip.constData() + gzip.size() - 8);
+        if (qFromLittleEndian<quint32>(trailer) != referenceCrc32(data) || qFromLittleEndian<quint32>(trailer + 4) != quint32(data.size()))
+        {
+            return false;
+        }
+
+        // Rewrap the deflate stream for qUncompress: big-endian length, zlib header, stream, Adler-32 of the data
+        uchar number[4];
+        qToBigEndian(quint32(data.size()), number);
+        QByteArray zlib(reinterpret_cast<const char *>(number), 4);
+        zlib += "\x78\x9c";
+        zlib += gzip.mid(10, gzip.size() - 18);
+        qToBigEndian(adler32(data), number);
+        zlib.append(reinterpret_cast<const char *>(number), 4);
+        return qUncompress(zlib) == data;
+    }
+}
+
+// A segment is rotated before a batch would push it past the size limit
+void LogArchiverBenchmark::rotationBySize()
+{
+    const qint64 limit = 16 * MB;
+    QVERIFY(!LogArchiver::needsRotation(0, 64 * MB, 0, limit, 0));     // Never an empty segment, however large the batch
+    QVERIFY(!LogArchiver::needsRotation(limit - 100, 100, 0, limit, 0)); // Exactly full
+    QVERIFY(LogArchiver::needsRotation(limit - 100, 101, 0, limit, 0));
+    QVERIFY(LogArchiver::needsRotation(limit, 0, 0, limit, 0)); // Already over after a batch larger than the limit
+    QVERIFY(!LogArchiver::needsRotation(64 * MB, 1, 0, 0, 0));  // No size limit
+}
+
+// A segment is rotated once it is as old as the age limit, on a ManualClock
+void LogArchiverBenchmark::rotationByAge()
+{
+    const qint64 limitNs = 24 * 60 * MINUTE_NS;
+    ManualClock clock;
+    const qint64 openedNs = clock.nowNs();
+    clock.advance(limitNs - 1);
+    QVERIFY(!LogArchiver::needsRotation(100, 0, clock.nowNs() - openedNs, 0, limitNs));
+    clock.advance(1);
+    QVERIFY(LogArchiver::needsRotation(100, 0, clock.nowNs() - openedNs, 0, limitNs));
+    QVERIFY(!LogArchiver::needsRotation(0, 0, clock.nowNs() - openedNs, 0, limitNs)); // Nothing to rotate yet
+    QVERIFY(!LogArchiver::needsRotation(100, 0, clock.nowNs() - openedNs, 16 * MB, 0)); // No age limit
+}
+
+// Rotated segments are compressed and only the newest are kept
+void LogArchiverBenchmark::retention()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString activePath = directory.filePath("aks_log.txt");
+    QVERIFY(writeFile(activePath, "live segment\n"));
+    QVERIFY(writeFile(directory.filePath("other.txt"), "not a segment\n"));
+
+    // Five segments rotated within one second, all queued before the archiver gets to the first
+    const int retained = 3;
+    QStringList rotated;
+    for (int segment = 0; segment < 5; ++segment)
+    {
+        const QString segmentPath = LogArchiver::rotatedSegmentName(activePath);
+        QVERIFY(!rotated.contains(segmentPath)); // The counter keeps the names distinct
+        QVERIFY(writeFile(segmentPath, segmentText(4096) + QByteArray::number(segment)));
+        rotated.append(segmentPath);
+    }
+    LogArchiver archiver;
+    archiver.start(activePath, retained);
+    for (const QString &segmentPath : rotated)
+    {
+        archiver.archive(segmentPath);
+    }
+    archiver.stop(); // Finishes the queued compressions; segments deleted by retention meanwhile are skipped
+
+    // Name order is rotation order, so the newest three remain, compressed
+    const QStringList segments = QDir(directory.path()).entryList(QStringList() << "aks_log.*.txt*", QDir::Files, QDir::Name);
+    QStringList expected;
+    for (int segment = rotated.size() - retained; segment < rotated.size(); ++segment)
+    {
+        expected.append(QFileInfo(rotated[segment]).fileName() + ".gz");
+    }
+    QCOMPARE(segments, expected);
+    QVERIFY(QFileInfo(rotated.first()).fileName().contains(QRegularExpression("^aks_log\\.\\d{8}-\\d{6}Z-000\\.txt$")));
+
+    QVERIFY(gunzipsTo(readFile(rotated.last() + ".gz"), segmentText(4096) + "4"));
+    QCOMPARE(readFile(activePath), QByteArray("live segment\n")); // The live log and other files are never touched
+    QVERIFY(QFile::exists(directory.filePath("other.txt")));
+
+    // Not running: the segment stays as it is
+    const QString lateSegment = LogArchiver::rotatedSegmentName(activePath);
+    QVERIFY(writeFile(lateSegment, "late\n"));
+    archiver.archive(lateSegment);
+    QVERIFY(QFile::exists(lateSegment));
+}
+
+// The archive is a valid gzip member holding the segment; failures leave nothing behind
+void LogArchiverBenchmark::gzipOutput()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QByteArray segments[] = {segmentText(256 * 1024), QByteArray()}; // One chunk, and an empty segment
+    for (const QByteArray &segment : segments)
+    {
+        const QString sourcePath = directory.filePath("segment.txt");
+        QVERIFY(writeFile(sourcePath, segment));
+        QVERIFY(LogArchiver::gzipFile(sourcePath, sourcePath + ".gz"));
+
+        const QByteArray gzip = readFile(sourcePath + ".gz");
+        QVERIFY(gunzipsTo(gzip, segment));
+        QVERIFY(segment.isEmpty() || gzip.size() < segment.size() / 4); // Log text compresses well
+        QVERIFY(QFile::exists(sourcePath));                             // Removing the source is the caller's decision
+    }
+
+    const QString missing = directory.filePath("missing.txt");
+    QVERIFY(!LogArchiver::gzipFile(missing, missing + ".gz"));
+    QVERIFY(!QFile::exists(missing + ".gz"));
+    QVERIFY(!LogArchiver::gzipFile(directory.filePath("segment.txt"), directory.filePath("no/such/dir/segment.txt.gz")));
+}
+
+// Cost of compressing a 1 MB segment
+void LogArchiverBenchmark::compressSegment()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString sourcePath = directory.filePath("segment.txt");
+    QVERIFY(writeFile(sourcePath, segmentText(MB)));
+    QBENCHMARK
+    {
+        QVERIFY(LogArchiver::gzipFile(sourcePath, sourcePath + ".gz"));
+    }
+}
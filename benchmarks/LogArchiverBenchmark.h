@@ -0,0 +1,19 @@
+#ifndef LOGARCHIVERBENCHMARK_H
+#define LOGARCHIVERBENCHMARK_H
+
+#include <QObject>
+
+// Log segment rotation, retention and gzip compression in a temporary directory
+class LogArchiverBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rotationBySize();  // A segment is rotated before a batch would push it past the size limit
+    void rotationByAge();   // A segment is rotated once it is as old as the age limit, on a ManualClock
+    void retention();       // Rotated segments are compressed and only the newest are kept
+    void gzipOutput();      // The archive is a valid gzip member holding the segment; failures leave nothing behind
+    void compressSegment(); // Cost of compressing a 1 MB segment
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef LOGLEVELGUARD_H
+#define LOGLEVELGUARD_H
+
+#include "Logger.h"
+
+// Sets the logger's minimum level and console echo while it is alive and restores the previous settings afterwards.
+// main() holds one at Warning for the whole run, so log calls on the measured paths stay out of every class's numbers
+// (LoggerBenchmark measures them); a class that needs other settings holds its own for as long as it needs them.
+class LogLevelGuard
+{
+public:
+    explicit LogLevelGuard(Logger::LogLevel level, bool consoleEcho = false)
+        : savedLevel(Logger::instance().getMinimumLevel()), savedConsoleEcho(Logger::instance().isConsoleEchoEnabled())
+    {
+        Logger::instance().setMinimumLevel(level);
+        Logger::instance().setConsoleEcho(consoleEcho);
+    }
+
+    ~LogLevelGuard()
+    {
+        Logger::instance().setMinimumLevel(savedLevel);
+        Logger::instance().setConsoleEcho(savedConsoleEcho);
+    }
+
+    LogLevelGuard(const LogLevelGuard &) = delete;
+    LogLevelGuard &operator=(const LogLevelGuard &) = delete;
+
+private:
+    Logger::LogLevel savedLevel; // Minimum level before the guard
+    bool savedConsoleEcho;       // Console echo setting before the guard
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "LoggerBenchmark.h"
+#include "Logger.h"
+#include "MonotonicTime.h"
+#include <QtTest>
+#include <algorithm>
+
+namespace
+{
+    const int BATCH_SIZE = 1000;     // Entries per benchmark iteration, well below LOG_QUEUE_CAPACITY
+    const int LATENCY_BATCHES = 100; // Batches timed call by call for the latency percentiles
+}
+
+// Record Info entries without console echo, so only the log file is written
+void LoggerBenchmark::initTestCase()
+{
+    loggerSettings.emplace(Logger::Info);
+}
+
+// Restore the logger settings
+void LoggerBenchmark::cleanupTestCase()
+{
+    Logger::instance().flush();
+    loggerSettings.reset();
+}
+
+// LOG_INFO free-text entries, queued and written; one iteration is BATCH_SIZE entries
+void LoggerBenchmark::logTextThroughput()
+{
+    QBENCHMARK
+    {
+        for (int i = 0; i < BATCH_SIZE; ++i)
+        {
+            LOG_INFO(QString("Benchmark entry %1").arg(i));
+        }
+        Logger::instance().flush(); // Include formatting and writing, not just queueing
+    }
+}
+
+// LOG_EVENT catalogued entries, queued and written; one iteration is BATCH_SIZE entries
+void LoggerBenchmark::logEventThroughput()
+{
+    QBENCHMARK
+    {
+        for (int i = 0; i < BATCH_SIZE; ++i)
+        {
+            LOG_EVENT(Logger::Info, BinaryLog::MissileStatusUpdated, i, 1);
+        }
+        Logger::instance().flush();
+    }
+}
+
+// Cost of a LOG_DEBUG/LOG_INFO call below the runtime level; one iteration is BATCH_SIZE calls
+void LoggerBenchmark::logDisabledLevel()
+{
+    const LogLevelGuard disabled(Logger::Warning);
+    QBENCHMARK
+    {
+        for (int i = 0; i < BATCH_SIZE; ++i)
+        {
+            LOG_INFO(QString("Benchmark entry %1").arg(i)); // The message is never built
+        }
+    }
+}
+
+// Percentiles reported by logLatency
+void LoggerBenchmark::logLatency_data()
+{
+    QTest::addColumn<double>("percentile");
+    QTest::newRow("p50") << 50.0;
+    QTest::newRow("p99") << 99.0;
+    QTest::newRow("p99.9") << 99.9;
+    QTest::newRow("max") << 100.0;
+}
+
+// Time a LOG_EVENT call blocks its caller, as a percentile.
+// The samples include one steady clock read (a few tens of ns); the queue is drained between batches
+// so no call hits a full queue and returns early.
+void LoggerBenchmark::logLatency()
+{
+    QFETCH(double, percentile);
+
+    if (latencySamplesNs.isEmpty())
+    {
+        latencySamplesNs.reserve(BATCH_SIZE * LATENCY_BATCHES);
+        for (int batch = 0; batch < LATENCY_BATCHES; ++batch)
+        {
+            for (int i = 0; i < BATCH_SIZE; ++i)
+            {
+                const qint64 startNs = MonotonicTime::nowNs();
+                LOG_EVENT(Logger::Info, BinaryLog::MissileStatusUpdated, i, 1);
+                latencySamplesNs.append(MonotonicTime::nowNs() - startNs);
+            }
+            Logger::instance().flush();
+        }
+        std::sort(latencySamplesNs.begin(), latencySamplesNs.end());
+    }
+
+    const int last = latencySamplesNs.size() - 1;
+    const qint64 valueNs = latencySamplesNs[qMin(last, int(percentile / 100.0 * latencySamplesNs.size()))];
+    qInfo("LOG_EVENT latency %s: %lld ns", QTest::currentDataTag(), valueNs);
+    QTest::setBenchmarkResult(valueNs / 1e6, QTest::WalltimeMilliseconds);
+}
@@ -0,0 +1,29 @@
+#ifndef LOGGERBENCHMARK_H
+#define LOGGERBENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+#include <optional>
+#include "LogLevelGuard.h"
+
+// Throughput and caller-side latency of the asynchronous logger
+class LoggerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();    // Record Info entries without console echo, so only the log file is written
+    void cleanupTestCase(); // Restore the logger settings
+
+    void logTextThroughput();  // LOG_INFO free-text entries, queued and written
+    void logEventThroughput(); // LOG_EVENT catalogued entries, queued and written
+    void logDisabledLevel();   // Cost of a LOG_DEBUG/LOG_INFO call below the runtime level
+    void logLatency_data();    // Percentiles reported by logLatency
+    void logLatency();         // Time a LOG_EVENT call blocks its caller, as a percentile
+
+private:
+    QVector<qint64> latencySamplesNs;            // Sorted per-call latencies, measured once for all percentiles
+    std::optional<LogLevelGuard> loggerSettings; // Info level while the class runs
+};
+
+#endif
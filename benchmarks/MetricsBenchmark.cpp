@@ -0,0 +1,72 @@
+#include "MetricsBenchmark.h"
+#include "CommunicationManager.h"
+#include "Metrics.h"
+#include "MonotonicClock.h"
+#include <QtTest>
+
+namespace
+{
+    const std::vector<qint64> LATENCY_BOUNDS_NS = {1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000, 10000000};
+}
+
+// Metrics::Counter::increment
+void MetricsBenchmark::counterIncrement()
+{
+    Metrics::Counter &counter = Metrics::Registry::instance().counter("aks_benchmark_events_total", "Benchmark events.");
+    const quint64 before = counter.value();
+    quint64 increments = 0;
+    QBENCHMARK
+    {
+        counter.increment();
+        ++increments;
+    }
+    QCOMPARE(counter.value() - before, increments);
+}
+
+// Metrics::Histogram::observe over a dozen buckets
+void MetricsBenchmark::histogramObserve()
+{
+    Metrics::Histogram &histogram = Metrics::Registry::instance().histogram("aks_benchmark_latency_seconds", "Benchmark latencies.",
+                                                                            LATENCY_BOUNDS_NS, 1e-9);
+    qint64 value = 0;
+    QBENCHMARK
+    {
+        histogram.observe(value);
+        value = (value + 7919) % 20000000; // Spread over every bucket, including +Inf
+    }
+    QVERIFY(histogram.bucketCount(LATENCY_BOUNDS_NS.size()) > 0);
+}
+
+// The whole registry in the Prometheus text format, with the metrics of a CommunicationManager registered
+void MetricsBenchmark::prometheusExport()
+{
+    ManualClock clock;
+    CommunicationManager manager(nullptr, &clock); // Registers the communication metrics
+    QByteArray text;
+    QBENCHMARK
+    {
+        text.resize(0);
+        Metrics::Registry::instance().writePrometheusText(text);
+    }
+    QVERIFY(text.contains("# TYPE aks_datagrams_received_total counter"));
+    QVERIFY(text.contains("aks_heartbeat_gap_seconds_bucket{peer=\"ans\",le=\"+Inf\"}"));
+}
+
+// Histogram buckets are cumulative and end with +Inf
+void MetricsBenchmark::prometheusTextFormat()
+{
+    Metrics::Histogram &histogram = Metrics::Registry::instance().histogram("aks_benchmark_format_seconds", "Format check.",
+                                                                            {1000000, 2000000}, 1e-9, "case=\"a\"");
+    histogram.observe(500000);
+    histogram.observe(1500000);
+    histogram.observe(1500000);
+    histogram.observe(9000000);
+    QByteArray text;
+    Metrics::Registry::instance().writePrometheusText(text);
+    QVERIFY(text.contains("# HELP aks_benchmark_format_seconds Format check.\n# TYPE aks_benchmark_format_seconds histogram\n"));
+    QVERIFY(text.contains("aks_benchmark_format_seconds_bucket{case=\"a\",le=\"0.001\"} 1\n"));
+    QVERIFY(text.contains("aks_benchmark_format_seconds_bucket{case=\"a\",le=\"0.002\"} 3\n"));
+    QVERIFY(text.contains("aks_benchmark_format_seconds_bucket{case=\"a\",le=\"+Inf\"} 4\n"));
+    QVERIFY(text.contains("aks_benchmark_format_seconds_sum{case=\"a\"} 0.0125\n"));
+    QVERIFY(text.contains("aks_benchmark_format_seconds_count{case=\"a\"} 4\n"));
+}
@@ -0,0 +1,18 @@
+#ifndef METRICSBENCHMARK_H
+#define METRICSBENCHMARK_H
+
+#include <QObject>
+
+// Cost of metric updates on the hot path and of a Prometheus export
+class MetricsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void counterIncrement();     // Metrics::Counter::increment
+    void histogramObserve();     // Metrics::Histogram::observe over a dozen buckets
+    void prometheusExport();     // The whole registry in the Prometheus text format
+    void prometheusTextFormat(); // Histogram buckets are cumulative and end with +Inf
+};
+
+#endif
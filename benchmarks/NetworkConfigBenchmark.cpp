@@ -0,0 +1,133 @@
+#include "NetworkConfigBenchmark.h"
+#include "NetworkConfig.h"
+#include <QtTest>
+
+namespace
+{
+    const quint16 KEPT_PORT = 4321; // Port of the endpoint before parsing
+
+    // Endpoint parsed over, with a port and an address that are visibly not defaults
+    NetworkConfig::Endpoint startingEndpoint()
+    {
+        return {QHostAddress("192.0.2.1"), KEPT_PORT};
+    }
+
+    // Two peers on different hosts, both listening on the default ANS port
+    NetworkConfig samePortConfig()
+    {
+        NetworkConfig config;
+        config.ans = {QHostAddress("10.0.0.1"), NetworkConfig::DEFAULT_ANS_PORT};
+        config.launcher = {QHostAddress("10.0.0.2"), NetworkConfig::DEFAULT_ANS_PORT};
+        return config;
+    }
+}
+
+// Accepted and rejected endpoint texts
+void NetworkConfigBenchmark::parseEndpoint_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QString>("address"); // Expected address; the starting one when not given
+    QTest::addColumn<int>("port");        // Expected port; KEPT_PORT when not given
+
+    QTest::newRow("host:port") << "10.0.0.5:6000" << true << "10.0.0.5" << 6000;
+    QTest::newRow("host") << "10.0.0.5" << true << "10.0.0.5" << int(KEPT_PORT);
+    QTest::newRow(":port") << ":6000" << true << "192.0.2.1" << 6000;
+    QTest::newRow("localhost") << "localhost:6000" << true << "127.0.0.1" << 6000;
+    QTest::newRow("padded") << "  10.0.0.5:6000 " << true << "10.0.0.5" << 6000;
+    QTest::newRow("[v6]:port") << "[fe80::1]:6000" << true << "fe80::1" << 6000;
+    QTest::newRow("[v6]") << "[::1]" << true << "::1" << int(KEPT_PORT);
+    QTest::newRow("bare v6") << "2001:db8::7" << true << "2001:db8::7" << int(KEPT_PORT);
+    QTest::newRow("port 65535") << ":65535" << true << "192.0.2.1" << 65535;
+
+    QTest::newRow("empty") << "" << false << "" << 0;
+    QTest::newRow("colon only") << ":" << false << "" << 0;
+    QTest::newRow("port 0") << ":0" << false << "" << 0;
+    QTest::newRow("port 65536") << ":65536" << false << "" << 0;
+    QTest::newRow("negative port") << "10.0.0.5:-1" << false << "" << 0;
+    QTest::newRow("port not a number") << "10.0.0.5:http" << false << "" << 0;
+    QTest::newRow("host name") << "ans.example:6000" << false << "" << 0; // Not resolved
+    QTest::newRow("unclosed bracket") << "[::1:6000" << false << "" << 0;
+    QTest::newRow("junk after bracket") << "[::1]6000" << false << "" << 0;
+    QTest::newRow("bad v6") << "[::g]:6000" << false << "" << 0;
+}
+
+// Parsed endpoints keep the parts not given; rejected texts leave the endpoint untouched
+void NetworkConfigBenchmark::parseEndpoint()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, valid);
+    QFETCH(QString, address);
+    QFETCH(int, port);
+
+    NetworkConfig::Endpoint endpoint = startingEndpoint();
+    QCOMPARE(NetworkConfig::parseEndpoint(text, endpoint), valid);
+    if (!valid)
+    {
+        QCOMPARE(endpoint.address, startingEndpoint().address);
+        QCOMPARE(endpoint.port, KEPT_PORT);
+        return;
+    }
+    QCOMPARE(endpoint.address, QHostAddress(address));
+    QCOMPARE(int(endpoint.port), port);
+}
+
+// Peers may share a port on different hosts, not a whole endpoint; ports and multicast are checked
+void NetworkConfigBenchmark::validate()
+{
+    QString error;
+    QVERIFY(NetworkConfig().validate(&error));
+    QVERIFY(samePortConfig().validate(&error));
+
+    NetworkConfig config = samePortConfig();
+    config.launcher.address = QHostAddress("::ffff:10.0.0.1"); // The ANS address, IPv4-mapped
+    QVERIFY(!config.validate(&error));
+    QCOMPARE(error, QString("ANS and Launcher must not share the endpoint 10.0.0.1:5001"));
+
+    config = NetworkConfig();
+    config.launcher.port = 0;
+    QVERIFY(!config.validate(&error));
+    QCOMPARE(error, QString("peer ports must not be 0"));
+
+    config = NetworkConfig();
+    config.multicastGroup.address = QHostAddress("10.0.0.9");
+    QVERIFY(!config.validate(&error));
+    QCOMPARE(error, QString("10.0.0.9 is not a multicast address"));
+
+    config = NetworkConfig();
+    config.multicastGroup = {QHostAddress("239.1.2.3"), 0};
+    QVERIFY(!config.validate(&error));
+
+    config = NetworkConfig();
+    config.multicastTtl = 256;
+    QVERIFY(!config.validate(nullptr)); // The error is optional
+}
+
+// A datagram is a peer's only if both address and port match
+void NetworkConfigBenchmark::senderOf()
+{
+    const NetworkConfig config = samePortConfig();
+    const quint16 port = NetworkConfig::DEFAULT_ANS_PORT;
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.1"), port), NetworkConfig::AnsSender);
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.2"), port), NetworkConfig::LauncherSender);
+    QCOMPARE(config.senderOf(QHostAddress("::ffff:10.0.0.2"), port), NetworkConfig::LauncherSender);
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.3"), port), NetworkConfig::UnknownSender); // Right port, other host
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.1"), quint16(port + 1)), NetworkConfig::UnknownSender);
+
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.1").toIPv4Address(), port), NetworkConfig::AnsSender);
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.2").toIPv4Address(), port), NetworkConfig::LauncherSender);
+    QCOMPARE(config.senderOf(QHostAddress("10.0.0.3").toIPv4Address(), port), NetworkConfig::UnknownSender);
+}
+
+// Cost of identifying the sender of one datagram on the network I/O thread
+void NetworkConfigBenchmark::senderLookup()
+{
+    const NetworkConfig config = samePortConfig();
+    const quint32 launcherAddress = QHostAddress("10.0.0.2").toIPv4Address();
+    int launcherDatagrams = 0;
+    QBENCHMARK
+    {
+        launcherDatagrams += config.senderOf(launcherAddress, NetworkConfig::DEFAULT_ANS_PORT) == NetworkConfig::LauncherSender;
+    }
+    QVERIFY(launcherDatagrams > 0);
+}
@@ -0,0 +1,19 @@
+#ifndef NETWORKCONFIGBENCHMARK_H
+#define NETWORKCONFIGBENCHMARK_H
+
+#include <QObject>
+
+// NetworkConfig: endpoint parsing, validation and the per-datagram sender lookup
+class NetworkConfigBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseEndpoint_data(); // Accepted and rejected endpoint texts
+    void parseEndpoint();      // Parsed endpoints keep the parts not given; rejected texts leave the endpoint untouched
+    void validate();           // Peers may share a port on different hosts, not a whole endpoint; ports and multicast are checked
+    void senderOf();           // A datagram is a peer's only if both address and port match
+    void senderLookup();       // Cost of identifying the sender of one datagram on the network I/O thread
+};
+
+#endif
@@ -0,0 +1,250 @@
+#include "ProtocolBenchmark.h"
+#include "AllocationCounter.h"
+#include "CommunicationManager.h"
+#include "GlobalConstants.h"
+#include "IngestQueue.h"
+#include "Metrics.h"
+#include "Protocol.h"
+#include <QtTest>
+
+namespace
+{
+    const char PLATFORM_INFO_DATAGRAM[] = "PLATFORM_INFO,39.925533,32.866287,1250.50"; // Typical ANS message
+    const qint64 PLATFORM_INFO_SIZE = sizeof(PLATFORM_INFO_DATAGRAM) - 1;
+    const int ALLOCATION_CHECK_ROUNDS = 10000;    // Datagrams dispatched while counting allocations
+    const char HEARTBEAT_GROUP[] = "239.255.0.1"; // Administratively scoped group for heartbeatRound
+    const int STORM_PLATFORM_INFO = 200;          // Platform info messages per storm wakeup
+    const int STORM_HEARTBEATS = 50;              // Heartbeats per storm wakeup, interleaved with the positions
+
+    // Heartbeats sent so far, to every peer and group
+    quint64 heartbeatsSent()
+    {
+        Metrics::Registry &metrics = Metrics::Registry::instance();
+        quint64 sent = 0;
+        for (const char *peer : {"peer=\"ans\"", "peer=\"launcher\"", "peer=\"multicast\""})
+        {
+            sent += metrics.counter("aks_datagrams_sent_total", "Datagrams sent per peer.", peer).value();
+        }
+        return sent;
+    }
+}
+
+// Message type classification
+void ProtocolBenchmark::classifyHeartbeat()
+{
+    const qint64 size = sizeof(Protocol::LAUNCHER_HEARTBEAT_TEXT) - 1;
+    Protocol::MessageType type = Protocol::UnknownMessage;
+    QBENCHMARK
+    {
+        type = Protocol::classify(Protocol::LAUNCHER_HEARTBEAT_TEXT, size);
+    }
+    QCOMPARE(type, Protocol::LauncherHeartbeat);
+}
+
+// In-place PLATFORM_INFO parsing
+void ProtocolBenchmark::parsePlatformInfo()
+{
+    double latitude = 0.0, longitude = 0.0, altitude = 0.0;
+    bool ok = false;
+    QBENCHMARK
+    {
+        ok = Protocol::parsePlatformInfo(PLATFORM_INFO_DATAGRAM, PLATFORM_INFO_SIZE, &latitude, &longitude, &altitude);
+    }
+    QVERIFY(ok);
+    QCOMPARE(latitude, 39.925533);
+    QCOMPARE(longitude, 32.866287);
+    QCOMPARE(altitude, 1250.50);
+}
+
+// The former split(',') + toDouble parsing, for comparison
+void ProtocolBenchmark::parsePlatformInfoSplit()
+{
+    QByteArray data(PLATFORM_INFO_DATAGRAM, int(PLATFORM_INFO_SIZE));
+    double latitude = 0.0;
+    QBENCHMARK
+    {
+        QList<QByteArray> parts = data.split(',');
+        if (parts.size() == 4 && parts[0] == "PLATFORM_INFO")
+        {
+            latitude = parts[1].toDouble();
+        }
+    }
+    QCOMPARE(latitude, 39.925533);
+}
+
+// Binary PLATFORM_INFO decoding
+void ProtocolBenchmark::decodeBinaryPlatformInfo()
+{
+    Protocol::Message message;
+    message.type = Protocol::PlatformInfo;
+    message.latitude = 39.925533;
+    message.longitude = 32.866287;
+    message.altitude = 1250.50;
+    char datagram[Protocol::MAX_BINARY_MESSAGE_SIZE];
+    int size = Protocol::encodeBinary(message, datagram, sizeof(datagram));
+    QVERIFY(size > 0);
+
+    Protocol::Message decoded;
+    bool ok = false;
+    QBENCHMARK
+    {
+        ok = Protocol::decode(datagram, size, decoded);
+    }
+    QVERIFY(ok);
+    QCOMPARE(decoded.encoding, Protocol::BinaryEncoding);
+    QCOMPARE(decoded.latitude, 39.925533);
+}
+
+// Full CommunicationManager dispatch of a PLATFORM_INFO datagram
+void ProtocolBenchmark::handleDatagram()
+{
+    CommunicationManager manager;
+    int received = 0;
+    connect(&manager, &CommunicationManager::platformInfoReceived, this, [&received](double, double, double)
+            { ++received; });
+
+    QBENCHMARK
+    {
+        manager.handleDatagram(PLATFORM_INFO_DATAGRAM, PLATFORM_INFO_SIZE, NetworkConfig::DEFAULT_ANS_PORT);
+    }
+    QVERIFY(received > 0);
+}
+
+// Steady-state dispatch must not allocate
+void ProtocolBenchmark::handleDatagramAllocations()
+{
+    CommunicationManager manager;
+    int received = 0;
+    connect(&manager, &CommunicationManager::platformInfoReceived, this, [&received](double, double, double)
+            { ++received; });
+    const qint64 ansHeartbeatSize = sizeof(Protocol::ANS_HEARTBEAT_TEXT) - 1;
+    const qint64 launcherHeartbeatSize = sizeof(Protocol::LAUNCHER_HEARTBEAT_TEXT) - 1;
+
+    Protocol::Message binaryInfo;
+    binaryInfo.type = Protocol::PlatformInfo;
+    char binaryDatagram[Protocol::MAX_BINARY_MESSAGE_SIZE];
+    int binarySize = Protocol::encodeBinary(binaryInfo, binaryDatagram, sizeof(binaryDatagram));
+
+    // Warm up once so one-time initialisation is not counted
+    manager.handleDatagram(PLATFORM_INFO_DATAGRAM, PLATFORM_INFO_SIZE, NetworkConfig::DEFAULT_ANS_PORT);
+
+    AllocationCounter::Scope textScope;
+    for (int i = 0; i < ALLOCATION_CHECK_ROUNDS; ++i)
+    {
+        manager.handleDatagram(PLATFORM_INFO_DATAGRAM, PLATFORM_INFO_SIZE, NetworkConfig::DEFAULT_ANS_PORT);
+        manager.handleDatagram(Protocol::ANS_HEARTBEAT_TEXT, ansHeartbeatSize, NetworkConfig::DEFAULT_ANS_PORT);
+        manager.handleDatagram(Protocol::LAUNCHER_HEARTBEAT_TEXT, launcherHeartbeatSize, NetworkConfig::DEFAULT_LAUNCHER_PORT);
+    }
+    quint64 textAllocations = textScope.allocations();
+
+    // The first binary datagram switches ANS to binary (and logs it), so it is not counted
+    manager.handleDatagram(binaryDatagram, binarySize, NetworkConfig::DEFAULT_ANS_PORT);
+
+    AllocationCounter::Scope binaryScope;
+    for (int i = 0; i < ALLOCATION_CHECK_ROUNDS; ++i)
+    {
+        manager.handleDatagram(binaryDatagram, binarySize, NetworkConfig::DEFAULT_ANS_PORT);
+    }
+    quint64 binaryAllocations = binaryScope.allocations();
+
+    qInfo("handleDatagram: %llu allocations for %d text datagrams, %llu for %d binary datagrams",
+          textAllocations, 3 * ALLOCATION_CHECK_ROUNDS, binaryAllocations, ALLOCATION_CHECK_ROUNDS);
+    QCOMPARE(received, 2 * ALLOCATION_CHECK_ROUNDS + 2);
+    QCOMPARE(textAllocations, quint64(0));
+    QCOMPARE(binaryAllocations, quint64(0));
+}
+
+// One datagram per peer, or one to the multicast group
+void ProtocolBenchmark::heartbeatRound_data()
+{
+    QTest::addColumn<bool>("multicast");
+    QTest::newRow("unicast") << false;
+    QTest::newRow("multicast") << true;
+}
+
+// Datagrams and time per heartbeat round; with a multicast group both stay constant as peers are added
+void ProtocolBenchmark::heartbeatRound()
+{
+    QFETCH(bool, multicast);
+
+    NetworkConfig config;
+    config.bind.port = 0; // Any free port, a live AKS may hold the default one
+    if (multicast)
+    {
+        config.multicastGroup.address = QHostAddress(QString(HEARTBEAT_GROUP));
+    }
+    CommunicationManager manager;
+    manager.setNetworkConfig(config);
+    manager.start();
+
+    const quint64 sentBefore = heartbeatsSent();
+    int rounds = 0;
+    QBENCHMARK
+    {
+        QMetaObject::invokeMethod(&manager, "sendHeartbeat", Qt::DirectConnection);
+        ++rounds;
+    }
+    QCOMPARE(heartbeatsSent() - sentBefore, quint64(rounds) * (multicast ? 1 : 2));
+}
+
+// Overload policies of the ingest queue under a packet storm: one wakeup's worth of positions and
+// heartbeats goes in, every heartbeat and only the newest position come out
+void ProtocolBenchmark::ingestStorm()
+{
+    IngestQueue queue(GlobalConstants::INGEST_BUDGET_PER_WAKEUP);
+    IngestQueue::Entry platformInfo = {};
+    platformInfo.message.type = Protocol::PlatformInfo;
+    platformInfo.sender = NetworkConfig::AnsSender;
+    IngestQueue::Entry heartbeat = {};
+    heartbeat.message.type = Protocol::ANSHeartbeat;
+    heartbeat.sender = NetworkConfig::AnsSender;
+
+    int wakeups = 0;
+    int heartbeatsOut = 0;
+    int positionsOut = 0;
+    double lastLatitude = 0.0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < STORM_PLATFORM_INFO; ++i)
+        {
+            platformInfo.message.latitude = i;
+            queue.push(platformInfo);
+            if (i % (STORM_PLATFORM_INFO / STORM_HEARTBEATS) == 0)
+            {
+                queue.push(heartbeat);
+            }
+        }
+        IngestQueue::Entry entry;
+        while (queue.take(entry))
+        {
+            if (entry.message.type == Protocol::PlatformInfo)
+            {
+                ++positionsOut;
+                lastLatitude = entry.message.latitude;
+            }
+            else
+            {
+                ++heartbeatsOut;
+            }
+        }
+        ++wakeups;
+    }
+    QCOMPARE(positionsOut, wakeups);
+    QCOMPARE(lastLatitude, double(STORM_PLATFORM_INFO - 1));
+    QCOMPARE(heartbeatsOut, wakeups * STORM_HEARTBEATS);
+    QCOMPARE(queue.shedPlatformInfo(), quint64(wakeups) * (STORM_PLATFORM_INFO - 1));
+    QCOMPARE(queue.shedHeartbeats(), quint64(0));
+
+    // Beyond its capacity the FIFO sheds heartbeats instead of growing
+    for (int i = 0; i <= GlobalConstants::INGEST_BUDGET_PER_WAKEUP; ++i)
+    {
+        queue.push(heartbeat);
+    }
+    QCOMPARE(queue.shedHeartbeats(), quint64(1));
+
+    // Undecodable datagrams are counted, not dispatched
+    CommunicationManager manager;
+    const char garbage[] = "NOT_A_MESSAGE";
+    manager.handleDatagram(garbage, sizeof(garbage) - 1, NetworkConfig::DEFAULT_ANS_PORT);
+    QCOMPARE(manager.ingestStatistics().malformed, quint64(1));
+}
@@ -0,0 +1,23 @@
+#ifndef PROTOCOLBENCHMARK_H
+#define PROTOCOLBENCHMARK_H
+
+#include <QObject>
+
+// Benchmarks for the datagram receive and parse path
+class ProtocolBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void classifyHeartbeat();          // Message type classification
+    void parsePlatformInfo();          // In-place PLATFORM_INFO parsing
+    void parsePlatformInfoSplit();     // The former split(',') + toDouble parsing, for comparison
+    void decodeBinaryPlatformInfo();   // Binary PLATFORM_INFO decoding
+    void handleDatagram();             // Full CommunicationManager dispatch of a PLATFORM_INFO datagram
+    void handleDatagramAllocations();  // Steady-state dispatch must not allocate
+    void heartbeatRound_data();        // One datagram per peer, or one to the multicast group
+    void heartbeatRound();             // Datagrams and time per heartbeat round
+    void ingestStorm();                // Overload policies of the ingest queue under a packet storm
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "ReplayBenchmark.h"
+#include "CommunicationManager.h"
+#include "DatagramCapture.h"
+#include "DatagramReplayer.h"
+#include "MonotonicClock.h"
+#include "Protocol.h"
+#include <QtTest>
+
+namespace
+{
+    const int CAPTURE_SECONDS = 120;            // Length of the generated capture
+    const int PLATFORM_INFO_RATE_HZ = 100;      // ANS platform info rate in the capture
+    const int ANS_SILENT_FROM_S = 60;           // ANS stops sending for ANS_SILENT_SECONDS from here,
+    const int ANS_SILENT_SECONDS = 8;           // long enough for a communication loss
+    const qint64 CAPTURE_START_NS = 5000000000; // Monotonic time of the first datagram
+    const qint64 NS_PER_S = 1000000000;         // Nanoseconds per second
+
+    // Outcome of one replay
+    struct ReplayResult
+    {
+        quint64 replayed = 0;                  // Datagrams handed to the manager
+        int platformInfos = 0;                 // platformInfoReceived emissions
+        int ansLost = 0;                       // ansCommunicationLost emissions
+        LinkStatistics::Snapshot ansLink;      // ANS link statistics at the end
+        LinkStatistics::Snapshot launcherLink; // Launcher link statistics at the end
+    };
+
+    // Replay 'path' as fast as possible into a fresh manager
+    ReplayResult replay(const QString &path)
+    {
+        ManualClock clock;
+        CommunicationManager manager(nullptr, &clock);
+        DatagramReplayer replayer(&manager, &clock);
+        ReplayResult result;
+        QObject::connect(&manager, &CommunicationManager::platformInfoReceived, [&result](double, double, double)
+                         { ++result.platformInfos; });
+        QObject::connect(&manager, &CommunicationManager::ansCommunicationLost, [&result]()
+                         { ++result.ansLost; });
+        if (!replayer.open(path))
+        {
+            return result;
+        }
+        manager.startOffline();
+        replayer.replayAll();
+        result.replayed = replayer.stats().replayed;
+        result.ansLink = manager.ansLinkStatistics();
+        result.launcherLink = manager.launcherLinkStatistics();
+        manager.stop();
+        return result;
+    }
+}
+
+// Write a capture of ANS and Launcher traffic
+void ReplayBenchmark::initTestCase()
+{
+    QVERIFY(directory.isValid());
+    capturePath = directory.filePath("traffic.aksdcap");
+    DatagramCapture capture;
+    QVERIFY(capture.open(capturePath));
+
+    // Binary ANS heartbeats and platform info, text Launcher heartbeats, with a little arrival jitter
+    char buffer[Protocol::MAX_ENCODED_MESSAGE_SIZE];
+    Protocol::Message platformInfo;
+    platformInfo.type = Protocol::PlatformInfo;
+    platformInfo.latitude = 39.925533;
+    platformInfo.longitude = 32.866287;
+    platformInfo.altitude = 1250.50;
+    Protocol::Message heartbeat;
+    heartbeat.type = Protocol::ANSHeartbeat;
+    heartbeat.hasSequence = true;
+    const qint64 launcherHeartbeatSize = sizeof(Protocol::LAUNCHER_HEARTBEAT_TEXT) - 1;
+    quint32 jitterState = 12345; // Fixed seed, the capture is the same every run
+
+    const qint64 platformIntervalNs = NS_PER_S / PLATFORM_INFO_RATE_HZ;
+    for (qint64 tick = 0; tick < qint64(CAPTURE_SECONDS) * PLATFORM_INFO_RATE_HZ; ++tick)
+    {
+        jitterState = jitterState * 1103515245u + 12345u;
+        const qint64 nowNs = CAPTURE_START_NS + tick * platformIntervalNs + (jitterState >> 16) % 200000;
+        const qint64 second = tick / PLATFORM_INFO_RATE_HZ;
+        const bool ansSilent = second >= ANS_SILENT_FROM_S && second < ANS_SILENT_FROM_S + ANS_SILENT_SECONDS;
+        if (tick % PLATFORM_INFO_RATE_HZ == 0)
+        {
+            if (!ansSilent)
+            {
+                heartbeat.sequence = quint32(second);
+                heartbeat.timestampNs = nowNs;
+                const int length = Protocol::encodeBinary(heartbeat, buffer, sizeof(buffer));
+                capture.record(CaptureFormat::Received, NetworkConfig::DEFAULT_ANS_PORT, nowNs, buffer, length);
+            }
+            capture.record(CaptureFormat::Received, NetworkConfig::DEFAULT_LAUNCHER_PORT, nowNs + 1000,
+                           Protocol::LAUNCHER_HEARTBEAT_TEXT, launcherHeartbeatSize);
+            capture.record(CaptureFormat::Sent, NetworkConfig::DEFAULT_ANS_PORT, nowNs + 2000,
+                           Protocol::AKS_HEARTBEAT_TEXT, sizeof(Protocol::AKS_HEARTBEAT_TEXT) - 1); // Skipped by the replay
+        }
+        if (!ansSilent)
+        {
+            const int length = Protocol::encodeBinary(platformInfo, buffer, sizeof(buffer));
+            capture.record(CaptureFormat::Received, NetworkConfig::DEFAULT_ANS_PORT, nowNs + 500, buffer, length);
+        }
+    }
+    capture.close();
+}
+
+// Two replays of one capture end in the same state
+void ReplayBenchmark::replayIsDeterministic()
+{
+    const ReplayResult first = replay(capturePath);
+    const ReplayResult second = replay(capturePath);
+
+    const int expectedPlatformInfos = (CAPTURE_SECONDS - ANS_SILENT_SECONDS) * PLATFORM_INFO_RATE_HZ;
+    QCOMPARE(first.platformInfos, expectedPlatformInfos);
+    QCOMPARE(first.ansLost, 1); // The silence is longer than the heartbeat timeout
+    QCOMPARE(first.ansLink.lost, quint64(ANS_SILENT_SECONDS));
+    QVERIFY(first.ansLink.jitterNs > 0);
+
+    QCOMPARE(second.replayed, first.replayed);
+    QCOMPARE(second.platformInfos, first.platformInfos);
+    QCOMPARE(second.ansLost, first.ansLost);
+    QCOMPARE(second.ansLink.received, first.ansLink.received);
+    QCOMPARE(second.ansLink.lost, first.ansLink.lost);
+    QCOMPARE(second.ansLink.jitterNs, first.ansLink.jitterNs);
+    QCOMPARE(second.launcherLink.received, first.launcherLink.received);
+}
+
+// Throughput of a replay as fast as possible; each iteration replays the whole capture into a fresh manager
+void ReplayBenchmark::replayMaxSpeed()
+{
+    quint64 replayed = 0;
+    QBENCHMARK
+    {
+        replayed = replay(capturePath).replayed;
+    }
+    QVERIFY(replayed > 0);
+    qInfo("%llu datagrams (%d s of traffic) per iteration", replayed, CAPTURE_SECONDS);
+}
@@ -0,0 +1,23 @@
+#ifndef REPLAYBENCHMARK_H
+#define REPLAYBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// CommunicationManager fed from a datagram capture by DatagramReplayer, without the network
+class ReplayBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase(); // Write a capture of ANS and Launcher traffic
+
+    void replayIsDeterministic(); // Two replays of one capture end in the same state
+    void replayMaxSpeed();        // Throughput of a replay as fast as possible
+
+private:
+    QTemporaryDir directory; // Holds the generated capture
+    QString capturePath;     // Capture of CAPTURE_SECONDS of traffic
+};
+
+#endif
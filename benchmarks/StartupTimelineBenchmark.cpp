@@ -0,0 +1,99 @@
+#include "StartupTimelineBenchmark.h"
+#include "CommunicationManager.h"
+#include "GlobalConstants.h"
+#include "Metrics.h"
+#include "MonotonicClock.h"
+#include "StartupTimeline.h"
+#include <QtTest>
+
+namespace
+{
+    const qint64 MS = 1000000; // Nanoseconds per millisecond
+
+    // A manager that tells how many slots its heartbeat signals reach; never started
+    class WatchedManager : public CommunicationManager
+    {
+    public:
+        explicit WatchedManager(MonotonicClock *clock) : CommunicationManager(nullptr, clock) {}
+
+        int heartbeatReceivers() const
+        {
+            return receivers(SIGNAL(ansHeartbeatReceived())) + receivers(SIGNAL(launcherHeartbeatReceived()));
+        }
+    };
+
+    // The process-wide gauge the timeline exports
+    Metrics::Gauge &linkUpGauge()
+    {
+        return Metrics::Registry::instance().gauge("aks_startup_link_up_ms",
+                                                   "Milliseconds from process start until the first heartbeat of every peer.");
+    }
+}
+
+// Both first heartbeats arrive: the timeline is complete and aks_startup_link_up_ms is set
+void StartupTimelineBenchmark::milestonesReached()
+{
+    ManualClock clock;
+    WatchedManager manager(&clock); // Only its heartbeat signals are used
+    const qint64 startNs = clock.nowNs();
+    StartupTimeline timeline(&clock, startNs);
+    timeline.recordPhase("config", startNs + 1 * MS, startNs + 3 * MS);
+    timeline.watch(&manager);
+
+    clock.advanceMs(10);
+    emit manager.ansHeartbeatReceived();
+    QVERIFY(!timeline.isLogged()); // Still waiting for the Launcher
+    QCOMPARE(manager.heartbeatReceivers(), 2);
+    clock.advanceMs(5);
+    emit manager.launcherHeartbeatReceived();
+    QVERIFY(timeline.isLogged());
+    QCOMPARE(manager.heartbeatReceivers(), 0); // Disconnected once complete
+    QCOMPARE(timeline.toString(), QString("config 2.0 ms at 1.0 ms, first ANS heartbeat at 10.0 ms, first Launcher heartbeat at 15.0 ms"));
+    QCOMPARE(linkUpGauge().value(), qint64(15));
+
+    clock.advanceMs(1000);
+    emit manager.ansHeartbeatReceived(); // Later heartbeats change nothing
+    QCOMPARE(timeline.toString(), QString("config 2.0 ms at 1.0 ms, first ANS heartbeat at 10.0 ms, first Launcher heartbeat at 15.0 ms"));
+}
+
+// A peer stays silent: the timeline is logged with it pending, the late heartbeat follows
+void StartupTimelineBenchmark::timeout()
+{
+    ManualClock clock;
+    WatchedManager manager(&clock);
+    StartupTimeline timeline(&clock, clock.nowNs());
+    timeline.watch(&manager);
+    const qint64 linkUpBefore = linkUpGauge().value();
+
+    clock.advanceMs(20);
+    emit manager.ansHeartbeatReceived();
+    clock.advanceMs(GlobalConstants::STARTUP_TIMELINE_TIMEOUT_MS);
+    QVERIFY(timeline.isLogged());
+    QCOMPARE(timeline.toString(), QString("first ANS heartbeat at 20.0 ms, first Launcher heartbeat pending"));
+    QCOMPARE(linkUpGauge().value(), linkUpBefore); // Not both peers yet
+    QCOMPARE(manager.heartbeatReceivers(), 2);     // Still waiting for the Launcher after the timeout
+
+    clock.advanceMs(500);
+    emit manager.launcherHeartbeatReceived(); // Logged on its own line
+    QCOMPARE(timeline.toString(), QString("first ANS heartbeat at 20.0 ms, first Launcher heartbeat at 30520.0 ms"));
+    QCOMPARE(linkUpGauge().value(), qint64(30520));
+    QCOMPARE(manager.heartbeatReceivers(), 0);
+}
+
+// A heartbeat once the timeline is complete
+void StartupTimelineBenchmark::laterHeartbeat()
+{
+    ManualClock clock;
+    WatchedManager manager(&clock);
+    StartupTimeline timeline(&clock, clock.nowNs());
+    timeline.watch(&manager);
+    emit manager.ansHeartbeatReceived();
+    emit manager.launcherHeartbeatReceived();
+    QVERIFY(timeline.isLogged());
+    QCOMPARE(manager.heartbeatReceivers(), 0);
+
+    QBENCHMARK
+    {
+        emit manager.ansHeartbeatReceived();
+    }
+}
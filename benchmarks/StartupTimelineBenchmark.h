@@ -0,0 +1,17 @@
+#ifndef STARTUPTIMELINEBENCHMARK_H
+#define STARTUPTIMELINEBENCHMARK_H
+
+#include <QObject>
+
+// StartupTimeline on a ManualClock: the logged timeline, its timeout and the per-heartbeat cost once it is complete
+class StartupTimelineBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void milestonesReached(); // Both first heartbeats arrive: the timeline is complete and aks_startup_link_up_ms is set
+    void timeout();           // A peer stays silent: the timeline is logged with it pending, the late heartbeat follows
+    void laterHeartbeat();    // A heartbeat once the timeline is complete: the timeline is disconnected, only the emission is left
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "TelemetryHistoryBenchmark.h"
+#include "AllocationCounter.h"
+#include "GlobalConstants.h"
+#include "MinMaxDecimator.h"
+#include "TelemetryHistory.h"
+#include <QtTest>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const qint64 SAMPLE_INTERVAL_NS = 16666667;    // 60 Hz platform info
+    const qint64 HOUR_NS = 60LL * 60 * 1000000000; // Span of the GUI trend plots
+
+    // Fields derived from the timestamp, so a reader can tell a torn sample from a whole one
+    double latitudeAt(qint64 timestampNs) { return double(timestampNs % 1000003) * 1e-4; }
+    double longitudeAt(qint64 timestampNs) { return double(timestampNs % 999983) * 1e-4; }
+    double altitudeAt(qint64 timestampNs) { return double(timestampNs / SAMPLE_INTERVAL_NS); }
+
+    // Append 'count' samples at 60 Hz after 'position' samples
+    void fill(TelemetryHistory &history, qint64 position, qint64 count)
+    {
+        for (qint64 i = position; i < position + count; ++i)
+        {
+            const qint64 timestampNs = i * SAMPLE_INTERVAL_NS;
+            history.append(timestampNs, latitudeAt(timestampNs), longitudeAt(timestampNs), altitudeAt(timestampNs));
+        }
+    }
+
+    // Count the samples of 'snapshot' that are out of order or torn
+    int countInconsistent(const TelemetryHistory::Snapshot &snapshot)
+    {
+        int inconsistent = 0;
+        for (int i = 0; i < snapshot.size(); ++i)
+        {
+            const qint64 timestampNs = snapshot.timestampsNs[i];
+            if ((i > 0 && timestampNs < snapshot.timestampsNs[i - 1]) || snapshot.latitudes[i] != latitudeAt(timestampNs) ||
+                snapshot.longitudes[i] != longitudeAt(timestampNs) || snapshot.altitudes[i] != altitudeAt(timestampNs))
+            {
+                ++inconsistent;
+            }
+        }
+        return inconsistent;
+    }
+}
+
+// One sample into a full ring
+void TelemetryHistoryBenchmark::append()
+{
+    TelemetryHistory history(GlobalConstants::TELEMETRY_HISTORY_SAMPLES);
+    fill(history, 0, history.capacity());
+
+    qint64 timestampNs = qint64(history.capacity()) * SAMPLE_INTERVAL_NS;
+    AllocationCounter::Scope scope;
+    QBENCHMARK
+    {
+        history.append(timestampNs, 39.9, 32.8, 1000.0);
+        timestampNs += SAMPLE_INTERVAL_NS;
+    }
+    QCOMPARE(scope.allocations(), quint64(0));
+    QCOMPARE(history.size(), history.capacity());
+}
+
+// The last tenth of a full ring
+void TelemetryHistoryBenchmark::rangeQuery()
+{
+    TelemetryHistory history(GlobalConstants::TELEMETRY_HISTORY_SAMPLES);
+    fill(history, 0, history.capacity());
+
+    const qint64 newestNs = qint64(history.capacity() - 1) * SAMPLE_INTERVAL_NS;
+    const qint64 windowNs = qint64(history.capacity() / 10) * SAMPLE_INTERVAL_NS;
+    TelemetryHistory::Snapshot snapshot;
+    history.range(newestNs - windowNs, newestNs, snapshot); // Sizes the snapshot once
+
+    AllocationCounter::Scope scope;
+    QBENCHMARK
+    {
+        history.range(newestNs - windowNs, newestNs, snapshot);
+    }
+    QCOMPARE(scope.allocations(), quint64(0));
+    QCOMPARE(snapshot.size(), history.capacity() / 10 + 1);
+    QCOMPARE(snapshot.timestampsNs.front(), newestNs - windowNs);
+    QCOMPARE(snapshot.timestampsNs.back(), newestNs);
+    QCOMPARE(countInconsistent(snapshot), 0);
+}
+
+// The ring keeps the newest samples; queries clamp to what is kept
+void TelemetryHistoryBenchmark::wrapAround()
+{
+    TelemetryHistory history(1000);
+    QCOMPARE(history.capacity(), 1024);
+
+    TelemetryHistory::Sample newest;
+    QVERIFY(!history.newest(newest));
+    fill(history, 0, 3000);
+    QCOMPARE(history.size(), 1024);
+    QCOMPARE(history.appendedCount(), quint64(3000));
+    QVERIFY(history.newest(newest));
+    QCOMPARE(newest.timestampNs, 2999 * SAMPLE_INTERVAL_NS);
+
+    TelemetryHistory::Snapshot snapshot;
+    history.range(0, newest.timestampNs, snapshot); // Reaches back past the oldest sample kept
+    QCOMPARE(snapshot.size(), 1024);
+    QCOMPARE(snapshot.timestampsNs.front(), (3000 - 1024) * SAMPLE_INTERVAL_NS);
+
+    history.latest(5, snapshot);
+    QCOMPARE(snapshot.size(), 5);
+    QCOMPARE(snapshot.timestampsNs.front(), 2995 * SAMPLE_INTERVAL_NS);
+    QCOMPARE(countInconsistent(snapshot), 0);
+
+    history.range(newest.timestampNs + 1, newest.timestampNs + SAMPLE_INTERVAL_NS, snapshot);
+    QCOMPARE(snapshot.size(), 0);
+
+    history.append(0, 1.0, 2.0, 3.0); // Older than the newest sample: kept in order at the newest time
+    QVERIFY(history.newest(newest));
+    QCOMPARE(newest.timestampNs, 2999 * SAMPLE_INTERVAL_NS);
+    QCOMPARE(newest.latitude, 1.0);
+}
+
+// Readers racing a writer that laps the ring
+void TelemetryHistoryBenchmark::concurrentReaders()
+{
+    const qint64 samples = 2000000;
+    TelemetryHistory history(1024); // Small, so the writer overwrites what the readers are copying
+    std::atomic<bool> writing(true);
+    std::atomic<int> inconsistent(0);
+    std::atomic<int> queries(0);
+
+    // Reader 0 queries time ranges, reader 1 the newest samples
+    auto read = [&history, &writing, &inconsistent, &queries](int reader)
+    {
+        TelemetryHistory::Snapshot snapshot;
+        TelemetryHistory::Sample newest;
+        while (writing.load(std::memory_order_acquire))
+        {
+            if (reader == 0 && history.newest(newest))
+            {
+                history.range(newest.timestampNs - 512 * SAMPLE_INTERVAL_NS, newest.timestampNs, snapshot);
+            }
+            else
+            {
+                history.latest(1024, snapshot);
+            }
+            inconsistent.fetch_add(countInconsistent(snapshot), std::memory_order_relaxed);
+            queries.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    std::vector<std::thread> readers;
+    readers.emplace_back(read, 0);
+    readers.emplace_back(read, 1);
+
+    fill(history, 0, samples);
+    writing.store(false, std::memory_order_release);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    QVERIFY(queries.load() > 0);
+    QCOMPARE(inconsistent.load(), 0);
+    QCOMPARE(history.appendedCount(), quint64(samples));
+}
+
+// One sample folded into its plot column
+void TelemetryHistoryBenchmark::decimateSample()
+{
+    MinMaxDecimator decimator;
+    decimator.setGeometry(1000, HOUR_NS);
+
+    qint64 timestampNs = 0;
+    AllocationCounter::Scope scope;
+    QBENCHMARK
+    {
+        decimator.add(timestampNs, altitudeAt(timestampNs));
+        timestampNs += SAMPLE_INTERVAL_NS;
+    }
+    QCOMPARE(scope.allocations(), quint64(0));
+    QVERIFY(decimator.column(decimator.columnCount() - 1).valid);
+}
+
+// Rows: plot width and samples folded in
+void TelemetryHistoryBenchmark::fullRedraw_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<qint64>("samples");
+    QTest::newRow("400 columns, 1 minute") << 400 << qint64(60 * 60);
+    QTest::newRow("400 columns, 1 hour") << 400 << qint64(60 * 60 * 60);
+    QTest::newRow("1600 columns, 1 minute") << 1600 << qint64(60 * 60);
+    QTest::newRow("1600 columns, 1 hour") << 1600 << qint64(60 * 60 * 60);
+}
+
+// Walking every column, as a full plot redraw does
+void TelemetryHistoryBenchmark::fullRedraw()
+{
+    QFETCH(int, columns);
+    QFETCH(qint64, samples);
+
+    MinMaxDecimator decimator;
+    decimator.setGeometry(columns, HOUR_NS);
+    for (qint64 i = 0; i < samples; ++i)
+    {
+        decimator.add(i * SAMPLE_INTERVAL_NS, altitudeAt(i * SAMPLE_INTERVAL_NS));
+    }
+
+    double extent = 0;
+    QBENCHMARK
+    {
+        double minimum;
+        double maximum;
+        QVERIFY(decimator.valueRange(minimum, maximum));
+        for (int x = 0; x < decimator.columnCount(); ++x)
+        {
+            const MinMaxDecimator::Column &column = decimator.column(x);
+            extent += column.valid ? column.maximum - column.minimum : 0; // Stands in for drawing the column
+        }
+    }
+    QVERIFY(extent >= 0);
+}
+
+// Columns hold each span's extremes; scrolling, dirty columns and resizing
+void TelemetryHistoryBenchmark::decimatorColumns()
+{
+    MinMaxDecimator decimator;
+    decimator.setGeometry(10, 10000); // 1000 ns per column
+    decimator.takeChanges();
+
+    decimator.add(9000, 5.0);
+    decimator.add(9500, -2.0);
+    decimator.add(9900, 1.0); // Inside the extremes
+    MinMaxDecimator::Changes changes = decimator.takeChanges();
+    QCOMPARE(changes.scrolled, 0);
+    QCOMPARE(changes.firstDirty, 9);
+    QCOMPARE(decimator.column(9).minimum, -2.0);
+    QCOMPARE(decimator.column(9).maximum, 5.0);
+    QVERIFY(!decimator.column(8).valid);
+
+    decimator.add(9950, 0.0); // Changes no extreme
+    changes = decimator.takeChanges();
+    QCOMPARE(changes.firstDirty, 10);
+
+    decimator.add(11000, 3.0); // Two columns later: the plot scrolls by two, the skipped column stays empty
+    changes = decimator.takeChanges();
+    QCOMPARE(changes.scrolled, 2);
+    QCOMPARE(changes.firstDirty, 8);
+    QCOMPARE(decimator.column(7).maximum, 5.0);
+    QVERIFY(!decimator.column(8).valid);
+    QCOMPARE(decimator.column(9).minimum, 3.0);
+
+    decimator.add(1000, 100.0); // Older than the plot
+    QCOMPARE(decimator.takeChanges().firstDirty, 10);
+
+    decimator.setGeometry(5, 10000); // 2000 ns per column: pairs of columns merge
+    QCOMPARE(decimator.columnSpanNs(), qint64(2000));
+    QCOMPARE(decimator.takeChanges().scrolled, 5);
+    QCOMPARE(decimator.column(4).minimum, 3.0);  // [10000, 12000)
+    QCOMPARE(decimator.column(3).minimum, -2.0); // [8000, 10000)
+    QCOMPARE(decimator.column(3).maximum, 5.0);
+    QVERIFY(!decimator.column(2).valid);         // [6000, 8000)
+    double minimum;
+    double maximum;
+    QVERIFY(decimator.valueRange(minimum, maximum));
+    QCOMPARE(minimum, -2.0);
+    QCOMPARE(maximum, 5.0);
+
+    decimator.add(100000, 0.0); // Far beyond the plot: everything scrolls out
+    QCOMPARE(decimator.takeChanges().scrolled, 5);
+    QVERIFY(decimator.valueRange(minimum, maximum));
+    QCOMPARE(maximum, 0.0);
+
+    decimator.clear();
+    QVERIFY(!decimator.valueRange(minimum, maximum));
+}
@@ -0,0 +1,23 @@
+#ifndef TELEMETRYHISTORYBENCHMARK_H
+#define TELEMETRYHISTORYBENCHMARK_H
+
+#include <QObject>
+
+// Cost of keeping and querying the platform telemetry history, the consistency of its lock-free reads,
+// and the cost of reducing it to trend plot columns
+class TelemetryHistoryBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void append();            // One sample into a full ring: four stores, no allocation
+    void rangeQuery();        // The last tenth of a full ring: two binary searches and a copy per field
+    void wrapAround();        // The ring keeps the newest samples; queries clamp to what is kept
+    void concurrentReaders(); // Readers racing a writer that laps the ring never see torn or unordered samples
+    void decimateSample();    // One sample folded into its plot column: O(1), no allocation
+    void fullRedraw_data();
+    void fullRedraw();        // Walking every column, as a full plot redraw does: depends on the width, not the samples
+    void decimatorColumns();  // Columns hold each span's extremes; scrolling, dirty columns and resizing
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include "TraceBenchmark.h"
+#include "Trace.h"
+#include <QFile>
+#include <QtTest>
+
+// A span while tracing is off
+void TraceBenchmark::scopeDisabled()
+{
+    QVERIFY(!Trace::isEnabled());
+    QBENCHMARK
+    {
+        TRACE_SCOPE("TraceBenchmark::scopeDisabled");
+    }
+}
+
+// A span while tracing is on; once the thread's buffer is full, later spans are counted as dropped
+void TraceBenchmark::scopeEnabled()
+{
+    Trace::start(directory.filePath("enabled.json"));
+    QBENCHMARK
+    {
+        TRACE_SCOPE("TraceBenchmark::scopeEnabled");
+    }
+    QVERIFY(Trace::stop());
+}
+
+// stop() writes Chrome trace-event JSON with the recorded spans
+void TraceBenchmark::traceFile()
+{
+    const QString path = directory.filePath("trace.json");
+    Trace::start(path);
+    {
+        TRACE_SCOPE("TraceBenchmark::traceFile");
+    }
+    QVERIFY(Trace::stop());
+    QVERIFY(!Trace::isEnabled());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray json = file.readAll();
+    QVERIFY(json.startsWith("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    QVERIFY(json.contains("\"args\":{\"name\":\"main\"}"));
+    QVERIFY(json.contains("{\"ph\":\"X\",\"name\":\"TraceBenchmark::traceFile\""));
+    QVERIFY(json.trimmed().endsWith("]}"));
+}
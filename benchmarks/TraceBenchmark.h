@@ -0,0 +1,21 @@
+#ifndef TRACEBENCHMARK_H
+#define TRACEBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+// Cost of TRACE_SCOPE with tracing off and on, and the trace file it produces
+class TraceBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scopeDisabled(); // A span while tracing is off: one atomic load
+    void scopeEnabled();  // A span while tracing is on: two clock reads and a buffer append
+    void traceFile();     // stop() writes Chrome trace-event JSON with the recorded spans
+
+private:
+    QTemporaryDir directory; // Holds the trace files
+};
+
+#endif
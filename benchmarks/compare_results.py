@@ -0,0 +1,55 @@
+# File: benchmarks/compare_results.py
+# Compares two result directories written by "aks_benchmarks -results <dir>" and flags regressions
+import argparse
+import glob
+import os
+import sys
+import xml.etree.ElementTree as ElementTree
+
+# Metrics where a larger value is better; everything else (times, ticks, events) is a cost
+HIGHER_IS_BETTER = {'FramesPerSecond', 'BitsPerSecond', 'BytesPerSecond'}
+
+
+def load_results(directory):
+    """Map (class, function, tag, metric) to the per-iteration value for every result file in a directory"""
+    results = {}
+    for path in sorted(glob.glob(os.path.join(directory, '*.xml'))):
+        root = ElementTree.parse(path).getroot()
+        class_name = root.get('name', os.path.splitext(os.path.basename(path))[0])
+        for function in root.iter('TestFunction'):
+            for result in function.iter('BenchmarkResult'):
+                key = (class_name, function.get('name'), result.get('tag', ''), result.get('metric'))
+                results[key] = float(result.get('value'))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two aks_benchmarks result directories")
+    parser.add_argument('baseline', help="results of the reference build")
+    parser.add_argument('current', help="results of the build under test")
+    parser.add_argument('--threshold', type=float, default=10.0, help="percentage change reported as a regression")
+    args = parser.parse_args()
+
+    baseline = load_results(args.baseline)
+    current = load_results(args.current)
+    regressions = 0
+    print(f"{'benchmark':<60} {'baseline':>14} {'current':>14} {'change':>9}")
+    for key in sorted(baseline.keys() | current.keys()):
+        class_name, function, tag, metric = key
+        name = f"{class_name}::{function}" + (f"[{tag}]" if tag else "")
+        if key not in baseline or key not in current:
+            print(f"{name:<60} {'only in ' + ('current' if key in current else 'baseline'):>39}")
+            continue
+        old, new = baseline[key], current[key]
+        change = (new - old) / old * 100.0 if old else 0.0
+        worse = -change if metric in HIGHER_IS_BETTER else change
+        flag = "  REGRESSION" if worse > args.threshold else ""
+        regressions += 1 if flag else 0
+        print(f"{name:<60} {old:>14.6g} {new:>14.6g} {change:>+8.1f}%{flag}")
+
+    print(f"{regressions} regression(s) above {args.threshold:g}%")
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,103 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QtTest>
+#include "AKSServiceBenchmark.h"
+#include "BinaryLogBenchmark.h"
+#include "CoreBenchmark.h"
+#include "EventBusBenchmark.h"
+#include "LinkStatisticsBenchmark.h"
+#include "LivenessBenchmark.h"
+#include "LogArchiverBenchmark.h"
+#include "LogLevelGuard.h"
+#include "LoggerBenchmark.h"
+#include "MetricsBenchmark.h"
+#include "NetworkConfigBenchmark.h"
+#include "ProtocolBenchmark.h"
+#include "ReplayBenchmark.h"
+#include "StartupTimelineBenchmark.h"
+#include "TelemetryHistoryBenchmark.h"
+#include "TraceBenchmark.h"
+
+namespace
+{
+    // Run one benchmark class. With a results directory, its results are also written to
+    // <dir>/<class>.xml in QtTest's XML format, which compare_results.py reads.
+    int runBenchmark(QObject *benchmark, const QStringList &arguments, const QString &resultsDirectory)
+    {
+        QStringList classArguments = arguments;
+        if (!resultsDirectory.isEmpty())
+        {
+            const QString name = benchmark->metaObject()->className();
+            classArguments << "-o" << QDir(resultsDirectory).filePath(name + ".xml") + ",xml"
+                           << "-o" << "-,txt"; // Keep the console output
+        }
+        return QTest::qExec(benchmark, classArguments);
+    }
+}
+
+// Runs every benchmark class; QtTest options (e.g. -iterations 1000) are passed through.
+// "-results <dir>" additionally writes one XML result file per class into <dir>.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList arguments = app.arguments();
+    QString resultsDirectory;
+    const int resultsIndex = arguments.indexOf("-results");
+    if (resultsIndex > 0 && resultsIndex + 1 < arguments.size())
+    {
+        resultsDirectory = arguments.at(resultsIndex + 1);
+        arguments.erase(arguments.begin() + resultsIndex, arguments.begin() + resultsIndex + 2);
+        QDir().mkpath(resultsDirectory);
+    }
+
+    const LogLevelGuard quietLogger(Logger::Warning); // Log calls are measured by LoggerBenchmark alone
+    int status = 0;
+
+    ProtocolBenchmark protocolBenchmark;
+    status |= runBenchmark(&protocolBenchmark, arguments, resultsDirectory);
+
+    LivenessBenchmark livenessBenchmark;
+    status |= runBenchmark(&livenessBenchmark, arguments, resultsDirectory);
+
+    LinkStatisticsBenchmark linkStatisticsBenchmark;
+    status |= runBenchmark(&linkStatisticsBenchmark, arguments, resultsDirectory);
+
+    LogArchiverBenchmark logArchiverBenchmark;
+    status |= runBenchmark(&logArchiverBenchmark, arguments, resultsDirectory);
+
+    LoggerBenchmark loggerBenchmark;
+    status |= runBenchmark(&loggerBenchmark, arguments, resultsDirectory);
+
+    BinaryLogBenchmark binaryLogBenchmark;
+    status |= runBenchmark(&binaryLogBenchmark, arguments, resultsDirectory);
+
+    MetricsBenchmark metricsBenchmark;
+    status |= runBenchmark(&metricsBenchmark, arguments, resultsDirectory);
+
+    NetworkConfigBenchmark networkConfigBenchmark;
+    status |= runBenchmark(&networkConfigBenchmark, arguments, resultsDirectory);
+
+    CoreBenchmark coreBenchmark;
+    status |= runBenchmark(&coreBenchmark, arguments, resultsDirectory);
+
+    EventBusBenchmark eventBusBenchmark;
+    status |= runBenchmark(&eventBusBenchmark, arguments, resultsDirectory);
+
+    ReplayBenchmark replayBenchmark;
+    status |= runBenchmark(&replayBenchmark, arguments, resultsDirectory);
+
+    TelemetryHistoryBenchmark telemetryHistoryBenchmark;
+    status |= runBenchmark(&telemetryHistoryBenchmark, arguments, resultsDirectory);
+
+    StartupTimelineBenchmark startupTimelineBenchmark;
+    status |= runBenchmark(&startupTimelineBenchmark, arguments, resultsDirectory);
+
+    TraceBenchmark traceBenchmark;
+    status |= runBenchmark(&traceBenchmark, arguments, resultsDirectory);
+
+    AKSServiceBenchmark serviceBenchmark;
+    status |= runBenchmark(&serviceBenchmark, arguments, resultsDirectory);
+
+    return status;
+}
@@ -0,0 +1,474 @@
+#include "AKSService.h"
+#include <QCoreApplication>
+#include <cmath>
+#include "GlobalConstants.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "NumberFormat.h"
+
+// Constructor for AKSService
+AKSService::AKSService(QObject *parent, MonotonicClock *clock)
+    : QObject(parent), core(new AKSCore(this, clock)), configReader(new ConfigReader(this)),
+      platformInfoCoalescer(new PlatformInfoCoalescer(clock ? clock : MonotonicClock::system(), GlobalConstants::IPC_PLATFORM_EVENT_INTERVAL_MS, this)),
+      server(new QLocalServer(this)), replayer(nullptr), timeline(nullptr), ansConnected(false), launcherConnected(false), missiles(4),
+      hasPlatformInfo(false), collectingError(false)
+{
+    platformInfo[0] = platformInfo[1] = platformInfo[2] = 0.0;
+
+    // Cache what the core reports so queries are answered without touching it
+    // The core's audit log records state changes, so nothing is logged here
+    EventBus *bus = core->eventBus();
+    bus->subscribe<Events::CommunicationStatus>(this, EventBus::Direct, [this](const Events::CommunicationStatus &event)
+                                                { onCommunicationStatus(event); });
+    bus->subscribe<Events::MissileStatus>(this, EventBus::Direct, [this](const Events::MissileStatus &event)
+                                          { onMissileStatus(event); });
+    bus->subscribe<Events::PlatformInfo>(this, EventBus::Direct, [this](const Events::PlatformInfo &event)
+                                         { onPlatformInfo(event); });
+    connect(core, &AKSCore::errorOccurred, this, &AKSService::onErrorOccurred);
+
+    // Subscribers get platform info paced like the GUI, however fast ANS sends
+    connect(platformInfoCoalescer, &PlatformInfoCoalescer::platformInfoReady, this, &AKSService::onPlatformInfoReady);
+
+    // Edits of the configuration file are applied while running
+    connect(configReader, &ConfigReader::missileConfigChanged, this, &AKSService::onMissileConfigChanged);
+    connect(configReader, &ConfigReader::missileConfigReloadFailed, this, &AKSService::onMissileConfigReloadFailed);
+
+    connect(server, &QLocalServer::newConnection, this, &AKSService::onNewConnection);
+}
+
+// Destructor for AKSService
+AKSService::~AKSService()
+{
+    LOG_INFO("AKS Service shutting down");
+    server->close();
+    core->stop(); // Stop the core functionality
+}
+
+// Load the configuration, start the core and the IPC server
+bool AKSService::start(const QString &configPath, const QString &serverName)
+{
+    LOG_INFO("AKS Service starting");
+    if (timeline)
+    {
+        timeline->watch(core->getCommunicationManager()); // Time the first heartbeat of each peer
+    }
+    {
+        StartupTimeline::Phase phase(timeline, "config");
+        loadMissileConfig(configPath);
+    }
+    {
+        StartupTimeline::Phase phase(timeline, "bind");
+        core->start(); // Bind and send the first heartbeats before anything else
+    }
+    {
+        StartupTimeline::Phase phase(timeline, "ipc");
+        if (!listen(serverName))
+        {
+            return false;
+        }
+    }
+    LOG_INFO(QString("AKS Service started, control socket %1").arg(server->fullServerName()));
+    return true;
+}
+
+// Load the configuration, start the core on a capture and the IPC server
+bool AKSService::startReplay(const QString &configPath, const QString &serverName, ManualClock *clock, const QString &capturePath, double speed)
+{
+    LOG_INFO("AKS Service starting in replay mode");
+    replayer = new DatagramReplayer(core->getCommunicationManager(), clock, this);
+    connect(replayer, &DatagramReplayer::finished, this, &AKSService::onReplayFinished);
+    if (!replayer->open(capturePath)) // Moves the clock to the capture, before any timer is armed
+    {
+        return false;
+    }
+    loadMissileConfig(configPath);
+    if (!listen(serverName))
+    {
+        return false;
+    }
+
+    core->startReplay(); // Start the core functionality without the network
+    replayTimer.start();
+    replayer->start(speed);
+    LOG_INFO(QString("AKS Service replaying %1, control socket %2").arg(capturePath, server->fullServerName()));
+    return true;
+}
+
+// Record every datagram the core receives and sends
+bool AKSService::startCapture(const QString &capturePath)
+{
+    return core->getCommunicationManager()->startCapture(capturePath);
+}
+
+// Bind and peer endpoints of the core
+void AKSService::setNetworkConfig(const NetworkConfig &config)
+{
+    core->getCommunicationManager()->setNetworkConfig(config);
+}
+
+// Record the startup phases and the first heartbeats in 'timeline'
+void AKSService::setStartupTimeline(StartupTimeline *timeline)
+{
+    this->timeline = timeline;
+}
+
+// Open the IPC server, unless another instance is serving 'serverName'
+bool AKSService::listen(const QString &serverName)
+{
+    // A socket that still answers belongs to a live instance; only a stale one may be removed
+    QLocalSocket probe;
+    probe.connectToServer(serverName);
+    if (probe.waitForConnected(GlobalConstants::IPC_PROBE_TIMEOUT_MS))
+    {
+        LOG_ERROR(QString("AKSService: Another instance is already listening on %1").arg(serverName));
+        return false;
+    }
+    QLocalServer::removeServer(serverName); // Clean up a socket left behind by a crashed instance
+
+    server->setSocketOptions(QLocalServer::UserAccessOption); // LAUNCH and POWER only from the user running the service
+    if (!server->listen(serverName))
+    {
+        LOG_ERROR(QString("AKSService: Failed to listen on %1: %2").arg(serverName, server->errorString()));
+        return false;
+    }
+    return true;
+}
+
+// Log how the replay went; the service keeps running so the final state can be queried
+void AKSService::onReplayFinished()
+{
+    const qint64 elapsedMs = qMax<qint64>(replayTimer.elapsed(), 1);
+    const DatagramReplayer::Stats &stats = replayer->stats();
+    LOG_INFO(QString("AKSService: Replay finished, %1 datagrams of %2 s in %3 ms (%4 datagrams/s)")
+                 .arg(stats.replayed)
+                 .arg(double(replayer->durationNs()) / 1e9, 0, 'f', 3)
+                 .arg(elapsedMs)
+                 .arg(stats.replayed * 1000 / quint64(elapsedMs)));
+}
+
+// Feed the configuration file into AKSCore
+void AKSService::loadMissileConfig(const QString &configPath)
+{
+    if (!configReader->loadMissileConfig(configPath))
+    {
+        LOG_ERROR("Failed to load missile configuration: " + configReader->getLastError()); // The core runs without missiles
+        return;
+    }
+    for (const MissileConfig &config : configReader->getMissileConfigs())
+    {
+        core->updateMissileConfig(config.index, config.type, config.healthy); // Update core with missile configuration
+    }
+    LOG_INFO("Missile configuration loaded successfully");
+    configReader->watchMissileConfig(configPath); // Apply later edits of the file while running
+}
+
+// Apply the missiles that changed in the file
+void AKSService::onMissileConfigChanged(const QVector<MissileConfig> &changed)
+{
+    for (const MissileConfig &config : changed)
+    {
+        core->updateMissileConfig(config.index, config.type, config.healthy); // Subscribers follow through the missile status event
+    }
+    LOG_INFO(QString("AKSService: Missile configuration reloaded, %1 missile(s) changed").arg(changed.size()));
+}
+
+// Keep the previous configuration
+void AKSService::onMissileConfigReloadFailed(const QString &error)
+{
+    LOG_WARNING("AKSService: Missile configuration reload ignored: " + error);
+}
+
+// Accept IPC clients
+void AKSService::onNewConnection()
+{
+    while (QLocalSocket *client = server->nextPendingConnection())
+    {
+        connect(client, &QLocalSocket::readyRead, this, &AKSService::onClientReadable);
+        connect(client, &QLocalSocket::disconnected, this, &AKSService::onClientDisconnected);
+    }
+}
+
+// Execute the complete command lines a client sent
+void AKSService::onClientReadable()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client)
+    {
+        return;
+    }
+    while (client->canReadLine())
+    {
+        const QString line = QString::fromUtf8(client->readLine()).trimmed();
+        if (!line.isEmpty())
+        {
+            executeCommand(client, line);
+        }
+        if (client->state() != QLocalSocket::ConnectedState)
+        {
+            return; // QUIT closed it
+        }
+    }
+}
+
+// Forget a client that went away
+void AKSService::onClientDisconnected()
+{
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    if (!client)
+    {
+        return;
+    }
+    subscribers.removeAll(client);
+    client->deleteLater();
+}
+
+// Execute one command line
+void AKSService::executeCommand(QLocalSocket *client, const QString &line)
+{
+    QStringList arguments = line.simplified().split(' '); // Any run of whitespace separates arguments
+    const QString command = arguments.takeFirst().toUpper();
+
+    if (command == "STATUS")
+    {
+        sendLine(client, QByteArray("STATUS ans=") + (ansConnected ? "up" : "down") +
+                             " launcher=" + (launcherConnected ? "up" : "down"));
+    }
+    else if (command == "MISSILES")
+    {
+        for (int i = 0; i < missiles.size(); ++i)
+        {
+            if (missiles[i].known)
+            {
+                sendLine(client, "MISSILE " + missileLine(i, missiles[i]));
+            }
+        }
+        sendLine(client, "OK");
+    }
+    else if (command == "PLATFORM")
+    {
+        sendLine(client, hasPlatformInfo ? "PLATFORM " + platformLine(platformInfo[0], platformInfo[1], platformInfo[2])
+                                         : QByteArray("ERR no platform info"));
+    }
+    else if (command == "HISTORY")
+    {
+        sendHistory(client, arguments);
+    }
+    else if (command == "LINK")
+    {
+        CommunicationManager *manager = core->getCommunicationManager();
+        sendLine(client, "LINK " + linkLine("ANS", manager->ansLinkStatistics()));
+        sendLine(client, "LINK " + linkLine("Launcher", manager->launcherLinkStatistics()));
+        sendLine(client, "OK");
+    }
+    else if (command == "METRICS")
+    {
+        QByteArray text;
+        Metrics::Registry::instance().writePrometheusText(text);
+        client->write(text); // Already one metric per line
+        sendLine(client, "OK");
+    }
+    else if (command == "POWER" || command == "LAUNCH" || command == "TARGET")
+    {
+        runCoreCommand(client, command, arguments);
+    }
+    else if (command == "SUBSCRIBE")
+    {
+        if (!subscribers.contains(client))
+        {
+            subscribers.append(client);
+        }
+        sendLine(client, "OK");
+    }
+    else if (command == "QUIT")
+    {
+        client->disconnectFromServer();
+    }
+    else if (command == "SHUTDOWN")
+    {
+        sendLine(client, "OK");
+        client->flush();
+        LOG_INFO("AKSService: Shutdown requested over IPC");
+        QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection); // After this reply is out
+    }
+    else
+    {
+        sendLine(client, "ERR unknown command");
+    }
+}
+
+// POWER, LAUNCH and TARGET: run the core slot and report the error it raised, if any
+void AKSService::runCoreCommand(QLocalSocket *client, const QString &command, const QStringList &arguments)
+{
+    commandError.clear();
+    collectingError = true; // AKSCore reports refusals synchronously through errorOccurred
+
+    if (command == "POWER")
+    {
+        bool ok = false;
+        int index = arguments.value(0).toInt(&ok);
+        if (arguments.size() == 1 && ok)
+        {
+            core->toggleMissilePower(index);
+        }
+        else
+        {
+            commandError = "usage: POWER <index>";
+        }
+    }
+    else if (command == "LAUNCH")
+    {
+        core->launchMissile();
+    }
+    else
+    {
+        double values[5];
+        bool ok = arguments.size() == 5;
+        for (int i = 0; ok && i < 5; ++i)
+        {
+            values[i] = arguments[i].toDouble(&ok);
+        }
+        if (ok)
+        {
+            core->updateTargetInfo(values[0], values[1], values[2], values[3], values[4]);
+        }
+        else
+        {
+            commandError = "usage: TARGET <lat> <lon> <alt> <speed> <distance>";
+        }
+    }
+
+    collectingError = false;
+    sendLine(client, commandError.isEmpty() ? QByteArray("OK") : "ERR " + commandError.toUtf8());
+}
+
+// Write one reply line
+void AKSService::sendLine(QLocalSocket *client, const QByteArray &line)
+{
+    client->write(line);
+    client->write("\n", 1);
+}
+
+// Write an event line to every subscriber
+void AKSService::broadcast(const QByteArray &event)
+{
+    for (QLocalSocket *subscriber : subscribers)
+    {
+        sendLine(subscriber, event);
+    }
+}
+
+// Communication status changed
+void AKSService::onCommunicationStatus(const Events::CommunicationStatus &event)
+{
+    ansConnected = event.ansConnected;
+    launcherConnected = event.launcherConnected;
+    broadcast(QByteArray("EVENT COMM ans=") + (ansConnected ? "up" : "down") + " launcher=" + (launcherConnected ? "up" : "down"));
+}
+
+// Missile status changed
+void AKSService::onMissileStatus(const Events::MissileStatus &event)
+{
+    if (event.index < 0 || event.index >= missiles.size())
+    {
+        return;
+    }
+    MissileStatus &status = missiles[event.index];
+    status.known = true;
+    status.type = event.typeName().trimmed();
+    status.healthy = event.healthy;
+    status.powered = event.powered;
+    status.fired = event.fired;
+    broadcast("EVENT MISSILE " + missileLine(event.index, status));
+}
+
+// Every platform position, kept for PLATFORM queries and paced for subscribers
+void AKSService::onPlatformInfo(const Events::PlatformInfo &event)
+{
+    hasPlatformInfo = true;
+    platformInfo[0] = event.latitude;
+    platformInfo[1] = event.longitude;
+    platformInfo[2] = event.altitude;
+    platformInfoCoalescer->submit(event.latitude, event.longitude, event.altitude);
+}
+
+// Paced platform positions for subscribers
+void AKSService::onPlatformInfoReady(double latitude, double longitude, double altitude)
+{
+    if (!subscribers.isEmpty())
+    {
+        broadcast("EVENT PLATFORM " + platformLine(latitude, longitude, altitude));
+    }
+}
+
+// Error raised by the core
+void AKSService::onErrorOccurred(const QString &message)
+{
+    if (collectingError && commandError.isEmpty())
+    {
+        commandError = message; // Becomes the reply to the running command
+    }
+    broadcast("EVENT ERROR " + message.toUtf8());
+}
+
+// Platform positions of the last seconds, timed relative to the newest one
+void AKSService::sendHistory(QLocalSocket *client, const QStringList &arguments)
+{
+    double seconds = 60.0;
+    if (!arguments.isEmpty())
+    {
+        bool ok = false;
+        seconds = arguments.first().toDouble(&ok);
+        if (!ok || !std::isfinite(seconds) || seconds <= 0) // toDouble() accepts "inf" and "nan"
+        {
+            sendLine(client, "ERR usage: HISTORY [seconds]");
+            return;
+        }
+        seconds = qMin(seconds, 1e9); // ~31 years reaches past any history and keeps the span below qint64's range
+    }
+
+    const TelemetryHistory &history = core->platformHistory();
+    TelemetryHistory::Sample newest;
+    if (history.newest(newest))
+    {
+        TelemetryHistory::Snapshot samples;
+        history.range(newest.timestampNs - qint64(seconds * 1e9), newest.timestampNs, samples);
+        QByteArray text;
+        for (int i = 0; i < samples.size(); ++i)
+        {
+            text += "SAMPLE " + QByteArray::number((samples.timestampsNs[i] - newest.timestampNs) / 1000000) + ' ' +
+                    platformLine(samples.latitudes[i], samples.longitudes[i], samples.altitudes[i]) + '\n';
+        }
+        client->write(text); // One write for up to TELEMETRY_HISTORY_SAMPLES lines
+    }
+    sendLine(client, "OK");
+}
+
+// "<index> <state> <type>"
+QByteArray AKSService::missileLine(int index, const MissileStatus &status)
+{
+    const char *state = status.fired ? "Fired" : (status.powered ? "Powered" : (status.healthy ? "Healthy" : "Unhealthy"));
+    return QByteArray::number(index) + ' ' + state + ' ' + status.type.toUtf8();
+}
+
+// "<lat> <lon> <alt>"
+QByteArray AKSService::platformLine(double latitude, double longitude, double altitude)
+{
+    char buffer[3 * NumberFormat::FIXED_BUFFER_SIZE];
+    int length = NumberFormat::formatFixed(latitude, 6, buffer, NumberFormat::FIXED_BUFFER_SIZE);
+    buffer[length++] = ' ';
+    length += NumberFormat::formatFixed(longitude, 6, buffer + length, NumberFormat::FIXED_BUFFER_SIZE);
+    buffer[length++] = ' ';
+    length += NumberFormat::formatFixed(altitude, 2, buffer + length, NumberFormat::FIXED_BUFFER_SIZE);
+    return QByteArray(buffer, length);
+}
+
+// "<peer> received=.. lost=.. reordered=.. jitter_us=.. rtt_us=.."
+QByteArray AKSService::linkLine(const char *peerName, const LinkStatistics::Snapshot &snapshot)
+{
+    return QByteArray(peerName) +
+           " received=" + QByteArray::number(snapshot.received) +
+           " lost=" + QByteArray::number(snapshot.lost) +
+           " reordered=" + QByteArray::number(snapshot.reordered) +
+           " jitter_us=" + QByteArray::number(snapshot.jitterNs / 1000) +
+           " rtt_us=" + QByteArray::number(snapshot.rttMeanNs / 1000);
+}
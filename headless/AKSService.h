@@ -0,0 +1,115 @@
+#ifndef AKSSERVICE_H
+#define AKSSERVICE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QVector>
+#include "AKSCore.h"
+#include "ConfigReader.h"
+#include "DatagramReplayer.h"
+#include "PlatformInfoCoalescer.h"
+#include "StartupTimeline.h"
+
+// Headless AKS: AKSCore and CommunicationManager on a QCoreApplication, controlled over a local socket.
+//
+// The IPC protocol is line based (UTF-8, one command or reply per '\n'):
+//   STATUS                        -> "STATUS ans=<up|down> launcher=<up|down>"
+//   MISSILES                      -> one "MISSILE <index> <Unhealthy|Healthy|Powered|Fired> <type>" per missile, then "OK"
+//   PLATFORM                      -> "PLATFORM <lat> <lon> <alt>", or "ERR no platform info" before the first one
+//   HISTORY [seconds]             -> one "SAMPLE <ms> <lat> <lon> <alt>" per position of the last 60 (or 'seconds')
+//                                    seconds, oldest first, <ms> relative to the newest (0 or less), then "OK"
+//   LINK                          -> one "LINK <ANS|Launcher> received=.. lost=.. reordered=.. jitter_us=.. rtt_us=.." per peer, then "OK"
+//   METRICS                       -> the runtime metrics in the Prometheus text format, then "OK"
+//   POWER <index>                 -> "OK", or "ERR <message>" if AKSCore refused
+//   LAUNCH                        -> "OK", or "ERR <message>"
+//   TARGET <lat> <lon> <alt> <speed> <distance> -> "OK", or "ERR <message>"
+//   SUBSCRIBE                     -> "OK", then "EVENT COMM ..", "EVENT MISSILE ..", "EVENT PLATFORM ..", "EVENT ERROR .." lines
+//   QUIT                          -> closes this connection
+//   SHUTDOWN                      -> "OK", then the service exits
+// Anything else is answered with "ERR unknown command".
+class AKSService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AKSService(QObject *parent = nullptr, MonotonicClock *clock = nullptr); // Constructor, the core runs on 'clock' (the steady clock if null)
+    ~AKSService();                                                                   // Destructor, stops the core
+
+    // Load the missile configuration, start the core and listen on 'serverName'; returns false if the IPC server cannot listen
+    bool start(const QString &configPath, const QString &serverName);
+
+    // As start(), but the core is fed from the capture 'capturePath' at 'speed' times its pace (0 or less: as fast
+    // as possible) instead of the network. The service must have been constructed on 'clock'.
+    bool startReplay(const QString &configPath, const QString &serverName, ManualClock *clock, const QString &capturePath, double speed);
+
+    // Record every datagram the core receives and sends to 'capturePath'; call before start()
+    bool startCapture(const QString &capturePath);
+
+    // Bind and peer endpoints of the core (see NetworkConfig); call before start()
+    void setNetworkConfig(const NetworkConfig &config);
+
+    // Record the startup phases and the first heartbeats in 'timeline'; call before start()
+    void setStartupTimeline(StartupTimeline *timeline);
+
+private slots:
+    void onNewConnection();  // Accept IPC clients
+    void onClientReadable(); // Execute the complete command lines a client sent
+    void onClientDisconnected();
+
+    // Core notifications, forwarded to subscribers
+    void onPlatformInfoReady(double latitude, double longitude, double altitude); // Paced positions for subscribers
+    void onErrorOccurred(const QString &message);
+    void onReplayFinished();                                            // Log how the replay went
+    void onMissileConfigChanged(const QVector<MissileConfig> &changed); // Apply the missiles that changed in the file
+    void onMissileConfigReloadFailed(const QString &error);             // Keep the previous configuration
+
+private:
+    // Last reported state of a missile
+    struct MissileStatus
+    {
+        bool known = false;   // Reported at least once
+        QString type;         // Missile type
+        bool healthy = false; // Health status
+        bool powered = false; // Power status
+        bool fired = false;   // Fired status
+    };
+
+    // Core events (see AKSCore::eventBus()), cached for queries and forwarded to subscribers
+    void onCommunicationStatus(const Events::CommunicationStatus &event);
+    void onMissileStatus(const Events::MissileStatus &event);
+    void onPlatformInfo(const Events::PlatformInfo &event);                                          // Every position
+
+    void loadMissileConfig(const QString &configPath);                                               // Feed the configuration file into AKSCore
+    bool listen(const QString &serverName);                                                          // Open the IPC server, unless another instance serves the name
+    void executeCommand(QLocalSocket *client, const QString &line);                                  // Execute one command line
+    void sendHistory(QLocalSocket *client, const QStringList &arguments);                            // Answer a HISTORY command
+    void runCoreCommand(QLocalSocket *client, const QString &command, const QStringList &arguments); // POWER, LAUNCH, TARGET
+    void sendLine(QLocalSocket *client, const QByteArray &line);                                     // Write one reply line
+    void broadcast(const QByteArray &event);                                                         // Write an event line to every subscriber
+
+    static QByteArray missileLine(int index, const MissileStatus &status);                      // "<index> <state> <type>"
+    static QByteArray platformLine(double latitude, double longitude, double altitude);         // "<lat> <lon> <alt>"
+    static QByteArray linkLine(const char *peerName, const LinkStatistics::Snapshot &snapshot); // "<peer> received=.. .."
+
+    AKSCore *core;                                // Core logic
+    ConfigReader *configReader;                   // Missile configuration
+    PlatformInfoCoalescer *platformInfoCoalescer; // Paces platform events to subscribers
+    QLocalServer *server;                         // IPC endpoint
+    DatagramReplayer *replayer;                   // Feeds the core in replay mode, null otherwise
+    StartupTimeline *timeline;                    // Startup phases, null if not recorded
+    QElapsedTimer replayTimer;                    // Real time the replay took
+    QList<QLocalSocket *> subscribers;            // Clients that asked for events
+
+    bool ansConnected;               // Last reported ANS status
+    bool launcherConnected;          // Last reported Launcher status
+    QVector<MissileStatus> missiles; // Last reported missile states
+    bool hasPlatformInfo;            // A platform position has been received
+    double platformInfo[3];          // Latest latitude, longitude, altitude
+    QString commandError;            // Error raised by AKSCore while a command runs
+    bool collectingError;            // A POWER/LAUNCH/TARGET command is running
+};
+
+#endif
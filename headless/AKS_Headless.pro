@@ -0,0 +1,19 @@
+QT -= gui
+QT += core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = aks_headless
+
+# Release builds compile out LOG_DEBUG calls; uncomment to keep them
+# DEFINES += AKS_LOG_COMPILE_LEVEL=0
+
+include(../src/core.pri)
+
+SOURCES += \
+    main.cpp \
+    AKSService.cpp
+
+HEADERS += \
+    AKSService.h
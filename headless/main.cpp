@@ -0,0 +1,117 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include "AKSService.h"
+#include "Logger.h"
+#include "MonotonicClock.h"
+#include "NetworkConfig.h"
+#include "StartupTimeline.h"
+#include "Trace.h"
+
+// Headless AKS: the core and its subsystem links without QtWidgets or a display.
+// Usage: aks_headless [--config <missiles.conf>] [--ipc <name>] [--capture <file> | --replay <file> [--speed <x|max>]]
+//                     [--trace <file>] [--bind <addr:port>] [--ans <addr:port>] [--launcher <addr:port>]
+//                     [--multicast <group[:port]>]
+// Control and status go over the local socket <name> (default "aks-core", or AKS_IPC_NAME); see AKSService.h.
+int main(int argc, char *argv[])
+{
+    const qint64 startNs = MonotonicClock::system()->nowNs(); // Origin of the startup timeline
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("aks_headless");
+    StartupTimeline timeline(MonotonicClock::system(), startNs);
+    timeline.recordPhase("application", startNs, MonotonicClock::system()->nowNs());
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("AKS core service without a GUI");
+    parser.addHelpOption();
+    QCommandLineOption configOption("config", "Missile configuration file.", "file",
+                                    QCoreApplication::applicationDirPath() + QDir::separator() + "config" + QDir::separator() + "missiles.conf");
+    QCommandLineOption ipcOption("ipc", "Name of the local control socket.", "name",
+                                 qEnvironmentVariableIsEmpty("AKS_IPC_NAME") ? QString("aks-core") : qEnvironmentVariable("AKS_IPC_NAME"));
+    QCommandLineOption captureOption("capture", "Record every datagram received and sent to a capture file.", "file");
+    QCommandLineOption replayOption("replay", "Feed a capture file to the core instead of the network.", "file");
+    QCommandLineOption speedOption("speed", "Replay speed: a factor of the captured pace, or \"max\".", "x|max", "1");
+    QCommandLineOption traceOption("trace", "Write trace spans as Chrome trace-event JSON on exit.", "file",
+                                   qEnvironmentVariable("AKS_TRACE"));
+    QCommandLineOption bindOption("bind", "Local endpoint of the AKS socket (default 127.0.0.1:5000, or AKS_BIND).", "addr:port");
+    QCommandLineOption ansOption("ans", "ANS endpoint (default 127.0.0.1:5001, or AKS_ANS_ENDPOINT).", "addr:port");
+    QCommandLineOption launcherOption("launcher", "Launcher endpoint (default 127.0.0.1:5002, or AKS_LAUNCHER_ENDPOINT).", "addr:port");
+    QCommandLineOption multicastOption("multicast", "Send heartbeats once to this multicast group (or AKS_MULTICAST_GROUP).",
+                                       "group[:port]");
+    parser.addOption(configOption);
+    parser.addOption(ipcOption);
+    parser.addOption(captureOption);
+    parser.addOption(replayOption);
+    parser.addOption(speedOption);
+    parser.addOption(traceOption);
+    parser.addOption(bindOption);
+    parser.addOption(ansOption);
+    parser.addOption(launcherOption);
+    parser.addOption(multicastOption);
+    parser.process(app);
+
+    // Endpoints on the command line override the environment
+    NetworkConfig network = NetworkConfig::fromEnvironment();
+    auto applyEndpoint = [&parser](const QCommandLineOption &option, NetworkConfig::Endpoint &endpoint)
+    {
+        if (parser.isSet(option) && !NetworkConfig::parseEndpoint(parser.value(option), endpoint))
+        {
+            parser.showHelp(1);
+        }
+    };
+    applyEndpoint(bindOption, network.bind);
+    applyEndpoint(ansOption, network.ans);
+    applyEndpoint(launcherOption, network.launcher);
+    applyEndpoint(multicastOption, network.multicastGroup);
+    QString networkError;
+    if (!network.validate(&networkError))
+    {
+        qCritical("aks_headless: %s", qPrintable(networkError));
+        return 1;
+    }
+
+    if (!parser.value(traceOption).isEmpty())
+    {
+        Trace::start(parser.value(traceOption));
+    }
+
+    const bool replaying = parser.isSet(replayOption);
+    double speed = 0.0; // As fast as possible
+    if (parser.value(speedOption) != "max")
+    {
+        bool ok = false;
+        speed = parser.value(speedOption).toDouble(&ok);
+        if (!ok || speed <= 0.0)
+        {
+            parser.showHelp(1);
+        }
+    }
+
+    int result = 1;
+    {
+        ManualClock replayClock;                                          // Virtual time of a replay, driven by the capture
+        AKSService service(nullptr, replaying ? &replayClock : nullptr); // The steady clock when on the network
+        service.setNetworkConfig(network);
+        service.setStartupTimeline(&timeline);
+        bool started = false;
+        if (replaying)
+        {
+            started = service.startReplay(parser.value(configOption), parser.value(ipcOption), &replayClock,
+                                          parser.value(replayOption), speed);
+        }
+        else
+        {
+            started = (!parser.isSet(captureOption) || service.startCapture(parser.value(captureOption))) &&
+                      service.start(parser.value(configOption), parser.value(ipcOption));
+        }
+        if (started)
+        {
+            result = app.exec(); // Runs until SHUTDOWN arrives over IPC
+        }
+    }
+
+    // Write the trace and any queued log entries before the process exits
+    Trace::stop();
+    Logger::instance().shutdown();
+    return result;
+}
@@ -0,0 +1,132 @@
+# File: simulators/AKSProtocol.py
+# Encoding and decoding of AKS messages for the simulators (text and binary forms, see src/Protocol.h)
+import socket
+import struct
+import time
+
+BINARY_MAGIC = 0x4BA5  # First two bytes of every binary message (A5 4B on the wire)
+BINARY_VERSION = 1  # Binary protocol version
+HEADER = struct.Struct('<HBBIq')  # Magic, version, type, sequence, timestamp ns
+PLATFORM_INFO_PAYLOAD = struct.Struct('<ddd')  # Latitude, longitude, altitude
+HEARTBEAT_ECHO = struct.Struct('<Iqq')  # Echoed sequence, echoed timestamp ns, hold time ns
+
+AKS_PORT = 5000  # Default AKS port (NetworkConfig::DEFAULT_AKS_PORT)
+MULTICAST_PORT = 5003  # Default port of the AKS heartbeat group
+
+# Message type codes (Protocol::MessageType)
+AKS_HEARTBEAT = 1
+ANS_HEARTBEAT = 2
+LAUNCHER_HEARTBEAT = 3
+PLATFORM_INFO = 4
+
+# Wire modes of the simulators
+LEGACY = 'legacy'  # Bare text heartbeats, no sequence numbers
+TEXT = 'text'  # Text heartbeats with sequence, timestamp and echo fields
+BINARY = 'binary'  # Binary messages
+
+# Text form of the heartbeats
+HEARTBEAT_TEXT = {
+    AKS_HEARTBEAT: "AKS_HEARTBEAT",
+    ANS_HEARTBEAT: "ANS_HEARTBEAT",
+    LAUNCHER_HEARTBEAT: "LAUNCHER_HEARTBEAT",
+}
+
+
+class Heartbeat:
+    """A received heartbeat; sequence and timestamp are None for legacy text heartbeats"""
+
+    def __init__(self, message_type, sequence=None, timestamp_ns=None):
+        self.message_type = message_type
+        self.sequence = sequence
+        self.timestamp_ns = timestamp_ns
+        self.received_ns = time.monotonic_ns()
+
+    def echo(self):
+        """Echo fields for our next heartbeat: (sequence, timestamp, hold time), or None"""
+        if self.sequence is None:
+            return None
+        return self.sequence, self.timestamp_ns, time.monotonic_ns() - self.received_ns
+
+
+def encode_heartbeat(message_type, mode, sequence, echo=None):
+    """Encode a heartbeat, optionally echoing the last AKS heartbeat"""
+    if mode == BINARY:
+        data = HEADER.pack(BINARY_MAGIC, BINARY_VERSION, message_type, sequence & 0xFFFFFFFF, time.monotonic_ns())
+        if echo is not None:
+            data += HEARTBEAT_ECHO.pack(echo[0] & 0xFFFFFFFF, echo[1], echo[2])
+        return data
+    text = HEARTBEAT_TEXT[message_type]
+    if mode == TEXT:
+        text += ",{},{}".format(sequence & 0xFFFFFFFF, time.monotonic_ns())
+        if echo is not None:
+            text += ",{},{},{}".format(*echo)
+    return text.encode()
+
+
+def encode_platform_info(latitude, longitude, altitude, mode, sequence):
+    """Encode platform info in the requested form"""
+    if mode == BINARY:
+        header = HEADER.pack(BINARY_MAGIC, BINARY_VERSION, PLATFORM_INFO, sequence & 0xFFFFFFFF, time.monotonic_ns())
+        return header + PLATFORM_INFO_PAYLOAD.pack(latitude, longitude, altitude)
+    return "PLATFORM_INFO,{:.6f},{:.6f},{:.2f}".format(latitude, longitude, altitude).encode()
+
+
+def decode_heartbeat(data):
+    """Decode a received heartbeat in any form; returns None for anything else"""
+    if len(data) >= HEADER.size:
+        magic, version, message_type, sequence, timestamp_ns = HEADER.unpack_from(data)
+        if magic == BINARY_MAGIC:
+            if version != BINARY_VERSION or message_type not in HEARTBEAT_TEXT:
+                return None
+            return Heartbeat(message_type, sequence, timestamp_ns)
+    text = data.decode(errors='replace')
+    fields = text.split(',')
+    for message_type, name in HEARTBEAT_TEXT.items():
+        if fields[0] != name:
+            continue
+        if len(fields) == 1:
+            return Heartbeat(message_type)
+        try:
+            return Heartbeat(message_type, int(fields[1]), int(fields[2]))
+        except (IndexError, ValueError):
+            return None
+    return None
+
+
+def describe(data):
+    """Printable form of a received datagram"""
+    if len(data) >= HEADER.size and HEADER.unpack_from(data)[0] == BINARY_MAGIC:
+        _, _, message_type, sequence, _ = HEADER.unpack_from(data)
+        return f"binary type {message_type} seq {sequence}"
+    return data.decode(errors='replace')
+
+
+def add_endpoint_arguments(parser, port):
+    """Add the --bind, --aks and --multicast options shared by the simulators"""
+    parser.add_argument('--bind', default=f"127.0.0.1:{port}", help=f"local address[:port] (default 127.0.0.1:{port})")
+    parser.add_argument('--aks', default=f"127.0.0.1:{AKS_PORT}", help=f"AKS address[:port] (default 127.0.0.1:{AKS_PORT})")
+    parser.add_argument('--multicast', help=f"receive AKS heartbeats from this multicast group[:port] (default port {MULTICAST_PORT})")
+
+
+def parse_endpoint(text, default_port):
+    """Split "address[:port]" into an (address, port) tuple"""
+    host, _, port = text.rpartition(':') if ':' in text else (text, '', '')
+    return (host or '127.0.0.1', int(port) if port else default_port)
+
+
+def open_sockets(args, port):
+    """Socket bound to --bind that everything is sent from, and the socket AKS heartbeats arrive on"""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(parse_endpoint(args.bind, port))
+    if not args.multicast:
+        return sock, sock
+
+    # Every simulator on this host binds the group port, so the address is shared
+    group, group_port = parse_endpoint(args.multicast, MULTICAST_PORT)
+    listener = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listener.bind(('', group_port))
+    interface = sock.getsockname()[0]  # Join on the interface we talk to the AKS through
+    membership = struct.pack('4s4s', socket.inet_aton(socket.gethostbyname(group)), socket.inet_aton(interface))
+    listener.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+    return sock, listener
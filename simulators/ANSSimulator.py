@@ -1,73 +1,91 @@
-import socket
-import time
-import random
-from datetime import datetime
-
-AKS_PORT = 5000
-ANS_PORT = 5001
-
-# Create UDP socket
-sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
-sock.bind(('localhost', ANS_PORT))  # Bind the socket to the ANS_PORT
-
-# Log the start of the simulator
-print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} ANS Simulator running on port {ANS_PORT}")
-
-latitude = 0.0
-longitude = 0.0
-altitude = 10.0
-
-# Initialize connection status variables
-aks_heartbeat_received = False
-connected = False
-missed_heartbeats = 0
-
-# Log waiting for AKS heartbeat
-print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Waiting for initial AKS heartbeat...")
-
-while True:
-    try:
-        # Check for incoming messages (non-blocking)
-        sock.setblocking(False)
-        try:
-            data, addr = sock.recvfrom(1024)  # Receive data from the socket
-            message = data.decode()  # Decode the received message
-            print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Received from AKS: {message}")
-            if message == "AKS_HEARTBEAT":  # Check for AKS heartbeat message
-                if not connected:
-                    print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Connected to AKS")
-                    connected = True  # Update connection status
-                aks_heartbeat_received = True  # Heartbeat received
-                missed_heartbeats = 0  # Reset missed heartbeats counter
-        except socket.error:
-            if connected:
-                missed_heartbeats += 1  # Increment missed heartbeats if connected
-        sock.setblocking(True)  # Set socket to blocking mode
-
-        if connected:
-            if aks_heartbeat_received:
-                # Send heartbeat to AKS
-                sock.sendto(b"ANS_HEARTBEAT", ('localhost', AKS_PORT))
-
-                # Send platform info to AKS
-                platform_info = "PLATFORM_INFO,{:.6f},{:.6f},{:.2f}".format(latitude, longitude, altitude).encode()
-                sock.sendto(platform_info, ('localhost', AKS_PORT))
-
-                # Update position
-                latitude = (latitude + 1) % 91
-                longitude = (longitude + 1) % 181
-                altitude += random.uniform(-4, 10)
-
-            # Check for lost connection
-            if missed_heartbeats >= 5:
-                print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Lost connection with AKS")
-                connected = False
-                aks_heartbeat_received = False
-
-        time.sleep(1)  # Sleep for a second before the next iteration
-    except KeyboardInterrupt:
-        # Handle shutdown gracefully
-        print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} ANS Simulator shutting down")
-        break
-
+import argparse
+import socket
+import time
+import random
+from datetime import datetime
+import AKSProtocol
+
+ANS_PORT = 5001
+
+# Parse command line options
+parser = argparse.ArgumentParser(description="ANS Simulator")
+parser.add_argument('--binary', action='store_true', help="send binary protocol messages instead of text")
+parser.add_argument('--legacy', action='store_true', help="send bare text heartbeats without sequence numbers")
+AKSProtocol.add_endpoint_arguments(parser, ANS_PORT)
+args = parser.parse_args()
+aks_address = AKSProtocol.parse_endpoint(args.aks, AKSProtocol.AKS_PORT)  # Where everything is sent
+mode = AKSProtocol.BINARY if args.binary else AKSProtocol.LEGACY if args.legacy else AKSProtocol.TEXT
+heartbeat_sequence = 0  # Sequence number of the next heartbeat (the AKS counts heartbeat loss from these)
+platform_sequence = 0  # Sequence number of the next binary PLATFORM_INFO (text carries none)
+last_aks_heartbeat = None  # Last AKS heartbeat received, echoed back for the AKS round-trip measurement
+
+# Create the UDP socket, and the multicast group member if AKS heartbeats go to a group
+sock, heartbeat_sock = AKSProtocol.open_sockets(args, ANS_PORT)
+
+# Log the start of the simulator
+print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} ANS Simulator running on {args.bind}")
+
+latitude = 0.0
+longitude = 0.0
+altitude = 10.0
+
+# Initialize connection status variables
+aks_heartbeat_received = False
+connected = False
+missed_heartbeats = 0
+
+# Log waiting for AKS heartbeat
+print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Waiting for initial AKS heartbeat...")
+
+while True:
+    try:
+        # Check for incoming messages (non-blocking)
+        heartbeat_sock.setblocking(False)
+        try:
+            data, addr = heartbeat_sock.recvfrom(1024)  # Receive data from the socket
+            heartbeat = AKSProtocol.decode_heartbeat(data)  # Decode the received message (text or binary)
+            print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Received from AKS: {AKSProtocol.describe(data)}")
+            if heartbeat is not None and heartbeat.message_type == AKSProtocol.AKS_HEARTBEAT:  # Check for AKS heartbeat message
+                if not connected:
+                    print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Connected to AKS")
+                    connected = True  # Update connection status
+                last_aks_heartbeat = heartbeat  # Remember it for the echo
+                aks_heartbeat_received = True  # Heartbeat received
+                missed_heartbeats = 0  # Reset missed heartbeats counter
+        except socket.error:
+            if connected:
+                missed_heartbeats += 1  # Increment missed heartbeats if connected
+        heartbeat_sock.setblocking(True)  # Set socket to blocking mode
+
+        if connected:
+            if aks_heartbeat_received:
+                # Send heartbeat to AKS
+                echo = last_aks_heartbeat.echo() if mode != AKSProtocol.LEGACY else None
+                sock.sendto(AKSProtocol.encode_heartbeat(AKSProtocol.ANS_HEARTBEAT, mode, heartbeat_sequence, echo), aks_address)
+                heartbeat_sequence += 1
+
+                # Send platform info to AKS
+                platform_info = AKSProtocol.encode_platform_info(latitude, longitude, altitude, mode, platform_sequence)
+                sock.sendto(platform_info, aks_address)
+                if mode == AKSProtocol.BINARY:
+                    platform_sequence += 1
+
+                # Update position
+                latitude = (latitude + 1) % 91
+                longitude = (longitude + 1) % 181
+                altitude += random.uniform(-4, 10)
+
+            # Check for lost connection
+            if missed_heartbeats >= 5:
+                print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Lost connection with AKS")
+                connected = False
+                aks_heartbeat_received = False
+
+        time.sleep(1)  # Sleep for a second before the next iteration
+    except KeyboardInterrupt:
+        # Handle shutdown gracefully
+        print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} ANS Simulator shutting down")
+        break
+
+heartbeat_sock.close()
 sock.close()  # Close the socket when done
\ No newline at end of file
@@ -1,55 +1,70 @@
-# File: simulators/LauncherSimulator.py
-import socket
-import time
-from datetime import datetime
-
-AKS_PORT = 5000  # Port for AKS communication
-LAUNCHER_PORT = 5002  # Port for Launcher Simulator
-
-# Create UDP socket
-sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)  # Initialize a UDP socket
-sock.bind(('localhost', LAUNCHER_PORT))  # Bind the socket to the local host and specified port
-
-print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Launcher Simulator running on port {LAUNCHER_PORT}")
-
-aks_heartbeat_received = False  # Flag to track if AKS heartbeat is received
-connected = False  # Flag to track connection status
-missed_heartbeats = 0  # Counter for missed heartbeats
-
-print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Waiting for initial AKS heartbeat...")
-
-while True:
-    try:
-        # Check for incoming messages (non-blocking)
-        sock.setblocking(False)  # Set socket to non-blocking mode
-        try:
-            data, addr = sock.recvfrom(1024)  # Receive data from the socket
-            message = data.decode()  # Decode the received message
-            print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Received from AKS: {message}")
-            if message == "AKS_HEARTBEAT":  # Check if the received message is a heartbeat
-                if not connected:  # If not already connected
-                    print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Connected to AKS")  # Log connection
-                    connected = True  # Update connection status
-                aks_heartbeat_received = True  # Update heartbeat status
-                missed_heartbeats = 0  # Reset missed heartbeats counter
-        except socket.error:  # Handle socket errors
-            if connected:  # If connected, increment missed heartbeats
-                missed_heartbeats += 1
-        sock.setblocking(True)  # Set socket back to blocking mode
-
-        if connected:  # If connected to AKS
-            if aks_heartbeat_received:  # If a heartbeat was received
-                # Send heartbeat
-                sock.sendto(b"LAUNCHER_HEARTBEAT", ('localhost', AKS_PORT))  # Send heartbeat to AKS
-
-            if missed_heartbeats >= 5:  # Check if too many heartbeats were missed
-                print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Lost connection with AKS")  # Log disconnection
-                connected = False  # Update connection status
-                aks_heartbeat_received = False  # Reset heartbeat status
-
-        time.sleep(1)  # Sleep for a second before the next iteration
-    except KeyboardInterrupt:  # Handle keyboard interrupt
-        print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Launcher Simulator shutting down")  # Log shutdown
-        break
-
+# File: simulators/LauncherSimulator.py
+import argparse
+import socket
+import time
+from datetime import datetime
+import AKSProtocol
+
+LAUNCHER_PORT = 5002  # Port for Launcher Simulator
+
+parser = argparse.ArgumentParser(description="Launcher Simulator")  # Parse command line options
+parser.add_argument('--binary', action='store_true', help="send binary protocol messages instead of text")
+parser.add_argument('--legacy', action='store_true', help="send bare text heartbeats without sequence numbers")
+AKSProtocol.add_endpoint_arguments(parser, LAUNCHER_PORT)
+args = parser.parse_args()
+aks_address = AKSProtocol.parse_endpoint(args.aks, AKSProtocol.AKS_PORT)  # Where everything is sent
+mode = AKSProtocol.BINARY if args.binary else AKSProtocol.LEGACY if args.legacy else AKSProtocol.TEXT
+sequence = 0  # Sequence number of the next message
+last_aks_heartbeat = None  # Last AKS heartbeat received, echoed back for the AKS round-trip measurement
+
+# Create the UDP socket, and the multicast group member if AKS heartbeats go to a group
+sock, heartbeat_sock = AKSProtocol.open_sockets(args, LAUNCHER_PORT)
+
+print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Launcher Simulator running on {args.bind}")
+
+aks_heartbeat_received = False  # Flag to track if AKS heartbeat is received
+connected = False  # Flag to track connection status
+missed_heartbeats = 0  # Counter for missed heartbeats
+
+print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Waiting for initial AKS heartbeat...")
+
+while True:
+    try:
+        # Check for incoming messages (non-blocking)
+        heartbeat_sock.setblocking(False)  # Set socket to non-blocking mode
+        try:
+            data, addr = heartbeat_sock.recvfrom(1024)  # Receive data from the socket
+            heartbeat = AKSProtocol.decode_heartbeat(data)  # Decode the received message (text or binary)
+            print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Received from AKS: {AKSProtocol.describe(data)}")
+            if heartbeat is not None and heartbeat.message_type == AKSProtocol.AKS_HEARTBEAT:  # Check if the received message is a heartbeat
+                if not connected:  # If not already connected
+                    print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Connected to AKS")  # Log connection
+                    connected = True  # Update connection status
+                last_aks_heartbeat = heartbeat  # Remember it for the echo
+                aks_heartbeat_received = True  # Update heartbeat status
+                missed_heartbeats = 0  # Reset missed heartbeats counter
+        except socket.error:  # Handle socket errors
+            if connected:  # If connected, increment missed heartbeats
+                missed_heartbeats += 1
+        heartbeat_sock.setblocking(True)  # Set socket back to blocking mode
+
+        if connected:  # If connected to AKS
+            if aks_heartbeat_received:  # If a heartbeat was received
+                # Send heartbeat
+                echo = last_aks_heartbeat.echo() if mode != AKSProtocol.LEGACY else None  # Echo the last AKS heartbeat
+                outgoing = AKSProtocol.encode_heartbeat(AKSProtocol.LAUNCHER_HEARTBEAT, mode, sequence, echo)
+                sock.sendto(outgoing, aks_address)  # Send heartbeat to AKS
+                sequence += 1
+
+            if missed_heartbeats >= 5:  # Check if too many heartbeats were missed
+                print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Lost connection with AKS")  # Log disconnection
+                connected = False  # Update connection status
+                aks_heartbeat_received = False  # Reset heartbeat status
+
+        time.sleep(1)  # Sleep for a second before the next iteration
+    except KeyboardInterrupt:  # Handle keyboard interrupt
+        print(f"{datetime.now().strftime('%Y-%m-%d %H:%M:%S.%f')[:-3]} Launcher Simulator shutting down")  # Log shutdown
+        break
+
+heartbeat_sock.close()
 sock.close()  # Close the socket when done
\ No newline at end of file
@@ -0,0 +1,24 @@
+QT -= gui
+QT += core network
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = aks_simulator
+
+# Protocol encoding and number formatting are shared with the AKS itself
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    PeerSimulator.cpp \
+    TrafficShaper.cpp \
+    ../../src/NumberFormat.cpp \
+    ../../src/Protocol.cpp
+
+HEADERS += \
+    PeerSimulator.h \
+    TrafficShaper.h \
+    ../../src/MonotonicTime.h \
+    ../../src/NumberFormat.h \
+    ../../src/Protocol.h
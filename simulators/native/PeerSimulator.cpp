@@ -0,0 +1,364 @@
+#include "PeerSimulator.h"
+#include <QDateTime>
+#include <QNetworkInterface>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include "MonotonicTime.h"
+#include "NumberFormat.h"
+
+namespace
+{
+    const quint16 ANS_PORT = 5001;                 // Bound in the ANS role by default
+    const quint16 LAUNCHER_PORT = 5002;            // Bound in the Launcher role by default
+    const int RECEIVE_BUFFER_SIZE = 1024;          // Largest datagram we read
+    const qint64 SPIN_THRESHOLD_NS = 2000000;      // Closer than this to a send, spin instead of sleeping
+    const int MAX_WAIT_MS = 100;                   // Longest single sleep, keeps Ctrl+C responsive
+    const qint64 MAX_CATCH_UP_NS = 1000000000;     // Further behind than this, skip missed slots
+    const qint64 WAIT_FOR_AKS_POLL_NS = 100000000; // Receive slice while waiting for the AKS
+
+    // Print a timestamped line, like the Python simulators
+    void report(const char *format, ...)
+    {
+        const QByteArray now = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz").toLatin1();
+        std::printf("%s ", now.constData());
+        va_list arguments;
+        va_start(arguments, format);
+        std::vprintf(format, arguments);
+        va_end(arguments);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    // Append ',' and 'value' with 'decimals' digits to a text message
+    int appendField(double value, int decimals, char *buffer, int length, int capacity)
+    {
+        buffer[length++] = ',';
+        const int written = NumberFormat::formatFixed(value, decimals, buffer + length, capacity - length);
+        return written > 0 ? length + written : 0;
+    }
+}
+
+// Constructor for PeerSimulator
+PeerSimulator::PeerSimulator(const Options &options)
+    : options(options), shaper(options.impairments), stopFlag(nullptr), heartbeatSequence(0),
+      platformSequence(0), haveAksHeartbeat(false), aksHeartbeatEchoed(false), lastAksHeartbeatReceivedNs(0),
+      latitude(0.0), longitude(0.0), altitude(10.0), positionRandom(options.impairments.seed ^ 0x9E3779B9u)
+{
+}
+
+// Name of a role for messages
+const char *PeerSimulator::roleName(Role role)
+{
+    return role == AnsRole ? "ANS" : "Launcher";
+}
+
+// Bind the role's port and join the multicast group
+bool PeerSimulator::bind()
+{
+    const quint16 port = options.port != 0 ? options.port : options.role == AnsRole ? ANS_PORT : LAUNCHER_PORT;
+    if (!socket.bind(options.bindAddress, port))
+    {
+        std::fprintf(stderr, "Cannot bind port %u: %s\n", unsigned(port), qPrintable(socket.errorString()));
+        return false;
+    }
+    report("%s simulator running on %s:%u", roleName(options.role), qPrintable(options.bindAddress.toString()), unsigned(port));
+    if (options.multicastGroup.isNull())
+    {
+        return true;
+    }
+
+    // Every subsystem on this host binds the group port, so the address is shared
+    if (!groupSocket.bind(QHostAddress::AnyIPv4, options.multicastPort, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+    {
+        std::fprintf(stderr, "Cannot bind port %u: %s\n", unsigned(options.multicastPort), qPrintable(groupSocket.errorString()));
+        return false;
+    }
+    bool joined = false;
+    for (const QNetworkInterface &candidate : QNetworkInterface::allInterfaces())
+    {
+        for (const QNetworkAddressEntry &entry : candidate.addressEntries())
+        {
+            if (!joined && entry.ip() == options.bindAddress)
+            {
+                joined = groupSocket.joinMulticastGroup(options.multicastGroup, candidate); // On the interface we talk to the AKS through
+            }
+        }
+    }
+    if (!joined && !groupSocket.joinMulticastGroup(options.multicastGroup)) // Bound to any address: the system's choice
+    {
+        std::fprintf(stderr, "Cannot join %s: %s\n", qPrintable(options.multicastGroup.toString()), qPrintable(groupSocket.errorString()));
+        return false;
+    }
+    report("Listening for AKS heartbeats on %s:%u", qPrintable(options.multicastGroup.toString()), unsigned(options.multicastPort));
+    return true;
+}
+
+// Send until the duration ends or 'stopRequested' is set
+void PeerSimulator::run(const std::atomic<bool> &stopRequested)
+{
+    stopFlag = &stopRequested;
+
+    if (options.waitForAks)
+    {
+        report("Waiting for initial AKS heartbeat...");
+        while (stats.aksHeartbeats == 0)
+        {
+            if (!waitUntil(MonotonicTime::nowNs() + WAIT_FOR_AKS_POLL_NS))
+            {
+                return;
+            }
+        }
+        report("Connected to AKS");
+    }
+
+    // Schedules start now; each stream sends one burst per period
+    const qint64 startNs = MonotonicTime::nowNs();
+    const qint64 endNs = options.durationSeconds > 0.0 ? startNs + qint64(options.durationSeconds * 1e9)
+                                                        : std::numeric_limits<qint64>::max();
+    heartbeatStream.periodNs = qint64(1e9 * options.burstSize / options.rateHz);
+    heartbeatStream.nextNs = startNs;
+    const double platformRateHz = options.platformRateHz < 0.0 ? options.rateHz : options.platformRateHz;
+    if (options.role == AnsRole && platformRateHz > 0.0)
+    {
+        platformStream.periodNs = qint64(1e9 * options.burstSize / platformRateHz);
+        platformStream.nextNs = startNs;
+    }
+
+    qint64 nowNs = startNs;
+    while (nowNs < endNs)
+    {
+        serviceStream(heartbeatStream, nowNs, &PeerSimulator::sendHeartbeatBurst);
+        serviceStream(platformStream, nowNs, &PeerSimulator::sendPlatformBurst);
+        flushDue(nowNs);
+
+        qint64 wakeNs = qMin(heartbeatStream.nextNs, endNs);
+        if (platformStream.periodNs > 0)
+        {
+            wakeNs = qMin(wakeNs, platformStream.nextNs);
+        }
+        const qint64 releaseNs = shaper.nextReleaseNs();
+        if (releaseNs >= 0)
+        {
+            wakeNs = qMin(wakeNs, releaseNs);
+        }
+        if (!waitUntil(wakeNs))
+        {
+            break;
+        }
+        nowNs = MonotonicTime::nowNs();
+    }
+    stats.elapsedSeconds = double(qMin(nowNs, endNs) - startNs) / 1e9;
+
+    // Datagrams still held back by jitter or reordering leave at their release time
+    while (shaper.pendingCount() > 0 && waitUntil(shaper.nextReleaseNs()))
+    {
+        flushDue(MonotonicTime::nowNs());
+    }
+}
+
+// Send every burst whose slot has come
+void PeerSimulator::serviceStream(Stream &stream, qint64 nowNs, void (PeerSimulator::*sendBurst)(qint64))
+{
+    if (stream.periodNs <= 0)
+    {
+        return;
+    }
+    if (nowNs - stream.nextNs > MAX_CATCH_UP_NS)
+    {
+        stream.nextNs = nowNs; // Stalled (e.g. suspended); resume instead of flooding the missed slots
+        ++stats.lateBursts;
+    }
+    while (stream.nextNs <= nowNs)
+    {
+        const qint64 latenessNs = nowNs - stream.nextNs;
+        stats.maxLatenessNs = qMax(stats.maxLatenessNs, latenessNs);
+        stats.lateBursts += latenessNs > stream.periodNs ? 1 : 0;
+        (this->*sendBurst)(nowNs);
+        stream.nextNs += stream.periodNs; // Absolute slots, so the average rate does not drift
+    }
+}
+
+// Produce one burst of heartbeats
+void PeerSimulator::sendHeartbeatBurst(qint64 nowNs)
+{
+    char buffer[Protocol::MAX_ENCODED_MESSAGE_SIZE];
+    for (int i = 0; i < options.burstSize; ++i)
+    {
+        Protocol::Message message;
+        message.type = options.role == AnsRole ? Protocol::ANSHeartbeat : Protocol::LauncherHeartbeat;
+        if (options.encoding != Protocol::TextEncoding)
+        {
+            message.hasSequence = true;
+            message.sequence = heartbeatSequence++;
+            message.timestampNs = nowNs;
+            if (haveAksHeartbeat)
+            {
+                message.hasEcho = true; // Repeated until a newer AKS heartbeat arrives, as the Python simulators do
+                message.echoSequence = lastAksHeartbeat.sequence;
+                message.echoTimestampNs = lastAksHeartbeat.timestampNs;
+                message.echoDelayNs = nowNs - lastAksHeartbeatReceivedNs;
+                stats.aksEchoed += aksHeartbeatEchoed ? 0 : 1;
+                aksHeartbeatEchoed = true;
+            }
+        }
+
+        const int length = options.encoding == Protocol::BinaryEncoding
+                               ? Protocol::encodeBinary(message, buffer, sizeof(buffer))
+                               : Protocol::encodeTextHeartbeat(message, buffer, sizeof(buffer));
+        shaper.submit(buffer, length, nowNs);
+        ++stats.heartbeatsSent;
+    }
+}
+
+// Produce one burst of platform info
+void PeerSimulator::sendPlatformBurst(qint64 nowNs)
+{
+    char buffer[Protocol::MAX_ENCODED_MESSAGE_SIZE];
+    for (int i = 0; i < options.burstSize; ++i)
+    {
+        // Same walk as the Python ANS simulator
+        latitude = std::fmod(latitude + 1.0, 91.0);
+        longitude = std::fmod(longitude + 1.0, 181.0);
+        altitude += std::uniform_real_distribution<double>(-4.0, 10.0)(positionRandom);
+
+        int length = 0;
+        if (options.encoding == Protocol::BinaryEncoding)
+        {
+            Protocol::Message message;
+            message.type = Protocol::PlatformInfo;
+            message.hasSequence = true;
+            message.sequence = platformSequence++;
+            message.timestampNs = nowNs;
+            message.latitude = latitude;
+            message.longitude = longitude;
+            message.altitude = altitude;
+            length = Protocol::encodeBinary(message, buffer, sizeof(buffer));
+        }
+        else
+        {
+            length = int(sizeof(Protocol::PLATFORM_INFO_PREFIX)) - 2; // Without the trailing ',' appendField adds
+            std::memcpy(buffer, Protocol::PLATFORM_INFO_PREFIX, size_t(length));
+            length = appendField(latitude, 6, buffer, length, sizeof(buffer));
+            length = length > 0 ? appendField(longitude, 6, buffer, length, sizeof(buffer)) : 0;
+            length = length > 0 ? appendField(altitude, 2, buffer, length, sizeof(buffer)) : 0;
+        }
+        shaper.submit(buffer, length, nowNs);
+        ++stats.platformInfoSent;
+    }
+}
+
+// Write the datagrams the shaper releases
+void PeerSimulator::flushDue(qint64 nowNs)
+{
+    TrafficShaper::Datagram datagram;
+    while (shaper.takeDue(nowNs, datagram))
+    {
+        const qint64 written = socket.writeDatagram(datagram.data, datagram.length, options.aksAddress, options.aksPort);
+        if (written == datagram.length)
+        {
+            ++stats.datagramsWritten;
+        }
+        else
+        {
+            ++stats.writeErrors; // Typically a full send buffer at very high rates
+        }
+    }
+}
+
+// Receive until 'deadlineNs'
+bool PeerSimulator::waitUntil(qint64 deadlineNs)
+{
+    for (;;)
+    {
+        const qint64 nowNs = MonotonicTime::nowNs();
+        receivePending(nowNs);
+        if (stopFlag && stopFlag->load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        const qint64 remainingNs = deadlineNs - nowNs;
+        if (remainingNs <= 0)
+        {
+            return true;
+        }
+        if (remainingNs > SPIN_THRESHOLD_NS)
+        {
+            // Sleep in the socket AKS heartbeats arrive on until shortly before the deadline; one wakes us early
+            const qint64 waitMs = (remainingNs - SPIN_THRESHOLD_NS / 2) / 1000000;
+            QUdpSocket &heartbeatSocket = options.multicastGroup.isNull() ? socket : groupSocket;
+            heartbeatSocket.waitForReadyRead(int(qMin<qint64>(waitMs, MAX_WAIT_MS)));
+        }
+        else
+        {
+            std::this_thread::yield(); // Timer resolution is too coarse for the last stretch
+        }
+    }
+}
+
+// Read everything the sockets have
+void PeerSimulator::receivePending(qint64 nowNs)
+{
+    receiveFrom(socket, nowNs);
+    if (!options.multicastGroup.isNull())
+    {
+        receiveFrom(groupSocket, nowNs);
+    }
+}
+
+// Read everything one socket has
+void PeerSimulator::receiveFrom(QUdpSocket &source, qint64 nowNs)
+{
+    char buffer[RECEIVE_BUFFER_SIZE];
+    while (source.hasPendingDatagrams())
+    {
+        const qint64 size = source.readDatagram(buffer, sizeof(buffer));
+        if (size < 0)
+        {
+            break;
+        }
+
+        Protocol::Message message;
+        if (!Protocol::decode(buffer, size, message) || message.type != Protocol::AKSHeartbeat)
+        {
+            ++stats.otherDatagrams;
+            continue;
+        }
+        ++stats.aksHeartbeats;
+        if (message.hasSequence)
+        {
+            lastAksHeartbeat = message; // Echoed in our next heartbeat
+            lastAksHeartbeatReceivedNs = nowNs;
+            haveAksHeartbeat = true;
+            aksHeartbeatEchoed = false;
+        }
+        if (options.verbose)
+        {
+            report("Received from AKS: heartbeat seq %s", message.hasSequence ? QByteArray::number(message.sequence).constData() : "-");
+        }
+    }
+}
+
+// Print the statistics of the finished run
+void PeerSimulator::printStats() const
+{
+    const TrafficShaper::Counters &shaped = shaper.counters();
+    const double seconds = stats.elapsedSeconds > 0.0 ? stats.elapsedSeconds : 1.0;
+    report("%s simulator shutting down", roleName(options.role));
+    std::printf("  duration            %.3f s\n", stats.elapsedSeconds);
+    std::printf("  heartbeats sent     %llu (%.1f/s)\n", (unsigned long long)stats.heartbeatsSent, stats.heartbeatsSent / seconds);
+    std::printf("  platform info sent  %llu (%.1f/s)\n", (unsigned long long)stats.platformInfoSent, stats.platformInfoSent / seconds);
+    std::printf("  datagrams written   %llu (%.1f/s)\n", (unsigned long long)stats.datagramsWritten, stats.datagramsWritten / seconds);
+    std::printf("  dropped             %llu\n", (unsigned long long)shaped.dropped);
+    std::printf("  duplicated          %llu\n", (unsigned long long)shaped.duplicated);
+    std::printf("  reordered           %llu\n", (unsigned long long)shaped.reordered);
+    std::printf("  delayed             %llu\n", (unsigned long long)shaped.delayed);
+    std::printf("  write errors        %llu\n", (unsigned long long)stats.writeErrors);
+    std::printf("  late bursts         %llu (max lateness %.1f us)\n", (unsigned long long)stats.lateBursts, stats.maxLatenessNs / 1e3);
+    std::printf("  AKS heartbeats      %llu received, %llu echoed\n", (unsigned long long)stats.aksHeartbeats, (unsigned long long)stats.aksEchoed);
+    std::printf("  other datagrams     %llu\n", (unsigned long long)stats.otherDatagrams);
+    std::fflush(stdout);
+}
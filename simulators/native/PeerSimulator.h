@@ -0,0 +1,115 @@
+#ifndef PEERSIMULATOR_H
+#define PEERSIMULATOR_H
+
+#include <QUdpSocket>
+#include <atomic>
+#include <random>
+#include "Protocol.h"
+#include "TrafficShaper.h"
+
+// ANS or Launcher stand-in for load testing the AKS.
+// Heartbeats (and, for ANS, platform info) are sent on a fixed schedule derived from the steady clock,
+// so rates from 1 Hz to tens of kHz hold on average even when a single wakeup is late. Messages can be
+// grouped into bursts and pass through a TrafficShaper for loss, jitter, reordering and duplication.
+// The socket stays non-blocking for the whole run: the loop sleeps in waitForReadyRead() until the next
+// send is close and spins for the last stretch, answering AKS heartbeats with echoes as they arrive.
+// With a multicast group, AKS heartbeats are read from a second socket that joined the group, the way
+// every subsystem receives them from an AKS sending to AKS_MULTICAST_GROUP.
+class PeerSimulator
+{
+public:
+    // Which subsystem is simulated
+    enum Role
+    {
+        AnsRole,     // ANS: heartbeats and platform info from port 5001 by default
+        LauncherRole // Launcher: heartbeats from port 5002 by default
+    };
+
+    // Run settings
+    struct Options
+    {
+        Role role = AnsRole;                                              // Simulated subsystem
+        Protocol::Encoding encoding = Protocol::ExtendedTextEncoding;     // Wire encoding of everything we send
+        double rateHz = 1.0;                                              // Heartbeats per second (average)
+        double platformRateHz = -1.0;                                     // ANS platform info per second; negative follows rateHz
+        int burstSize = 1;                                                // Messages sent back to back per burst
+        double durationSeconds = 0.0;                                     // Run time after the start; 0 runs until interrupted
+        bool waitForAks = true;                                           // Start sending only after the first AKS heartbeat
+        bool verbose = false;                                             // Print every received AKS heartbeat
+        TrafficShaper::Settings impairments;                              // Loss, jitter, reordering and duplication
+        QHostAddress bindAddress = QHostAddress(QHostAddress::LocalHost); // Local address of the role's socket
+        quint16 port = 0;                                                 // Local port; 0 uses the role's default
+        QHostAddress aksAddress = QHostAddress(QHostAddress::LocalHost);  // Where everything is sent
+        quint16 aksPort = 5000;                                           // AKS port
+        QHostAddress multicastGroup;                                      // Group the AKS sends heartbeats to; null: unicast
+        quint16 multicastPort = 5003;                                     // Port of the group
+    };
+
+    // Results of a run
+    struct Stats
+    {
+        double elapsedSeconds = 0.0;  // Time between the first scheduled send and the end of the run
+        quint64 heartbeatsSent = 0;   // Heartbeats produced by the schedule
+        quint64 platformInfoSent = 0; // Platform info messages produced by the schedule
+        quint64 datagramsWritten = 0; // Datagrams that reached the socket after the impairments
+        quint64 writeErrors = 0;      // Datagrams the socket refused
+        quint64 lateBursts = 0;       // Bursts sent more than one period after their slot
+        qint64 maxLatenessNs = 0;     // Largest delay between a slot and its burst
+        quint64 aksHeartbeats = 0;    // AKS heartbeats received
+        quint64 aksEchoed = 0;        // Of those, echoed back in one of our heartbeats
+        quint64 otherDatagrams = 0;   // Received datagrams that were not AKS heartbeats
+    };
+
+    explicit PeerSimulator(const Options &options); // Constructor
+
+    // Bind the role's port and join the multicast group, if any; returns false if either fails
+    bool bind();
+
+    // Send until the duration ends or 'stopRequested' is set
+    void run(const std::atomic<bool> &stopRequested);
+
+    // Print the statistics of the finished run
+    void printStats() const;
+
+    // Name of a role for messages
+    static const char *roleName(Role role);
+
+private:
+    // A recurring send, scheduled by absolute slot times
+    struct Stream
+    {
+        qint64 periodNs = 0; // Time between two bursts; 0 disables the stream
+        qint64 nextNs = 0;   // Slot of the next burst
+    };
+
+    void receivePending(qint64 nowNs);                  // Read everything the sockets have
+    void receiveFrom(QUdpSocket &source, qint64 nowNs); // Read everything one socket has
+    bool waitUntil(qint64 deadlineNs);                  // Receive until 'deadlineNs'; returns false if the run should end
+    void sendHeartbeatBurst(qint64 nowNs);              // Produce one burst of heartbeats
+    void sendPlatformBurst(qint64 nowNs);               // Produce one burst of platform info
+    void flushDue(qint64 nowNs);                        // Write the datagrams the shaper releases
+
+    // Send every burst of 'stream' whose slot has come
+    void serviceStream(Stream &stream, qint64 nowNs, void (PeerSimulator::*sendBurst)(qint64));
+
+    Options options;                    // Run settings
+    QUdpSocket socket;                  // Bound to the role's port
+    QUdpSocket groupSocket;             // Member of the multicast group, if one is set
+    TrafficShaper shaper;               // Impairments on the way out
+    Stats stats;                        // Running statistics
+    const std::atomic<bool> *stopFlag;  // Set by the signal handler
+    Stream heartbeatStream;             // Heartbeat schedule
+    Stream platformStream;              // Platform info schedule (ANS only)
+    quint32 heartbeatSequence;          // Sequence number of the next heartbeat (the AKS counts heartbeat loss from these)
+    quint32 platformSequence;           // Sequence number of the next binary platform info
+    bool haveAksHeartbeat;              // An AKS heartbeat with a sequence has been received
+    bool aksHeartbeatEchoed;            // The last AKS heartbeat was already echoed once
+    Protocol::Message lastAksHeartbeat; // Last AKS heartbeat, echoed back for the AKS round-trip measurement
+    qint64 lastAksHeartbeatReceivedNs;  // When it arrived, for the hold time
+    double latitude;                    // Simulated latitude
+    double longitude;                   // Simulated longitude
+    double altitude;                    // Simulated altitude
+    std::mt19937 positionRandom;        // Altitude random walk
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "TrafficShaper.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Heap order: the earliest release time (then the earliest submission) at the front
+    bool releasesLater(const TrafficShaper::Datagram &a, const TrafficShaper::Datagram &b)
+    {
+        return a.releaseNs != b.releaseNs ? a.releaseNs > b.releaseNs : a.order > b.order;
+    }
+}
+
+// Constructor for TrafficShaper
+TrafficShaper::TrafficShaper(const Settings &settings)
+    : settings(settings), nextOrder(0), random(settings.seed), unitRandom(0.0, 1.0)
+{
+    pending.reserve(1024); // Enough for deep jitter at high rates without growing during a run
+}
+
+// Apply the impairments to a datagram produced at 'nowNs'
+void TrafficShaper::submit(const char *data, int length, qint64 nowNs)
+{
+    ++stats.submitted;
+    if (length <= 0 || length > Protocol::MAX_ENCODED_MESSAGE_SIZE)
+    {
+        return;
+    }
+    if (chance(settings.lossRatio))
+    {
+        ++stats.dropped;
+        return;
+    }
+
+    qint64 releaseNs = nowNs + jitterSample();
+    if (chance(settings.reorderRatio))
+    {
+        releaseNs += settings.reorderHoldNs; // Datagrams submitted during the hold overtake this one
+        ++stats.reordered;
+    }
+    stats.delayed += releaseNs > nowNs ? 1 : 0;
+    enqueue(data, length, releaseNs);
+
+    if (chance(settings.duplicateRatio))
+    {
+        enqueue(data, length, nowNs + jitterSample()); // The copy gets its own delay
+        ++stats.duplicated;
+    }
+}
+
+// Take the next datagram due at or before 'nowNs'
+bool TrafficShaper::takeDue(qint64 nowNs, Datagram &datagram)
+{
+    if (pending.empty() || pending.front().releaseNs > nowNs)
+    {
+        return false;
+    }
+    std::pop_heap(pending.begin(), pending.end(), releasesLater);
+    datagram = pending.back();
+    pending.pop_back();
+    return true;
+}
+
+// Release time of the earliest waiting datagram
+qint64 TrafficShaper::nextReleaseNs() const
+{
+    return pending.empty() ? -1 : pending.front().releaseNs;
+}
+
+// Add a datagram to the release heap
+void TrafficShaper::enqueue(const char *data, int length, qint64 releaseNs)
+{
+    Datagram datagram;
+    datagram.releaseNs = releaseNs;
+    datagram.order = nextOrder++;
+    datagram.length = quint16(length);
+    std::memcpy(datagram.data, data, size_t(length));
+    pending.push_back(datagram);
+    std::push_heap(pending.begin(), pending.end(), releasesLater);
+}
+
+// Random delay in [0, jitterNs]
+qint64 TrafficShaper::jitterSample()
+{
+    if (settings.jitterNs <= 0)
+    {
+        return 0;
+    }
+    return qint64(unitRandom(random) * double(settings.jitterNs));
+}
+
+// True with probability 'ratio'
+bool TrafficShaper::chance(double ratio)
+{
+    return ratio > 0.0 && unitRandom(random) < ratio; // No random draw when the impairment is off
+}
@@ -0,0 +1,75 @@
+#ifndef TRAFFICSHAPER_H
+#define TRAFFICSHAPER_H
+
+#include <QtGlobal>
+#include <random>
+#include <vector>
+#include "Protocol.h"
+
+// Network impairments applied to outgoing datagrams before they reach the socket.
+// Every submitted datagram is dropped, delayed by a random jitter, held back so that later datagrams
+// overtake it, or duplicated, each with its own probability; the rest leave as soon as they are due.
+class TrafficShaper
+{
+public:
+    // Impairment settings; all zero means datagrams pass straight through
+    struct Settings
+    {
+        double lossRatio = 0.0;      // Probability of dropping a datagram
+        double duplicateRatio = 0.0; // Probability of sending a datagram twice
+        double reorderRatio = 0.0;   // Probability of holding a datagram back behind later ones
+        qint64 reorderHoldNs = 0;    // How long a reordered datagram is held back
+        qint64 jitterNs = 0;         // Upper bound of the uniform random delay added to each datagram
+        quint32 seed = 0;            // Random seed, for repeatable runs
+    };
+
+    // What happened to the submitted datagrams
+    struct Counters
+    {
+        quint64 submitted = 0;  // Datagrams handed to submit()
+        quint64 dropped = 0;    // Discarded by the loss ratio
+        quint64 duplicated = 0; // Extra copies queued
+        quint64 reordered = 0;  // Held back behind later datagrams
+        quint64 delayed = 0;    // Given a non-zero jitter delay
+    };
+
+    // A datagram waiting for its release time
+    struct Datagram
+    {
+        qint64 releaseNs;                              // Time the datagram may be sent
+        quint64 order;                                 // Submission order, breaks ties between equal release times
+        quint16 length;                                // Number of valid bytes in data
+        char data[Protocol::MAX_ENCODED_MESSAGE_SIZE]; // Encoded message
+    };
+
+    explicit TrafficShaper(const Settings &settings); // Constructor
+
+    // Apply the impairments to a datagram produced at 'nowNs'
+    void submit(const char *data, int length, qint64 nowNs);
+
+    // Take the next datagram due at or before 'nowNs'; returns false if none is due
+    bool takeDue(qint64 nowNs, Datagram &datagram);
+
+    // Release time of the earliest waiting datagram, or -1 if none is waiting
+    qint64 nextReleaseNs() const;
+
+    // Number of datagrams waiting
+    int pendingCount() const { return int(pending.size()); }
+
+    // Counters so far
+    const Counters &counters() const { return stats; }
+
+private:
+    void enqueue(const char *data, int length, qint64 releaseNs); // Add a datagram to the release heap
+    qint64 jitterSample();                                        // Random delay in [0, jitterNs]
+    bool chance(double ratio);                                    // True with probability 'ratio'
+
+    Settings settings;                                 // Impairment settings
+    Counters stats;                                    // Running counters
+    std::vector<Datagram> pending;                     // Min-heap on (releaseNs, order)
+    quint64 nextOrder;                                 // Order of the next queued datagram
+    std::mt19937_64 random;                            // Random source
+    std::uniform_real_distribution<double> unitRandom; // Uniform in [0, 1)
+};
+
+#endif
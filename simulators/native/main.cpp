@@ -0,0 +1,155 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <atomic>
+#include <clocale>
+#include <csignal>
+#include <cstdio>
+#include <random>
+#include "PeerSimulator.h"
+
+namespace
+{
+    std::atomic<bool> stopRequested(false); // Set on Ctrl+C, the run ends and prints its statistics
+
+    // SIGINT / SIGTERM handler
+    void requestStop(int)
+    {
+        stopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    // Read a number option; 'ok' is cleared if it is not a number within [minimum, maximum]
+    double numberOption(const QCommandLineParser &parser, const QCommandLineOption &option,
+                        double minimum, double maximum, bool &ok)
+    {
+        bool parsed = false;
+        const double value = parser.value(option).toDouble(&parsed);
+        if (!parsed || value < minimum || value > maximum)
+        {
+            std::fprintf(stderr, "Invalid value for --%s: %s\n", qPrintable(option.names().first()), qPrintable(parser.value(option)));
+            ok = false;
+        }
+        return value;
+    }
+
+    // Read an "address[:port]" option into 'address' and 'port' (kept when not given); 'ok' is cleared if it is invalid
+    void endpointOption(const QCommandLineParser &parser, const QCommandLineOption &option,
+                        QHostAddress &address, quint16 &port, bool &ok)
+    {
+        if (!parser.isSet(option))
+        {
+            return;
+        }
+        const QString value = parser.value(option);
+        const int colon = value.lastIndexOf(':');
+        const QString host = colon < 0 ? value : value.left(colon);
+        bool valid = true;
+        if (colon >= 0)
+        {
+            const uint parsedPort = value.mid(colon + 1).toUInt(&valid);
+            valid = valid && parsedPort > 0 && parsedPort <= 65535;
+            port = valid ? quint16(parsedPort) : port;
+        }
+        if (host.compare("localhost", Qt::CaseInsensitive) == 0)
+        {
+            address = QHostAddress(QHostAddress::LocalHost);
+        }
+        else if (!host.isEmpty())
+        {
+            valid = address.setAddress(host) && valid; // IPv4 only, an IPv6 address would need brackets
+        }
+        if (!valid)
+        {
+            std::fprintf(stderr, "Invalid value for --%s: %s\n", qPrintable(option.names().first()), qPrintable(value));
+            ok = false;
+        }
+    }
+}
+
+// Native ANS / Launcher simulator for load testing the AKS.
+// Usage: aks_simulator --role ans|launcher [--rate <hz>] [--burst <n>] [--loss <%>] [--jitter <ms>]
+//                      [--bind <addr[:port]>] [--aks <addr[:port]>] [--multicast <group[:port]>] ...
+// Speaks the same protocol as simulators/*.py (extended text by default, --binary or --legacy) through src/Protocol.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("aks_simulator");
+    std::setlocale(LC_NUMERIC, "C"); // Statistics print with '.' whatever the system locale
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("ANS / Launcher simulator with configurable rates and network impairments");
+    parser.addHelpOption();
+    QCommandLineOption roleOption("role", "Simulated subsystem: ans or launcher.", "role", "ans");
+    QCommandLineOption rateOption("rate", "Heartbeats per second.", "hz", "1");
+    QCommandLineOption platformRateOption("platform-rate", "ANS platform info per second (default: same as --rate).", "hz", "-1");
+    QCommandLineOption burstOption("burst", "Messages sent back to back per burst; the average rate is unchanged.", "n", "1");
+    QCommandLineOption durationOption("duration", "Seconds to send for; 0 runs until Ctrl+C.", "s", "0");
+    QCommandLineOption lossOption("loss", "Percentage of datagrams dropped.", "percent", "0");
+    QCommandLineOption duplicateOption("duplicate", "Percentage of datagrams sent twice.", "percent", "0");
+    QCommandLineOption reorderOption("reorder", "Percentage of datagrams held back behind later ones.", "percent", "0");
+    QCommandLineOption reorderHoldOption("reorder-hold", "Milliseconds a reordered datagram is held (default: three heartbeat intervals).", "ms", "-1");
+    QCommandLineOption jitterOption("jitter", "Maximum random delay added to each datagram, in milliseconds.", "ms", "0");
+    QCommandLineOption seedOption("seed", "Random seed, for repeatable impairments.", "n");
+    QCommandLineOption binaryOption("binary", "Send binary protocol messages instead of text.");
+    QCommandLineOption legacyOption("legacy", "Send bare text heartbeats without sequence numbers.");
+    QCommandLineOption noWaitOption("no-wait", "Start sending immediately instead of after the first AKS heartbeat.");
+    QCommandLineOption verboseOption("verbose", "Print every AKS heartbeat received.");
+    QCommandLineOption bindOption("bind", "Local address and port (default 127.0.0.1 and the role's port).", "addr[:port]");
+    QCommandLineOption aksOption("aks", "AKS address and port (default 127.0.0.1:5000).", "addr[:port]");
+    QCommandLineOption multicastOption("multicast", "Receive AKS heartbeats from this multicast group (default port 5003).", "group[:port]");
+    parser.addOptions({roleOption, rateOption, platformRateOption, burstOption, durationOption, lossOption,
+                       duplicateOption, reorderOption, reorderHoldOption, jitterOption, seedOption,
+                       binaryOption, legacyOption, noWaitOption, verboseOption, bindOption, aksOption, multicastOption});
+    parser.process(app);
+
+    PeerSimulator::Options options;
+    bool ok = true;
+    const QString role = parser.value(roleOption).toLower();
+    if (role != "ans" && role != "launcher")
+    {
+        std::fprintf(stderr, "Invalid value for --role: %s\n", qPrintable(role));
+        ok = false;
+    }
+    options.role = role == "launcher" ? PeerSimulator::LauncherRole : PeerSimulator::AnsRole;
+    options.encoding = parser.isSet(binaryOption)   ? Protocol::BinaryEncoding
+                       : parser.isSet(legacyOption) ? Protocol::TextEncoding
+                                                    : Protocol::ExtendedTextEncoding;
+    options.rateHz = numberOption(parser, rateOption, 0.001, 1e7, ok);
+    options.platformRateHz = numberOption(parser, platformRateOption, -1.0, 1e7, ok);
+    options.burstSize = int(numberOption(parser, burstOption, 1, 100000, ok));
+    options.durationSeconds = numberOption(parser, durationOption, 0.0, 1e9, ok);
+    options.waitForAks = !parser.isSet(noWaitOption);
+    options.verbose = parser.isSet(verboseOption);
+    endpointOption(parser, bindOption, options.bindAddress, options.port, ok);
+    endpointOption(parser, aksOption, options.aksAddress, options.aksPort, ok);
+    endpointOption(parser, multicastOption, options.multicastGroup, options.multicastPort, ok);
+    if (!options.multicastGroup.isNull() && !options.multicastGroup.isMulticast())
+    {
+        std::fprintf(stderr, "Not a multicast group: %s\n", qPrintable(options.multicastGroup.toString()));
+        ok = false;
+    }
+
+    TrafficShaper::Settings &impairments = options.impairments;
+    impairments.lossRatio = numberOption(parser, lossOption, 0.0, 100.0, ok) / 100.0;
+    impairments.duplicateRatio = numberOption(parser, duplicateOption, 0.0, 100.0, ok) / 100.0;
+    impairments.reorderRatio = numberOption(parser, reorderOption, 0.0, 100.0, ok) / 100.0;
+    impairments.jitterNs = qint64(numberOption(parser, jitterOption, 0.0, 60000.0, ok) * 1e6);
+    const double reorderHoldMs = numberOption(parser, reorderHoldOption, -1.0, 60000.0, ok);
+    impairments.reorderHoldNs = reorderHoldMs >= 0.0 ? qint64(reorderHoldMs * 1e6)
+                                                     : qint64(3e9 / qMax(options.rateHz, 0.001));
+    impairments.seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt() : std::random_device()();
+    if (!ok)
+    {
+        return 1;
+    }
+
+    PeerSimulator simulator(options);
+    if (!simulator.bind())
+    {
+        return 1;
+    }
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    simulator.run(stopRequested);
+    simulator.printStats();
+    return 0;
+}
@@ -1,131 +1,189 @@
-#include "AKSApp.h"
-#include "Logger.h"
-#include <QMessageBox>
-#include <QApplication>
-#include <QDir>
-
-AKSApp::AKSApp(QWidget *parent)
-    : QMainWindow(parent), gui(new AKSGUI(this)), core(new AKSCore(this)), configReader(new ConfigReader(this))
-{
-    // Log the start of the application
-    LOG_INFO("AKS Application starting");
-    setCentralWidget(gui); // Set the central widget to the GUI
-    setupConnections();    // Setup signal-slot connections
-    loadMissileConfig();   // Load missile configuration
-
-    core->start(); // Start the core functionality
-    LOG_INFO("AKS Application started successfully");
-}
-
-AKSApp::~AKSApp()
-{
-    // Log the shutdown of the application
-    LOG_INFO("AKS Application shutting down");
-    core->stop(); // Stop the core functionality
-}
-
-void AKSApp::setupConnections()
-{
-    // Connect GUI signals to Core slots
-    connect(gui, &AKSGUI::targetInfoUpdated, core, &AKSCore::updateTargetInfo, Qt::UniqueConnection);
-    connect(gui, &AKSGUI::missileLaunched, core, &AKSCore::launchMissile, Qt::UniqueConnection);
-    connect(gui, &AKSGUI::powerToggled, core, &AKSCore::toggleMissilePower, Qt::UniqueConnection);
-
-    // Connect Core signals to GUI slots
-    connect(core, &AKSCore::platformInfoUpdated, gui, &AKSGUI::updatePlatformInfo, Qt::UniqueConnection);
-    connect(core, &AKSCore::communicationStatusChanged, gui, &AKSGUI::updateCommunicationStatus, Qt::UniqueConnection);
-    connect(core, &AKSCore::missileStatusChanged, gui, &AKSGUI::updateMissileStatus, Qt::UniqueConnection);
-
-    // Connect Core signals to AKSApp slots
-    connect(core, &AKSCore::platformInfoUpdated, this, &AKSApp::onPlatformInfoUpdated, Qt::UniqueConnection);
-    connect(core, &AKSCore::communicationStatusChanged, this, &AKSApp::onCommunicationStatusChanged, Qt::UniqueConnection);
-    connect(core, &AKSCore::missileStatusChanged, this, &AKSApp::onMissileStatusChanged, Qt::UniqueConnection);
-
-    // Connect GUI signals to AKSApp slots
-    connect(gui, &AKSGUI::targetInfoUpdated, this, &AKSApp::onTargetInfoUpdated, Qt::UniqueConnection);
-    connect(gui, &AKSGUI::powerToggled, this, &AKSApp::onPowerToggled, Qt::UniqueConnection);
-    connect(gui, &AKSGUI::missileLaunched, this, &AKSApp::onMissileLaunched, Qt::UniqueConnection);
-
-    // Connect CommunicationManager signals to GUI slots
-    connect(core, &AKSCore::communicationStatusChanged, gui, &AKSGUI::updateCommunicationStatus, Qt::UniqueConnection);
-
-    // Connect error handling slots
-    connect(core, &AKSCore::errorOccurred, this, &AKSApp::handleError, Qt::UniqueConnection);
-    connect(gui, &AKSGUI::errorOccurred, this, &AKSApp::handleError, Qt::UniqueConnection);
-}
-
-void AKSApp::loadMissileConfig()
-{
-    // Construct the path to the missile configuration file
-    QString configPath = QApplication::applicationDirPath() + QDir::separator() + "config" + QDir::separator() + "missiles.conf";
-    if (configReader->loadMissileConfig(configPath)) // Load the missile configuration
-    {
-        QVector<MissileConfig> configs = configReader->getMissileConfigs(); // Get the loaded missile configurations
-        for (const auto &config : configs)                                  // Iterate through each missile configuration
-        {
-            gui->updateMissileStatus(config.index, config.type, config.healthy, false, false); // Update GUI with missile status
-            qDebug() << "Missile index: " << config.index << "Missile type: " << config.type << "Missile healthy: " << config.healthy;
-            core->updateMissileConfig(config.index, config.type, config.healthy); // Update core with missile configuration
-        }
-        LOG_INFO("Missile configuration loaded successfully"); // Log successful loading
-    }
-    else
-    {
-        // Log and display an error message if loading fails
-        QString errorMsg = "Failed to load missile configuration: " + configReader->getLastError();
-        LOG_ERROR(errorMsg);
-        QMessageBox::critical(this, "Configuration Error", errorMsg);
-    }
-}
-
-// Method to handle updates to target information
-void AKSApp::onTargetInfoUpdated(double latitude, double longitude, double altitude, double speed, double distance)
-{
-    // LOG_INFO(QString("Target info updated: Lat %1, Lon %2, Alt %3, Speed %4, Distance %5")
-    //     .arg(latitude).arg(longitude).arg(altitude).arg(speed).arg(distance));
-}
-
-// Method to handle toggling missile power
-void AKSApp::onPowerToggled(int missileIndex)
-{
-    // LOG_INFO(QString("Missile power toggled for index: %1").arg(missileIndex));
-}
-
-// Method to handle missile launch events
-void AKSApp::onMissileLaunched()
-{
-    LOG_INFO("Missile launch process started.");
-}
-
-// Method to handle updates to platform information
-void AKSApp::onPlatformInfoUpdated(double latitude, double longitude, double altitude)
-{
-    // LOG_INFO(QString("Platform info updated: Lat %1, Lon %2, Alt %3")
-    //     .arg(latitude).arg(longitude).arg(altitude));
-}
-
-// Method to handle changes in communication status
-void AKSApp::onCommunicationStatusChanged(bool ansStatus, bool launcherStatus)
-{
-    LOG_INFO(QString("Communication status changed - ANS: %1, Launcher: %2")
-                 .arg(ansStatus ? "Connected" : "Disconnected")
-                 .arg(launcherStatus ? "Connected" : "Disconnected"));
-}
-
-// Method to handle changes in missile status
-void AKSApp::onMissileStatusChanged(int index, const QString &type, bool healthy, bool powered, bool fired)
-{
-    LOG_INFO(QString("Missile status changed - Index: %1, Type: %2, Healthy: %3, Powered: %4, Fired: %5")
-                 .arg(index)
-                 .arg(type)
-                 .arg(healthy)
-                 .arg(powered)
-                 .arg(fired));
-}
-
-// Add a new method to handle application errors
-void AKSApp::handleError(const QString &message)
-{
-    LOG_ERROR(message);                            // Log the error message
-    QMessageBox::critical(this, "Error", message); // Display an error message box
-}
+#include "AKSApp.h"
+#include "Logger.h"
+#include <QMessageBox>
+#include <QApplication>
+#include <QDir>
+#include <QScreen>
+#include <QTimer>
+#include <QtMath>
+#include "GlobalConstants.h"
+
+// The core is configured and bound before any widget exists, so the first heartbeats leave while the GUI is
+// still being built; the widgets follow on the first event loop pass (they cannot be built on another thread).
+AKSApp::AKSApp(StartupTimeline *timeline, QWidget *parent)
+    : QMainWindow(parent), gui(nullptr), core(new AKSCore(this)), configReader(new ConfigReader(this)),
+      platformInfoCoalescer(new PlatformInfoCoalescer(MonotonicClock::system(), displayFrameIntervalMs(), this)),
+      timeline(timeline)
+{
+    // Log the start of the application
+    LOG_INFO("AKS Application starting");
+    if (timeline)
+    {
+        timeline->watch(core->getCommunicationManager()); // Time the first heartbeat of each peer
+    }
+    setupCoreConnections(); // Setup the signal-slot connections that need no widget
+    {
+        StartupTimeline::Phase phase(timeline, "config");
+        loadMissileConfig(); // Load missile configuration
+    }
+    {
+        StartupTimeline::Phase phase(timeline, "bind");
+        core->start(); // Bind the socket and send the first heartbeats
+    }
+    QTimer::singleShot(0, this, &AKSApp::buildGui); // On the first event loop pass
+    LOG_INFO("AKS Application started successfully");
+}
+
+AKSApp::~AKSApp()
+{
+    // Log the shutdown of the application
+    LOG_INFO("AKS Application shutting down");
+    core->stop(); // Stop the core functionality
+}
+
+// Build the widgets and connect them to the core
+void AKSApp::buildGui()
+{
+    {
+        StartupTimeline::Phase phase(timeline, "widgets");
+        gui = new AKSGUI(this);
+        setCentralWidget(gui); // Set the central widget to the GUI
+        setupGuiConnections(); // Setup signal-slot connections
+        core->publishState();  // The GUI missed the status published while it did not exist yet
+    }
+    show(); // Only now, so the window takes its natural size from the GUI
+    if (!startupError.isEmpty())
+    {
+        showError("Configuration Error", startupError); // Shown once there is a window to show it on
+        startupError.clear();
+    }
+}
+
+// Setup the signal-slot connections that need no widget
+void AKSApp::setupCoreConnections()
+{
+    // Connect error handling slots
+    connect(core, &AKSCore::errorOccurred, this, &AKSApp::handleError, Qt::UniqueConnection);
+
+    // Connect configuration reload signals to AKSApp slots
+    connect(configReader, &ConfigReader::missileConfigChanged, this, &AKSApp::onMissileConfigChanged, Qt::UniqueConnection);
+    connect(configReader, &ConfigReader::missileConfigReloadFailed, this, &AKSApp::onMissileConfigReloadFailed, Qt::UniqueConnection);
+}
+
+// Setup the signal-slot connections between the GUI and the core
+void AKSApp::setupGuiConnections()
+{
+    // Connect GUI signals to Core slots
+    connect(gui, &AKSGUI::targetInfoUpdated, core, &AKSCore::updateTargetInfo, Qt::UniqueConnection);
+    connect(gui, &AKSGUI::missileLaunched, core, &AKSCore::launchMissile, Qt::UniqueConnection);
+    connect(gui, &AKSGUI::powerToggled, core, &AKSCore::toggleMissilePower, Qt::UniqueConnection);
+
+    // Subscribe the GUI to Core events; platform info goes through the coalescer so the GUI
+    // redraws at most once per display frame however fast ANS sends, and only the latest link
+    // status is shown. State changes are logged once, by the core's audit log.
+    EventBus *bus = core->eventBus();
+    bus->subscribe<Events::PlatformInfo>(platformInfoCoalescer, EventBus::Direct, [this](const Events::PlatformInfo &event)
+                                         { platformInfoCoalescer->submit(event.latitude, event.longitude, event.altitude); });
+    connect(platformInfoCoalescer, &PlatformInfoCoalescer::platformInfoReady, gui, &AKSGUI::updatePlatformInfo, Qt::UniqueConnection);
+    gui->setPlatformHistory(&core->platformHistory()); // The trend plot reads every sample from the history, not just the coalesced ones
+    bus->subscribe<Events::CommunicationStatus>(gui, EventBus::Coalesced, [this](const Events::CommunicationStatus &event)
+                                                { gui->updateCommunicationStatus(event.ansConnected, event.launcherConnected); });
+    bus->subscribe<Events::MissileStatus>(gui, EventBus::Direct, [this](const Events::MissileStatus &event)
+                                          { gui->updateMissileStatus(event.index, event.typeName(), event.healthy, event.powered, event.fired); });
+
+    // Connect GUI signals to AKSApp slots
+    connect(gui, &AKSGUI::targetInfoUpdated, this, &AKSApp::onTargetInfoUpdated, Qt::UniqueConnection);
+    connect(gui, &AKSGUI::powerToggled, this, &AKSApp::onPowerToggled, Qt::UniqueConnection);
+    connect(gui, &AKSGUI::missileLaunched, this, &AKSApp::onMissileLaunched, Qt::UniqueConnection);
+
+    // Connect error handling slots
+    connect(gui, &AKSGUI::errorOccurred, this, &AKSApp::handleError, Qt::UniqueConnection);
+}
+
+// Display refresh period in milliseconds
+int AKSApp::displayFrameIntervalMs() const
+{
+    double refreshRate = GlobalConstants::GUI_FALLBACK_REFRESH_HZ;
+    if (QScreen *screen = QGuiApplication::primaryScreen())
+    {
+        if (screen->refreshRate() >= 1.0)
+        {
+            refreshRate = screen->refreshRate(); // Some platforms report 0 for unknown
+        }
+    }
+    return qMax(1, qFloor(1000.0 / refreshRate)); // Round down so no frame is skipped
+}
+
+void AKSApp::loadMissileConfig()
+{
+    // Construct the path to the missile configuration file
+    QString configPath = QApplication::applicationDirPath() + QDir::separator() + "config" + QDir::separator() + "missiles.conf";
+    if (configReader->loadMissileConfig(configPath)) // Load the missile configuration
+    {
+        QVector<MissileConfig> configs = configReader->getMissileConfigs(); // Get the loaded missile configurations
+        for (const auto &config : configs)                                  // Iterate through each missile configuration
+        {
+            core->updateMissileConfig(config.index, config.type, config.healthy); // Update core; the GUI follows through the missile status event
+        }
+        LOG_INFO("Missile configuration loaded successfully"); // Log successful loading
+        configReader->watchMissileConfig(configPath);           // Apply later edits of the file while running
+    }
+    else
+    {
+        // Log the error now and show it once the GUI is up; a modal dialog here would hold back the core
+        QString errorMsg = "Failed to load missile configuration: " + configReader->getLastError();
+        LOG_ERROR(errorMsg);
+        startupError = errorMsg;
+    }
+}
+
+// Method to handle updates to target information
+void AKSApp::onTargetInfoUpdated(double latitude, double longitude, double altitude, double speed, double distance)
+{
+    // LOG_INFO(QString("Target info updated: Lat %1, Lon %2, Alt %3, Speed %4, Distance %5")
+    //     .arg(latitude).arg(longitude).arg(altitude).arg(speed).arg(distance));
+}
+
+// Method to handle toggling missile power
+void AKSApp::onPowerToggled(int missileIndex)
+{
+    // LOG_INFO(QString("Missile power toggled for index: %1").arg(missileIndex));
+}
+
+// Method to handle missile launch events
+void AKSApp::onMissileLaunched()
+{
+    LOG_INFO("Missile launch process started.");
+}
+
+// Method to apply the missiles that changed in a reloaded configuration file
+void AKSApp::onMissileConfigChanged(const QVector<MissileConfig> &changed)
+{
+    for (const MissileConfig &config : changed)
+    {
+        core->updateMissileConfig(config.index, config.type, config.healthy); // The GUI follows through the missile status event
+    }
+    LOG_INFO(QString("Missile configuration reloaded: %1 missile(s) changed").arg(changed.size()));
+}
+
+// Method to handle a configuration file edit that could not be loaded
+void AKSApp::onMissileConfigReloadFailed(const QString &error)
+{
+    // The previous configuration stays in effect; no dialog, the file may be mid-edit
+    LOG_WARNING("Missile configuration reload ignored: " + error);
+}
+
+// Add a new method to handle application errors
+void AKSApp::handleError(const QString &message)
+{
+    LOG_ERROR(message);          // Log the error message
+    showError("Error", message); // Display an error message box
+}
+
+// Show an error message box without waiting for it to be closed
+void AKSApp::showError(const QString &title, const QString &message)
+{
+    QMessageBox *box = new QMessageBox(QMessageBox::Critical, title, message, QMessageBox::Ok, this);
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->open();
+}
@@ -1,61 +1,81 @@
-#ifndef AKSAPP_H
-#define AKSAPP_H
-
-#include <QMainWindow>
-#include "AKSGUI.h"
-#include "AKSCore.h"
-#include "ConfigReader.h"
-
-// Main application class for the AKS system, inheriting from QMainWindow
-class AKSApp : public QMainWindow
-{
-    Q_OBJECT
-
-public:
-    // Constructor: Initializes the application with an optional parent widget
-    AKSApp(QWidget *parent = nullptr);
-
-    // Destructor: Cleans up resources
-    ~AKSApp();
-
-private slots:
-    // Slot for handling updates to target information
-    void onTargetInfoUpdated(double latitude, double longitude, double altitude, double speed, double distance);
-
-    // Slot for toggling power of a missile
-    void onPowerToggled(int missileIndex);
-
-    // Slot for handling missile launch events
-    void onMissileLaunched();
-
-    // Slot for updating platform information
-    void onPlatformInfoUpdated(double latitude, double longitude, double altitude);
-
-    // Slot for handling changes in communication status
-    void onCommunicationStatusChanged(bool ansStatus, bool launcherStatus);
-
-    // Slot for handling changes in missile status
-    void onMissileStatusChanged(int index, const QString &type, bool healthy, bool powered, bool fired);
-
-public slots:
-    // Slot for handling error messages
-    void handleError(const QString &message);
-
-private:
-    // Pointer to the GUI component
-    AKSGUI *gui;
-
-    // Pointer to the core logic component
-    AKSCore *core;
-
-    // Pointer to the configuration reader
-    ConfigReader *configReader;
-
-    // Method to set up signal-slot connections
-    void setupConnections();
-
-    // Method to load missile configuration settings
-    void loadMissileConfig();
-};
-
+#ifndef AKSAPP_H
+#define AKSAPP_H
+
+#include <QMainWindow>
+#include "AKSGUI.h"
+#include "AKSCore.h"
+#include "ConfigReader.h"
+#include "PlatformInfoCoalescer.h"
+#include "StartupTimeline.h"
+
+// Main application class for the AKS system, inheriting from QMainWindow
+class AKSApp : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    // Constructor: Starts the core, builds the GUI on the first event loop pass and records both in 'timeline' (may be null)
+    explicit AKSApp(StartupTimeline *timeline, QWidget *parent = nullptr);
+
+    // Destructor: Cleans up resources
+    ~AKSApp();
+
+private slots:
+    // Slot for handling updates to target information
+    void onTargetInfoUpdated(double latitude, double longitude, double altitude, double speed, double distance);
+
+    // Slot for toggling power of a missile
+    void onPowerToggled(int missileIndex);
+
+    // Slot for handling missile launch events
+    void onMissileLaunched();
+
+    // Slot for applying the missiles that changed in a reloaded configuration file
+    void onMissileConfigChanged(const QVector<MissileConfig> &changed);
+
+    // Slot for a configuration file edit that could not be loaded
+    void onMissileConfigReloadFailed(const QString &error);
+
+    // Slot for building the widgets once the core is running, then showing the window
+    void buildGui();
+
+public slots:
+    // Slot for handling error messages
+    void handleError(const QString &message);
+
+private:
+    // Pointer to the GUI component, null until buildGui()
+    AKSGUI *gui;
+
+    // Pointer to the core logic component
+    AKSCore *core;
+
+    // Pointer to the configuration reader
+    ConfigReader *configReader;
+
+    // Paces platform info updates to the display refresh rate
+    PlatformInfoCoalescer *platformInfoCoalescer;
+
+    // Startup phases and first heartbeats, owned by main()
+    StartupTimeline *timeline;
+
+    // Error found before the GUI existed, shown by buildGui()
+    QString startupError;
+
+    // Display refresh period in milliseconds
+    int displayFrameIntervalMs() const;
+
+    // Method to set up the signal-slot connections that need no widget
+    void setupCoreConnections();
+
+    // Method to set up the signal-slot connections between the GUI and the core
+    void setupGuiConnections();
+
+    // Method to show an error message box without waiting for it to be closed
+    void showError(const QString &title, const QString &message);
+
+    // Method to load missile configuration settings
+    void loadMissileConfig();
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "AuditLog.h"
+#include "Logger.h"
+#include <cstring>
+
+// Constructor for AuditLog
+AuditLog::AuditLog(EventBus *bus, QObject *parent)
+    : QObject(parent), hasCommunicationStatus(false), lastCommunication(), logged(0), suppressed(0)
+{
+    bus->subscribe<Events::CommunicationStatus>(this, EventBus::Direct, [this](const Events::CommunicationStatus &event)
+                                                { record(event); });
+    bus->subscribe<Events::MissileStatus>(this, EventBus::Direct, [this](const Events::MissileStatus &event)
+                                          { record(event); });
+}
+
+// Events written to the log
+quint64 AuditLog::loggedCount() const
+{
+    return logged;
+}
+
+// Events that repeated the last logged state
+quint64 AuditLog::suppressedCount() const
+{
+    return suppressed;
+}
+
+// Log a link status change
+void AuditLog::record(const Events::CommunicationStatus &event)
+{
+    if (hasCommunicationStatus && event.ansConnected == lastCommunication.ansConnected &&
+        event.launcherConnected == lastCommunication.launcherConnected)
+    {
+        ++suppressed; // E.g. a launcher status refresh that changed nothing
+        return;
+    }
+    // A lost link is logged as a warning so it stands out
+    const bool lost = hasCommunicationStatus && ((lastCommunication.ansConnected && !event.ansConnected) ||
+                                                 (lastCommunication.launcherConnected && !event.launcherConnected));
+    const Logger::LogLevel level = lost ? Logger::Warning : Logger::Info;
+    hasCommunicationStatus = true;
+    lastCommunication = event;
+    ++logged;
+    LOG_EVENT(level, BinaryLog::CommunicationStatusChanged,
+              event.ansConnected ? "Connected" : "Disconnected",
+              event.launcherConnected ? "Connected" : "Disconnected");
+}
+
+// Log a missile status change
+void AuditLog::record(const Events::MissileStatus &event)
+{
+    if (event.index < 0)
+    {
+        return;
+    }
+    while (lastMissiles.size() <= event.index) // Missiles are numbered from 0 to 3
+    {
+        Events::MissileStatus none = {};
+        none.index = -1; // Nothing logged yet
+        lastMissiles.append(none);
+    }
+    Events::MissileStatus &last = lastMissiles[event.index];
+    if (last.index == event.index && last.healthy == event.healthy && last.powered == event.powered &&
+        last.fired == event.fired && std::strcmp(last.type, event.type) == 0)
+    {
+        ++suppressed; // E.g. a configuration reload that left this missile as it was
+        return;
+    }
+    last = event;
+    ++logged;
+    LOG_EVENT(Logger::Info, BinaryLog::MissileStatusChanged, event.index, event.type, event.healthy, event.powered, event.fired);
+}
@@ -0,0 +1,32 @@
+#ifndef AUDITLOG_H
+#define AUDITLOG_H
+
+#include <QObject>
+#include <QVector>
+#include "EventBus.h"
+
+// The one place where state changes published by AKSCore are written to the log.
+// Subscribes directly to the bus, so entries keep the order and timestamps of the changes, and
+// logs an event only if it differs from the last one logged for the same link or missile.
+class AuditLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AuditLog(EventBus *bus, QObject *parent = nullptr); // Constructor, subscribes to 'bus'
+
+    quint64 loggedCount() const;     // Events written to the log
+    quint64 suppressedCount() const; // Events that repeated the last logged state
+
+private:
+    void record(const Events::CommunicationStatus &event); // Log a link status change
+    void record(const Events::MissileStatus &event);       // Log a missile status change
+
+    bool hasCommunicationStatus;                   // A link status has been logged
+    Events::CommunicationStatus lastCommunication; // Last logged link status
+    QVector<Events::MissileStatus> lastMissiles;   // Last logged status per missile index (index -1 if none yet)
+    quint64 logged;                                // Events written to the log
+    quint64 suppressed;                            // Events that repeated the last logged state
+};
+
+#endif
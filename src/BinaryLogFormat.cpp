@@ -0,0 +1,214 @@
+#include "BinaryLogFormat.h"
+
+namespace BinaryLog
+{
+    namespace
+    {
+        const int MAX_TEMPLATE_ARGS = 9; // Placeholders %1 to %9
+
+        // Decode up to MAX_TEMPLATE_ARGS arguments into their text form, as QString::arg would print them;
+        // returns the number decoded, stopping at a truncated or unknown argument
+        int decodeArgs(const char *payload, quint16 payloadSize, quint8 argCount, QString *args)
+        {
+            const char *cursor = payload;
+            const char *end = payload + payloadSize;
+            int decoded = 0;
+            for (; decoded < argCount && decoded < MAX_TEMPLATE_ARGS && cursor < end; ++decoded)
+            {
+                const uchar *value = reinterpret_cast<const uchar *>(cursor + 1);
+                switch (static_cast<quint8>(*cursor))
+                {
+                case Int64Arg:
+                    if (end - cursor < 9)
+                    {
+                        return decoded;
+                    }
+                    args[decoded] = QString::number(qFromLittleEndian<qint64>(value));
+                    cursor += 9;
+                    break;
+                case DoubleArg:
+                {
+                    if (end - cursor < 9)
+                    {
+                        return decoded;
+                    }
+                    quint64 bits = qFromLittleEndian<quint64>(value);
+                    double number;
+                    std::memcpy(&number, &bits, sizeof(number));
+                    args[decoded] = QString::number(number); // 'g', 6 digits, like QString::arg(double)
+                    cursor += 9;
+                    break;
+                }
+                case BoolArg:
+                    if (end - cursor < 2)
+                    {
+                        return decoded;
+                    }
+                    args[decoded] = QString::number(value[0] ? 1 : 0); // Matches QString::arg(bool) in text logs
+                    cursor += 2;
+                    break;
+                case StringArg:
+                {
+                    if (end - cursor < 3)
+                    {
+                        return decoded;
+                    }
+                    quint16 length = qFromLittleEndian<quint16>(value);
+                    if (end - cursor - 3 < length)
+                    {
+                        return decoded;
+                    }
+                    args[decoded] = QString::fromUtf8(cursor + 3, length);
+                    cursor += 3 + length;
+                    break;
+                }
+                default:
+                    return decoded; // Unknown tag, stop decoding this record
+                }
+            }
+            return decoded;
+        }
+    }
+
+    // Append the file header to a buffer
+    void appendFileHeader(QByteArray &out)
+    {
+        uchar version[4];
+        qToLittleEndian(FORMAT_VERSION, version);
+        out.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+        out.append(reinterpret_cast<const char *>(version), sizeof(version));
+    }
+
+    // Check the file header at the start of a buffer
+    bool readFileHeader(const char *data, qint64 size, quint32 *version)
+    {
+        if (size < FILE_HEADER_SIZE || std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        {
+            return false; // Not a binary AKS log
+        }
+        *version = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data + sizeof(FILE_MAGIC)));
+        return true;
+    }
+
+    // Append a record to a buffer
+    void appendRecord(QByteArray &out, qint64 timestampNs, quint8 level, quint16 messageId,
+                      quint8 argCount, const char *payload, quint16 payloadSize)
+    {
+        uchar header[RECORD_HEADER_SIZE];
+        qToLittleEndian(timestampNs, header);
+        qToLittleEndian(messageId, header + 8);
+        qToLittleEndian(payloadSize, header + 10);
+        header[12] = level;
+        header[13] = argCount;
+        out.append(reinterpret_cast<const char *>(header), RECORD_HEADER_SIZE);
+        out.append(payload, payloadSize);
+    }
+
+    // Read one record; advances 'cursor' and returns false if the remaining data is truncated
+    bool readRecord(const char *&cursor, const char *end, Record &record)
+    {
+        if (end - cursor < RECORD_HEADER_SIZE)
+        {
+            return false; // Truncated header
+        }
+        const uchar *header = reinterpret_cast<const uchar *>(cursor);
+        record.timestampNs = qFromLittleEndian<qint64>(header);
+        record.messageId = qFromLittleEndian<quint16>(header + 8);
+        record.payloadSize = qFromLittleEndian<quint16>(header + 10);
+        record.level = header[12];
+        record.argCount = header[13];
+        if (end - cursor - RECORD_HEADER_SIZE < record.payloadSize)
+        {
+            return false; // Truncated payload (e.g. the process died mid-write)
+        }
+        record.payload = cursor + RECORD_HEADER_SIZE;
+        cursor += RECORD_HEADER_SIZE + record.payloadSize;
+        return true;
+    }
+
+    // Read the (wall-clock ms, monotonic ns) anchor out of a SessionStart payload
+    bool readSessionAnchor(const char *payload, quint16 payloadSize, qint64 *wallClockMs, qint64 *monotonicNs)
+    {
+        if (payloadSize < 18 || payload[0] != Int64Arg || payload[9] != Int64Arg)
+        {
+            return false; // Malformed anchor
+        }
+        *wallClockMs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(payload + 1));
+        *monotonicNs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(payload + 10));
+        return true;
+    }
+
+    // Text template for a message id ("%1"-style placeholders)
+    const char *messageTemplate(quint16 messageId)
+    {
+        switch (messageId)
+        {
+        case FreeText:
+            return "%1";
+        case PlatformInfoReceived:
+            return "Platform info received: Lat %1, Lon %2, Alt %3";
+        case MissileStatusUpdated:
+            return "Missile %1 status updated: State %2";
+        case MissileStatusChanged:
+            return "Missile status changed - Index: %1, Type: %2, Healthy: %3, Powered: %4, Fired: %5";
+        case CommunicationStatusChanged:
+            return "Communication status changed - ANS: %1, Launcher: %2";
+        case LinkStatisticsReport:
+            return "Link %1 - RTT last/mean/max: %2/%3/%4 us, Jitter: %5 us, Received: %6, Lost: %7, Reordered: %8, Duplicates: %9";
+        case SessionStart:
+            return "Logger session started";
+        default:
+            return nullptr; // Written by a newer version of the application
+        }
+    }
+
+    // Expand a message id and its encoded arguments into the human-readable message text.
+    // The template is walked once, so a "%2" inside an argument is kept as it is instead of being substituted.
+    QString formatMessage(quint16 messageId, const char *payload, quint16 payloadSize, quint8 argCount)
+    {
+        const char *templateText = messageTemplate(messageId);
+        if (!templateText)
+        {
+            return QString("Unknown message %1").arg(messageId);
+        }
+
+        QString args[MAX_TEMPLATE_ARGS];
+        const int decoded = decodeArgs(payload, payloadSize, argCount, args);
+
+        QString message;
+        for (const char *cursor = templateText; *cursor; ++cursor)
+        {
+            const int index = cursor[0] == '%' ? cursor[1] - '1' : -1;
+            if (index >= 0 && index < decoded)
+            {
+                message += args[index];
+                ++cursor; // Skip the digit
+            }
+            else
+            {
+                message += QLatin1Char(*cursor); // Placeholders without an argument stay, as with QString::arg
+            }
+        }
+        return message;
+    }
+
+    // Name of a log level as written in text logs
+    const char *levelName(int level)
+    {
+        switch (level) // Check the log level
+        {
+        case 0:
+            return "DEBUG"; // Debug level
+        case 1:
+            return "INFO"; // Info level
+        case 2:
+            return "WARNING"; // Warning level
+        case 3:
+            return "ERROR"; // Error level
+        case 4:
+            return "CRITICAL"; // Critical level
+        default:
+            return "UNKNOWN"; // Unknown log level
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#ifndef BINARYLOGFORMAT_H
+#define BINARYLOGFORMAT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+
+// Compact binary log format shared by Logger and the offline log decoder.
+//
+// File layout (all integers little-endian):
+//   FileHeader    : magic "AKSBLOG\0" (8 bytes), format version (u32)
+//   Record*       : timestamp ns (i64), message id (u16), payload size (u16), level (u8), arg count (u8), payload
+// Payload        : argCount arguments, each a type tag (u8) followed by its value
+//                  Int64/Double: 8 bytes, Bool: 1 byte, String: length (u16) + UTF-8 bytes
+//
+// Timestamps are raw monotonic nanoseconds. Every logger session starts with a SessionStart record
+// whose arguments are the wall-clock time (ms since epoch) and the monotonic time (ns) of the same instant,
+// which lets the decoder turn the monotonic timestamps back into calendar time.
+namespace BinaryLog
+{
+    const char FILE_MAGIC[8] = {'A', 'K', 'S', 'B', 'L', 'O', 'G', '\0'}; // Identifies a binary log file
+    const quint32 FORMAT_VERSION = 1;                                    // Current binary format version
+    const int FILE_HEADER_SIZE = 12;                                     // Magic + version
+    const int RECORD_HEADER_SIZE = 14;                                   // Fixed part of every record
+    const int MAX_PAYLOAD_BYTES = 96;                                    // Argument bytes carried inline by a log entry
+
+    // Identifiers for log messages; the text templates live in messageTemplate()
+    enum MessageId : quint16
+    {
+        FreeText = 0,               // Preformatted message, single string argument
+        PlatformInfoReceived,       // Lat, Lon, Alt
+        MissileStatusUpdated,       // Index, State
+        MissileStatusChanged,       // Index, Type, Healthy, Powered, Fired
+        CommunicationStatusChanged, // ANS status, Launcher status
+        LinkStatisticsReport,       // Peer, RTT last/mean/max (us), jitter (us), received, lost, reordered, duplicates
+        SessionStart = 0xFFFF       // Wall-clock anchor (ms), monotonic anchor (ns)
+    };
+
+    // Type tags used in record payloads
+    enum ArgType : quint8
+    {
+        Int64Arg = 1,
+        DoubleArg = 2,
+        BoolArg = 3,
+        StringArg = 4
+    };
+
+    // Serializes arguments into a fixed-size payload buffer without allocating
+    class ArgWriter
+    {
+    public:
+        ArgWriter(char *buffer, int capacity) : data(buffer), capacity(capacity), used(0), count(0) {}
+
+        void add(qint64 value) { addFixed(Int64Arg, value); }
+        void add(int value) { addFixed(Int64Arg, static_cast<qint64>(value)); }
+        void add(quint32 value) { addFixed(Int64Arg, static_cast<qint64>(value)); }
+        void add(double value) { addFixed(DoubleArg, value); }
+        void add(bool value)
+        {
+            if (used + 2 > capacity)
+            {
+                return; // Argument does not fit, leave it out
+            }
+            data[used++] = static_cast<char>(BoolArg);
+            data[used++] = value ? 1 : 0;
+            ++count;
+        }
+        void add(const char *value) { addString(value, static_cast<int>(std::strlen(value))); }
+        void add(const QString &value)
+        {
+            QByteArray utf8 = value.toUtf8();
+            addString(utf8.constData(), utf8.size());
+        }
+
+        int size() const { return used; }     // Bytes written so far
+        int argCount() const { return count; } // Arguments written so far
+
+    private:
+        // Write a tag followed by an 8-byte little-endian value
+        template <typename T>
+        void addFixed(ArgType type, T value)
+        {
+            if (used + 1 + 8 > capacity)
+            {
+                return; // Argument does not fit, leave it out
+            }
+            quint64 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            data[used++] = static_cast<char>(type);
+            qToLittleEndian(bits, reinterpret_cast<uchar *>(data + used));
+            used += 8;
+            ++count;
+        }
+
+        // Write a tag, a length and the string bytes, truncating to the remaining space
+        void addString(const char *text, int length)
+        {
+            if (used + 3 > capacity)
+            {
+                return; // Not even the header fits
+            }
+            int room = capacity - used - 3;
+            if (length > room)
+            {
+                length = room;
+            }
+            data[used++] = static_cast<char>(StringArg);
+            qToLittleEndian(static_cast<quint16>(length), reinterpret_cast<uchar *>(data + used));
+            used += 2;
+            std::memcpy(data + used, text, static_cast<size_t>(length));
+            used += length;
+            ++count;
+        }
+
+        char *data;   // Destination buffer
+        int capacity; // Size of the destination buffer
+        int used;     // Bytes written
+        int count;    // Arguments written
+    };
+
+    // A record as read back from a binary log
+    struct Record
+    {
+        qint64 timestampNs;  // Monotonic timestamp in nanoseconds
+        quint16 messageId;   // Message identifier
+        quint8 level;        // Logger::LogLevel value
+        quint8 argCount;     // Number of encoded arguments
+        const char *payload; // Points into the buffer the record was read from
+        quint16 payloadSize; // Payload size in bytes
+    };
+
+    // Append the file header to a buffer
+    void appendFileHeader(QByteArray &out);
+
+    // Check the file header at the start of a buffer
+    bool readFileHeader(const char *data, qint64 size, quint32 *version);
+
+    // Append a record to a buffer
+    void appendRecord(QByteArray &out, qint64 timestampNs, quint8 level, quint16 messageId,
+                      quint8 argCount, const char *payload, quint16 payloadSize);
+
+    // Read one record; advances 'cursor' and returns false if the remaining data is truncated
+    bool readRecord(const char *&cursor, const char *end, Record &record);
+
+    // Read the (wall-clock ms, monotonic ns) anchor out of a SessionStart payload
+    bool readSessionAnchor(const char *payload, quint16 payloadSize, qint64 *wallClockMs, qint64 *monotonicNs);
+
+    // Text template for a message id ("%1"-style placeholders), nullptr for unknown ids
+    const char *messageTemplate(quint16 messageId);
+
+    // Expand a message id and its encoded arguments into the human-readable message text
+    QString formatMessage(quint16 messageId, const char *payload, quint16 payloadSize, quint8 argCount);
+
+    // Name of a log level as written in text logs
+    const char *levelName(int level);
+}
+
+#endif
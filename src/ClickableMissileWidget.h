@@ -5,6 +5,7 @@
 #include <QLabel>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QPixmap>
 
 // Class representing a clickable missile widget
 class ClickableMissileWidget : public QWidget
@@ -36,14 +37,28 @@ protected:
     void paintEvent(QPaintEvent *event) override;
 
 private:
+    // What the missile looks like; one cached pixmap per appearance
+    enum Appearance
+    {
+        EmptyAppearance,     // No missile type: outline only
+        FiredAppearance,     // Gray
+        UnhealthyAppearance, // Red
+        PoweredAppearance,   // Green with a yellow border
+        HealthyAppearance,   // Green
+        APPEARANCE_COUNT
+    };
+
     QLabel *m_label; // Label to display missile information
     QString m_type;  // Type of the missile
     bool m_healthy;  // Health status of the missile
     bool m_powered;  // Power status of the missile
     bool m_fired;    // Fired status of the missile
 
-    // Update the style of the widget
-    void updateStyle();
+    // Appearance for the current state
+    Appearance appearance() const;
+
+    // Missile image for an appearance, rendered once per size and device pixel ratio and shared by all widgets
+    static const QPixmap &pixmapFor(Appearance appearance, const QSize &size, qreal devicePixelRatio);
 };
 
 #endif
@@ -1,180 +1,649 @@
-#include "CommunicationManager.h"
-#include "Logger.h"
-#include "GlobalConstants.h"
-#include <QNetworkDatagram>
-
-// Constructor for CommunicationManager
-CommunicationManager::CommunicationManager(QObject *parent)
-    : QObject(parent), socket(new QUdpSocket(this)) // Initialize the UDP socket
-      ,
-      heartbeatTimer(new QTimer(this)) // Initialize the heartbeat timer
-      ,
-      communicationCheckTimer(new QTimer(this)) // Initialize the communication check timer
-      ,
-      ansMissedHeartbeats(0) // Initialize missed heartbeats counter for ANS
-      ,
-      launcherMissedHeartbeats(0) // Initialize missed heartbeats counter for Launcher
-      ,
-      lastANSHeartbeat(QDateTime::currentDateTime()) // Record the last ANS heartbeat time
-      ,
-      lastLauncherHeartbeat(QDateTime::currentDateTime()) // Record the last Launcher heartbeat time
-{
-    // Connect socket's readyRead signal to the readPendingDatagrams slot
-    connect(socket, &QUdpSocket::readyRead, this, &CommunicationManager::readPendingDatagrams);
-    // Connect heartbeat timer's timeout signal to the sendHeartbeat slot
-    connect(heartbeatTimer, &QTimer::timeout, this, &CommunicationManager::sendHeartbeat);
-    // Connect communication check timer's timeout signal to the checkCommunicationStatus slot
-    connect(communicationCheckTimer, &QTimer::timeout, this, &CommunicationManager::checkCommunicationStatus);
-}
-
-// Destructor for CommunicationManager
-CommunicationManager::~CommunicationManager()
-{
-    stop(); // Stop all operations
-}
-
-// Start the communication manager
-void CommunicationManager::start()
-{
-    // Attempt to bind the socket to the specified port
-    if (socket->bind(QHostAddress::LocalHost, AKS_PORT))
-    {
-        LOG_INFO(QString("CommunicationManager: Bound to port %1").arg(AKS_PORT));        // Log successful binding
-        heartbeatTimer->start(GlobalConstants::HEARTBEAT_INTERVAL_MS);                    // Start the heartbeat timer with a 1-second interval
-        communicationCheckTimer->start(GlobalConstants::COMMUNICATION_CHECK_INTERVAL_MS); // Start the communication check timer with a 1-second interval
-    }
-    else
-    {
-        LOG_ERROR(QString("CommunicationManager: Failed to bind to port %1").arg(AKS_PORT)); // Log binding failure
-    }
-}
-
-// Stop the communication manager
-void CommunicationManager::stop()
-{
-    heartbeatTimer->stop();          // Stop the heartbeat timer
-    communicationCheckTimer->stop(); // Stop the communication check timer
-    socket->close();                 // Close the UDP socket
-}
-
-// Send a heartbeat message
-void CommunicationManager::sendHeartbeat()
-{
-    QByteArray heartbeat = "AKS_HEARTBEAT"; // Define the heartbeat message
-    // Send the heartbeat message to both ANS and Launcher ports
-    socket->writeDatagram(heartbeat, QHostAddress::LocalHost, ANS_PORT);
-    socket->writeDatagram(heartbeat, QHostAddress::LocalHost, LAUNCHER_PORT);
-}
-
-// Read pending datagrams from the socket
-void CommunicationManager::readPendingDatagrams()
-{
-    // Process all pending datagrams
-    while (socket->hasPendingDatagrams())
-    {
-        QNetworkDatagram datagram = socket->receiveDatagram(); // Receive the datagram
-        QByteArray data = datagram.data();                     // Extract the data from the datagram
-        quint16 senderPort = datagram.senderPort();            // Get the sender's port
-
-        // Check if the sender is ANS
-        if (senderPort == ANS_PORT)
-        {
-            if (data == "ANS_HEARTBEAT")
-            {
-                processANSHeartbeat(); // Process ANS heartbeat
-            }
-            else
-            {
-                processPlatformInfo(data); // Process platform info
-            }
-        }
-        // Check if the sender is Launcher
-        else if (senderPort == LAUNCHER_PORT)
-        {
-            if (data == "LAUNCHER_HEARTBEAT")
-            {
-                processLauncherHeartbeat(); // Process Launcher heartbeat
-            }
-        }
-    }
-}
-
-// Process ANS heartbeat
-void CommunicationManager::processANSHeartbeat()
-{
-    lastANSHeartbeat = QDateTime::currentDateTime(); // Update the last ANS heartbeat time
-    ansMissedHeartbeats = 0;                         // Reset missed heartbeats counter for ANS
-    emit ansHeartbeatReceived();                     // Emit signal that ANS heartbeat was received
-}
-
-// Process Launcher heartbeat
-void CommunicationManager::processLauncherHeartbeat()
-{
-    lastLauncherHeartbeat = QDateTime::currentDateTime(); // Update the last Launcher heartbeat time
-    launcherMissedHeartbeats = 0;                         // Reset missed heartbeats counter for Launcher
-    emit launcherHeartbeatReceived();                     // Emit signal that Launcher heartbeat was received
-}
-
-// Update the last ANS heartbeat time
-void CommunicationManager::updateANSLastHeartbeat()
-{
-    lastANSHeartbeat = QDateTime::currentDateTime(); // Update the last ANS heartbeat time
-}
-
-// Update the last Launcher heartbeat time
-void CommunicationManager::updateLauncherLastHeartbeat()
-{
-    lastLauncherHeartbeat = QDateTime::currentDateTime(); // Update the last Launcher heartbeat time
-}
-
-// Check if there has been a recent ANS heartbeat
-bool CommunicationManager::hasRecentANSHeartbeat() const
-{
-    return lastANSHeartbeat.msecsTo(QDateTime::currentDateTime()) < GlobalConstants::HEARTBEAT_TIMEOUT_MS; // Return true if recent
-}
-
-// Check if there has been a recent Launcher heartbeat
-bool CommunicationManager::hasRecentLauncherHeartbeat() const
-{
-    return lastLauncherHeartbeat.msecsTo(QDateTime::currentDateTime()) < GlobalConstants::HEARTBEAT_TIMEOUT_MS; // Return true if recent
-}
-
-// Process platform information received from datagrams
-void CommunicationManager::processPlatformInfo(const QByteArray &data)
-{
-    QList<QByteArray> parts = data.split(','); // Split the data into parts
-    // Check if the data format is correct
-    if (parts.size() == 4 && parts[0] == "PLATFORM_INFO")
-    {
-        double latitude = parts[1].toDouble();                    // Extract latitude
-        double longitude = parts[2].toDouble();                   // Extract longitude
-        double altitude = parts[3].toDouble();                    // Extract altitude
-        emit platformInfoReceived(latitude, longitude, altitude); // Emit signal with platform info
-    }
-}
-
-// Check the communication status with ANS and Launcher
-void CommunicationManager::checkCommunicationStatus()
-{
-    QDateTime currentTime = QDateTime::currentDateTime(); // Get the current time
-
-    // Check if the last ANS heartbeat is recent
-    if (lastANSHeartbeat.msecsTo(currentTime) > GlobalConstants::HEARTBEAT_INTERVAL_MS)
-    {
-        ansMissedHeartbeats++; // Increment missed heartbeats counter for ANS
-        if (ansMissedHeartbeats >= 5)
-        {
-            emit ansCommunicationLost(); // Emit signal if communication is lost
-        }
-    }
-
-    // Check if the last Launcher heartbeat is recent
-    if (lastLauncherHeartbeat.msecsTo(currentTime) > GlobalConstants::HEARTBEAT_INTERVAL_MS)
-    {
-        launcherMissedHeartbeats++; // Increment missed heartbeats counter for Launcher
-        if (launcherMissedHeartbeats >= 5)
-        {
-            emit launcherCommunicationLost(); // Emit signal if communication is lost
-        }
-    }
-}
+#include "CommunicationManager.h"
+#include "Logger.h"
+#include "DatagramCapture.h"
+#include "GlobalConstants.h"
+#include "Metrics.h"
+#include "NetworkIOThread.h"
+#include "Trace.h"
+#include <QNetworkInterface>
+#include <algorithm>
+
+namespace
+{
+    // Heartbeat gap buckets in nanoseconds, around the 1 s heartbeat interval up to the 5 s timeout and beyond
+    const std::vector<qint64> HEARTBEAT_GAP_BOUNDS_NS = {
+        500000000, 900000000, 950000000, 1000000000, 1050000000, 1100000000, 1500000000,
+        2000000000, 3000000000, 5000000000, 10000000000};
+}
+
+// Constructor for CommunicationManager
+CommunicationManager::CommunicationManager(QObject *parent, MonotonicClock *clock)
+    : QObject(parent), clock(clock ? clock : MonotonicClock::system()) // Use the steady clock unless one is injected
+      ,
+      socket(new QUdpSocket(this)) // Initialize the UDP socket
+      ,
+      heartbeatTimer(this->clock->createTimer(this)) // Initialize the heartbeat timer
+      ,
+      liveness(new DeadlineScheduler(this->clock, this)) // Initialize the per-peer heartbeat deadlines
+      ,
+      linkStatisticsTimer(this->clock->createTimer(this)) // Initialize the link statistics timer
+      ,
+      receiveBuffer(GlobalConstants::MAX_DATAGRAM_SIZE, Qt::Uninitialized) // Allocate the receive buffer once
+      ,
+      network(NetworkConfig::fromEnvironment()) // Loopback defaults unless AKS_BIND and friends say otherwise
+      ,
+      ingest(GlobalConstants::INGEST_BUDGET_PER_WAKEUP) // Holds at most one wakeup's datagrams
+      ,
+      readPosted(false) // No queued read yet
+      ,
+      malformedCount(0) // Nothing received yet
+      ,
+      deferredWakeups(0) // Nothing received yet
+      ,
+      drainPosted(false) // No queued drain yet
+      ,
+      captureFlushTimer(nullptr) // Created by startCapture()
+      ,
+      offline(false) // Bound to a socket by start()
+      ,
+      ansWireEncoding(Protocol::TextEncoding) // Assume a legacy ANS until it sends binary
+      ,
+      launcherWireEncoding(Protocol::TextEncoding) // Assume a legacy Launcher until it sends binary
+      ,
+      heartbeatSequence(0) // Initialize the heartbeat sequence number
+      ,
+      ansLostAtLastLog(0) // Nothing logged yet
+      ,
+      launcherLostAtLastLog(0) // Nothing logged yet
+      ,
+      ansLastHeartbeatNs(0) // No ANS heartbeat yet
+      ,
+      launcherLastHeartbeatNs(0) // No Launcher heartbeat yet
+{
+    Metrics::Registry &metrics = Metrics::Registry::instance();
+    ansReceivedMetric = &metrics.counter("aks_datagrams_received_total", "Datagrams received per peer.", "peer=\"ans\"");
+    launcherReceivedMetric = &metrics.counter("aks_datagrams_received_total", "Datagrams received per peer.", "peer=\"launcher\"");
+    ansSentMetric = &metrics.counter("aks_datagrams_sent_total", "Datagrams sent per peer.", "peer=\"ans\"");
+    launcherSentMetric = &metrics.counter("aks_datagrams_sent_total", "Datagrams sent per peer.", "peer=\"launcher\"");
+    multicastSentMetric = &metrics.counter("aks_datagrams_sent_total", "Datagrams sent per peer.", "peer=\"multicast\"");
+    parseFailureMetric = &metrics.counter("aks_datagram_parse_failures_total", "Received datagrams that were unknown or malformed.");
+    unknownSenderMetric = &metrics.counter("aks_datagrams_unknown_sender_total", "Received datagrams from neither ANS nor Launcher.");
+    budgetExhaustedMetric = &metrics.counter("aks_ingest_budget_exhausted_total",
+                                             "Receive wakeups that hit the per-wakeup budget and yielded to the event loop.");
+    ansHeartbeatGapMetric = &metrics.histogram("aks_heartbeat_gap_seconds", "Time between two heartbeats of a peer.",
+                                               HEARTBEAT_GAP_BOUNDS_NS, 1e-9, "peer=\"ans\"");
+    launcherHeartbeatGapMetric = &metrics.histogram("aks_heartbeat_gap_seconds", "Time between two heartbeats of a peer.",
+                                                    HEARTBEAT_GAP_BOUNDS_NS, 1e-9, "peer=\"launcher\"");
+
+    // Connect socket's readyRead signal to the readPendingDatagrams slot
+    connect(socket, &QUdpSocket::readyRead, this, &CommunicationManager::readPendingDatagrams);
+    // Connect heartbeat timer's timeout signal to the sendHeartbeat slot
+    connect(heartbeatTimer, &ClockTimer::timeout, this, &CommunicationManager::sendHeartbeat);
+    // Connect the liveness scheduler's expiry signal to the onLivenessExpired slot
+    connect(liveness, &DeadlineScheduler::expired, this, &CommunicationManager::onLivenessExpired);
+    // Connect link statistics timer's timeout signal to the logLinkStatistics slot
+    connect(linkStatisticsTimer, &ClockTimer::timeout, this, &CommunicationManager::logLinkStatistics);
+}
+
+// Destructor for CommunicationManager
+CommunicationManager::~CommunicationManager()
+{
+    stop();        // Stop all operations
+    stopCapture(); // The I/O thread is joined, nothing records any more
+}
+
+// Endpoints and multicast settings used by the next start()
+void CommunicationManager::setNetworkConfig(const NetworkConfig &config)
+{
+    network = config;
+}
+
+// Endpoints and multicast settings in effect
+const NetworkConfig &CommunicationManager::networkConfig() const
+{
+    return network;
+}
+
+// Start the communication manager
+void CommunicationManager::start()
+{
+    QString error;
+    if (!network.validate(&error))
+    {
+        LOG_ERROR(QString("CommunicationManager: Invalid network configuration: %1").arg(error));
+        return;
+    }
+
+    const QString capturePath = qEnvironmentVariable("AKS_CAPTURE");
+    if (!capturePath.isEmpty())
+    {
+        startCapture(capturePath); // Before the socket, so the first datagram is recorded too
+    }
+
+    if (!startIOThread())
+    {
+        // Attempt to bind the socket to the configured endpoint
+        if (!socket->bind(network.bind.address, network.bind.port))
+        {
+            LOG_ERROR(QString("CommunicationManager: Failed to bind to %1").arg(network.bind.toString())); // Log binding failure
+            return;
+        }
+        if (network.usesMulticast() && !setUpMulticast())
+        {
+            LOG_ERROR(QString("CommunicationManager: Cannot send to %1: %2").arg(network.multicastGroup.toString(), socket->errorString()));
+            socket->close();
+            return;
+        }
+        LOG_INFO(QString("CommunicationManager: Bound with %1").arg(network.toString())); // Log successful binding
+    }
+    startTimers();   // Start the heartbeat, liveness and statistics timers
+    sendHeartbeat(); // Peers answer only once they hear the AKS, so the first round goes out now, not one interval later
+}
+
+// Set up multicast sending on the QUdpSocket
+bool CommunicationManager::setUpMulticast()
+{
+    socket->setSocketOption(QAbstractSocket::MulticastTtlOption, network.multicastTtl);
+    socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, network.multicastLoopback ? 1 : 0);
+    const QHostAddress interfaceAddress = network.outgoingInterface();
+    if (interfaceAddress.isNull())
+    {
+        return true; // Routed by the system
+    }
+    for (const QNetworkInterface &candidate : QNetworkInterface::allInterfaces())
+    {
+        for (const QNetworkAddressEntry &entry : candidate.addressEntries())
+        {
+            if (entry.ip() == interfaceAddress)
+            {
+                socket->setMulticastInterface(candidate);
+                return true;
+            }
+        }
+    }
+    return false; // No local interface has that address
+}
+
+// Start the timers without a socket
+void CommunicationManager::startOffline()
+{
+    offline = true;
+    startTimers(); // Heartbeats are built and discarded, liveness runs on the injected clock
+}
+
+// Record every received and sent datagram to 'path'
+bool CommunicationManager::startCapture(const QString &path)
+{
+    if (!capture)
+    {
+        capture.reset(new DatagramCapture());
+        captureFlushTimer = clock->createTimer(this);
+        connect(captureFlushTimer, &ClockTimer::timeout, this, [this]()
+                { capture->flush(); });
+    }
+    if (!capture->open(path))
+    {
+        LOG_ERROR(QString("CommunicationManager: Cannot open capture file %1").arg(path));
+        return false;
+    }
+    captureFlushTimer->start(GlobalConstants::CAPTURE_FLUSH_INTERVAL_MS); // Bounds the age of a batch when traffic stops
+    if (ioThread)
+    {
+        ioThread->setCapture(capture.get()); // The I/O thread records what it receives
+    }
+    LOG_INFO(QString("CommunicationManager: Capturing datagrams to %1").arg(path));
+    return true;
+}
+
+// Stop recording datagrams
+void CommunicationManager::stopCapture()
+{
+    if (!capture)
+    {
+        return;
+    }
+    if (ioThread)
+    {
+        ioThread->setCapture(nullptr); // The thread may still be inside record(); the capture lives on, closed
+    }
+    captureFlushTimer->stop();
+    capture->close();
+}
+
+// True while datagrams are recorded
+bool CommunicationManager::isCapturing() const
+{
+    return capture && capture->isOpen();
+}
+
+// Stop the communication manager
+void CommunicationManager::stop()
+{
+    heartbeatTimer->stop();      // Stop the heartbeat timer
+    liveness->cancelAll();       // Drop the heartbeat deadlines
+    linkStatisticsTimer->stop(); // Stop the link statistics timer
+    if (ioThread)
+    {
+        ioThread->stop(); // Join the I/O thread and close its socket
+        ioThread.reset();
+    }
+    socket->close(); // Close the UDP socket
+}
+
+// Start the heartbeat, liveness and statistics timers
+void CommunicationManager::startTimers()
+{
+    heartbeatTimer->start(GlobalConstants::HEARTBEAT_INTERVAL_MS);                // Start the heartbeat timer with a 1-second interval
+    liveness->arm(AnsPeer, GlobalConstants::HEARTBEAT_TIMEOUT_MS);                // ANS must be heard from within the timeout
+    liveness->arm(LauncherPeer, GlobalConstants::HEARTBEAT_TIMEOUT_MS);           // Launcher must be heard from within the timeout
+    linkStatisticsTimer->start(GlobalConstants::LINK_STATISTICS_LOG_INTERVAL_MS); // Start the link statistics timer
+}
+
+// Start the network I/O thread
+bool CommunicationManager::startIOThread()
+{
+    if (qEnvironmentVariableIntValue("AKS_NET_IO_THREAD") == 0)
+    {
+        return false; // Disabled, QUdpSocket on the main thread is the default
+    }
+    if (!NetworkIOThread::isSupported())
+    {
+        LOG_WARNING("CommunicationManager: Network I/O thread is not supported on this platform");
+        return false;
+    }
+    if (!network.isIPv4())
+    {
+        LOG_WARNING("CommunicationManager: Network I/O thread handles IPv4 only, using QUdpSocket");
+        return false;
+    }
+
+    ioThread.reset(new NetworkIOThread([this]()
+                                       { scheduleDrain(); }));
+    if (isCapturing())
+    {
+        ioThread->setCapture(capture.get()); // Captured from the first batch
+    }
+    if (!ioThread->start(network))
+    {
+        LOG_ERROR(QString("CommunicationManager: Network I/O thread failed to bind to %1").arg(network.bind.toString()));
+        ioThread.reset();
+        return false;
+    }
+    LOG_INFO(QString("CommunicationManager: Bound with %1 on the network I/O thread").arg(network.toString()));
+    return true;
+}
+
+// True when a dedicated network I/O thread owns the socket
+bool CommunicationManager::usesIOThread() const
+{
+    return ioThread != nullptr;
+}
+
+// Shed, malformed and deferred datagrams since construction
+CommunicationManager::IngestStatistics CommunicationManager::ingestStatistics() const
+{
+    IngestStatistics statistics;
+    statistics.shedHeartbeats = ingest.shedHeartbeats();
+    statistics.shedPlatformInfo = ingest.shedPlatformInfo();
+    statistics.malformed = malformedCount;
+    statistics.deferredWakeups = deferredWakeups;
+    if (ioThread)
+    {
+        statistics.shedHeartbeats += ioThread->inboundQueue().shedHeartbeats();
+        statistics.shedPlatformInfo += ioThread->inboundQueue().shedPlatformInfo();
+        statistics.malformed += ioThread->malformedDatagrams();
+    }
+    return statistics;
+}
+
+// Queue one drainInbound call on the main thread (called on the I/O thread)
+void CommunicationManager::scheduleDrain()
+{
+    if (!drainPosted.exchange(true, std::memory_order_acq_rel))
+    {
+        QMetaObject::invokeMethod(this, "drainInbound", Qt::QueuedConnection); // One posted event per burst
+    }
+}
+
+// Dispatch messages queued by the network I/O thread
+void CommunicationManager::drainInbound()
+{
+    TRACE_SCOPE("CommunicationManager::drainInbound");
+    drainPosted.store(false, std::memory_order_release); // Messages arriving from now on post a new drain
+    if (!ioThread)
+    {
+        return; // Stopped after the drain was queued
+    }
+    IngestQueue::Entry inbound;
+    int budget = GlobalConstants::INGEST_BUDGET_PER_WAKEUP;
+    while (budget > 0 && ioThread->takeInbound(inbound))
+    {
+        dispatchMessage(inbound.message, inbound.sender, inbound.receivedNs);
+        --budget;
+    }
+    if (budget == 0)
+    {
+        // More may be waiting; let timers and UI events run before the rest
+        ++deferredWakeups;
+        budgetExhaustedMetric->increment();
+        scheduleDrain();
+    }
+}
+
+// Send a heartbeat message
+void CommunicationManager::sendHeartbeat()
+{
+    TRACE_SCOPE("CommunicationManager::sendHeartbeat");
+    if (network.usesMulticast())
+    {
+        // One datagram reaches every subsystem in the group, in an encoding all of them understand
+        sendHeartbeatTo(network.multicastGroup, multicastSentMetric, std::min(ansWireEncoding, launcherWireEncoding));
+    }
+    else
+    {
+        // Send the heartbeat message to both ANS and Launcher
+        sendHeartbeatTo(network.ans, ansSentMetric, ansWireEncoding);
+        sendHeartbeatTo(network.launcher, launcherSentMetric, launcherWireEncoding);
+    }
+    ++heartbeatSequence; // Every peer sees the same sequence number for one round
+    if (ioThread)
+    {
+        ioThread->flushSends(); // The heartbeats leave in one batch
+    }
+}
+
+// Send a datagram through the socket or the I/O thread
+void CommunicationManager::sendDatagram(const NetworkConfig::Endpoint &destination, Metrics::Counter *sentMetric,
+                                        const char *data, qint64 length)
+{
+    if (offline)
+    {
+        return; // Nobody to send to
+    }
+    if (capture)
+    {
+        capture->record(CaptureFormat::Sent, destination.port, clock->nowNs(), data, length);
+    }
+    sentMetric->increment();
+    if (ioThread)
+    {
+        ioThread->queueSend(destination.address.toIPv4Address(), destination.port, data, int(length));
+    }
+    else
+    {
+        socket->writeDatagram(data, length, destination.address, destination.port);
+    }
+}
+
+// Send one heartbeat in the encoding the receivers understand
+void CommunicationManager::sendHeartbeatTo(const NetworkConfig::Endpoint &destination, Metrics::Counter *sentMetric,
+                                           Protocol::Encoding encoding)
+{
+    if (encoding == Protocol::TextEncoding)
+    {
+        const qint64 length = sizeof(Protocol::AKS_HEARTBEAT_TEXT) - 1; // Legacy peers only accept the bare text
+        sendDatagram(destination, sentMetric, Protocol::AKS_HEARTBEAT_TEXT, length);
+        return;
+    }
+
+    // Peers that sent a sequence number get ours, with a timestamp they echo back for the RTT
+    Protocol::Message heartbeat;
+    heartbeat.type = Protocol::AKSHeartbeat;
+    heartbeat.hasSequence = true;
+    heartbeat.sequence = heartbeatSequence;
+    heartbeat.timestampNs = clock->nowNs();
+    int length = encoding == Protocol::BinaryEncoding
+                     ? Protocol::encodeBinary(heartbeat, sendBuffer, sizeof(sendBuffer))
+                     : Protocol::encodeTextHeartbeat(heartbeat, sendBuffer, sizeof(sendBuffer));
+    sendDatagram(destination, sentMetric, sendBuffer, length);
+}
+
+// Encoding used towards ANS
+Protocol::Encoding CommunicationManager::ansEncoding() const
+{
+    return ansWireEncoding;
+}
+
+// Encoding used towards Launcher
+Protocol::Encoding CommunicationManager::launcherEncoding() const
+{
+    return launcherWireEncoding;
+}
+
+// Switch a peer's encoding when it starts sending a different one
+void CommunicationManager::updatePeerEncoding(Protocol::Encoding &peerEncoding, Protocol::Encoding received, const char *peerName)
+{
+    if (peerEncoding == received)
+    {
+        return; // Nothing changed, the common case
+    }
+    peerEncoding = received;
+    const char *encodingName = received == Protocol::BinaryEncoding         ? "binary"
+                               : received == Protocol::ExtendedTextEncoding ? "extended text"
+                                                                            : "text";
+    LOG_INFO(QString("CommunicationManager: %1 now uses the %2 protocol").arg(peerName).arg(encodingName));
+}
+
+// Heartbeat link statistics for ANS
+LinkStatistics::Snapshot CommunicationManager::ansLinkStatistics() const
+{
+    return ansLink.snapshot();
+}
+
+// Heartbeat link statistics for Launcher
+LinkStatistics::Snapshot CommunicationManager::launcherLinkStatistics() const
+{
+    return launcherLink.snapshot();
+}
+
+// Feed a heartbeat's sequence, timestamp and echo into a peer's link statistics
+void CommunicationManager::recordHeartbeat(LinkStatistics &link, Metrics::Histogram *gapMetric, qint64 &lastHeartbeatNs,
+                                           const Protocol::Message &message, qint64 receivedNs)
+{
+    if (lastHeartbeatNs != 0)
+    {
+        gapMetric->observe(receivedNs - lastHeartbeatNs);
+    }
+    lastHeartbeatNs = receivedNs;
+    if (message.hasSequence)
+    {
+        link.recordHeartbeat(message.sequence, message.timestampNs, receivedNs);
+    }
+    if (message.hasEcho)
+    {
+        link.recordEcho(message.echoSequence, message.echoTimestampNs, message.echoDelayNs, receivedNs);
+    }
+}
+
+// Write the link statistics of both peers to the log
+void CommunicationManager::logLinkStatistics()
+{
+    logPeerStatistics("ANS", ansLink, ansLostAtLastLog);
+    logPeerStatistics("Launcher", launcherLink, launcherLostAtLastLog);
+}
+
+// Log one peer's link statistics
+void CommunicationManager::logPeerStatistics(const char *peerName, const LinkStatistics &link, quint64 &lostAtLastLog)
+{
+    LinkStatistics::Snapshot stats = link.snapshot();
+    if (stats.received == 0)
+    {
+        return; // Legacy peer without sequence numbers, or nothing received yet
+    }
+
+    // New losses are logged as a warning so a degrading link stands out before the heartbeat timeout
+    Logger::LogLevel level = stats.lost > lostAtLastLog ? Logger::Warning : Logger::Info;
+    lostAtLastLog = stats.lost;
+    LOG_EVENT(level, BinaryLog::LinkStatisticsReport, peerName,
+              stats.rttLastNs / 1000, stats.rttMeanNs / 1000, stats.rttMaxNs / 1000, stats.jitterNs / 1000,
+              qint64(stats.received), qint64(stats.lost), qint64(stats.reordered), qint64(stats.duplicates));
+}
+
+// Read pending datagrams from the socket
+void CommunicationManager::readPendingDatagrams()
+{
+    TRACE_SCOPE("CommunicationManager::readPendingDatagrams");
+    readPosted = false;
+    int budget = GlobalConstants::INGEST_BUDGET_PER_WAKEUP;
+    for (; budget > 0 && socket->hasPendingDatagrams(); --budget)
+    {
+        quint16 senderPort = 0;
+        // Read straight into the reusable buffer; the address is needed to tell peers on different hosts apart
+        qint64 size = socket->readDatagram(receiveBuffer.data(), receiveBuffer.size(), &senderAddress, &senderPort);
+        if (size < 0)
+        {
+            break; // Nothing could be read
+        }
+        const qint64 receivedNs = clock->nowNs();
+        if (capture)
+        {
+            capture->record(CaptureFormat::Received, senderPort, receivedNs, receiveBuffer.constData(), size);
+        }
+        ingestDatagram(receiveBuffer.constData(), size, network.senderOf(senderAddress, senderPort), receivedNs);
+    }
+
+    // Heartbeats in arrival order, the newest platform info once
+    IngestQueue::Entry entry;
+    while (ingest.take(entry))
+    {
+        dispatchMessage(entry.message, entry.sender, entry.receivedNs);
+    }
+
+    if (budget == 0 && socket->hasPendingDatagrams() && !readPosted)
+    {
+        // A flood: leave the rest for the next event loop pass so timers and UI events are not starved
+        readPosted = true;
+        ++deferredWakeups;
+        budgetExhaustedMetric->increment();
+        QMetaObject::invokeMethod(this, "readPendingDatagrams", Qt::QueuedConnection);
+    }
+}
+
+// Decode a datagram read from the socket into the ingest queue
+void CommunicationManager::ingestDatagram(const char *data, qint64 size, NetworkConfig::Sender sender, qint64 receivedNs)
+{
+    if (sender == NetworkConfig::UnknownSender)
+    {
+        unknownSenderMetric->increment();
+        return; // Not decoded: a stranger's datagrams never reach the queue
+    }
+    IngestQueue::Entry entry;
+    if (!Protocol::decode(data, size, entry.message))
+    {
+        ++malformedCount;
+        parseFailureMetric->increment();
+        return; // Unknown or malformed message
+    }
+    if (entry.message.type == Protocol::PlatformInfo && sender != NetworkConfig::AnsSender)
+    {
+        return; // Only ANS reports the position; another peer's must not take the latest-wins slot
+    }
+    entry.sender = sender;
+    entry.receivedNs = receivedNs;
+    ingest.push(entry); // Heartbeats are kept, platform info is latest-wins
+}
+
+// Process one received datagram
+void CommunicationManager::handleDatagram(const char *data, qint64 size, quint16 senderPort)
+{
+    TRACE_SCOPE("CommunicationManager::handleDatagram");
+    Protocol::Message message;
+    if (!Protocol::decode(data, size, message))
+    {
+        ++malformedCount;
+        parseFailureMetric->increment();
+        return; // Unknown or malformed message
+    }
+    NetworkConfig::Sender sender = NetworkConfig::UnknownSender;
+    if (senderPort == network.ans.port)
+    {
+        sender = NetworkConfig::AnsSender;
+    }
+    else if (senderPort == network.launcher.port)
+    {
+        sender = NetworkConfig::LauncherSender;
+    }
+    dispatchMessage(message, sender, clock->nowNs());
+}
+
+// Dispatch a decoded message from one of the peers
+void CommunicationManager::dispatchMessage(const Protocol::Message &message, NetworkConfig::Sender sender, qint64 receivedNs)
+{
+    // Check if the sender is ANS
+    if (sender == NetworkConfig::AnsSender)
+    {
+        ansReceivedMetric->increment();
+        if (message.type == Protocol::ANSHeartbeat)
+        {
+            updatePeerEncoding(ansWireEncoding, message.encoding, "ANS");                             // Answer in the encoding ANS speaks
+            recordHeartbeat(ansLink, ansHeartbeatGapMetric, ansLastHeartbeatNs, message, receivedNs); // Track the link health
+            processANSHeartbeat();                                                                    // Process ANS heartbeat
+        }
+        else if (message.type == Protocol::PlatformInfo)
+        {
+            processPlatformInfo(message); // Process platform info
+        }
+    }
+    // Check if the sender is Launcher
+    else if (sender == NetworkConfig::LauncherSender)
+    {
+        launcherReceivedMetric->increment();
+        if (message.type == Protocol::LauncherHeartbeat)
+        {
+            updatePeerEncoding(launcherWireEncoding, message.encoding, "Launcher");                                  // Answer in the encoding Launcher speaks
+            recordHeartbeat(launcherLink, launcherHeartbeatGapMetric, launcherLastHeartbeatNs, message, receivedNs); // Track the link health
+            processLauncherHeartbeat();                                                                              // Process Launcher heartbeat
+        }
+    }
+    else
+    {
+        unknownSenderMetric->increment();
+    }
+}
+
+// Process ANS heartbeat
+void CommunicationManager::processANSHeartbeat()
+{
+    liveness->arm(AnsPeer, GlobalConstants::HEARTBEAT_TIMEOUT_MS); // Push the ANS deadline out
+    emit ansHeartbeatReceived();                                   // Emit signal that ANS heartbeat was received
+}
+
+// Process Launcher heartbeat
+void CommunicationManager::processLauncherHeartbeat()
+{
+    liveness->arm(LauncherPeer, GlobalConstants::HEARTBEAT_TIMEOUT_MS); // Push the Launcher deadline out
+    emit launcherHeartbeatReceived();                                   // Emit signal that Launcher heartbeat was received
+}
+
+// Check if there has been a recent ANS heartbeat
+bool CommunicationManager::hasRecentANSHeartbeat() const
+{
+    return liveness->isArmed(AnsPeer); // The deadline is pushed out by every heartbeat
+}
+
+// Check if there has been a recent Launcher heartbeat
+bool CommunicationManager::hasRecentLauncherHeartbeat() const
+{
+    return liveness->isArmed(LauncherPeer); // The deadline is pushed out by every heartbeat
+}
+
+// Process platform information received from datagrams
+void CommunicationManager::processPlatformInfo(const Protocol::Message &message)
+{
+    TRACE_SCOPE("CommunicationManager::processPlatformInfo");
+    // The fields were parsed in place by Protocol::decode
+    emit platformInfoReceived(message.latitude, message.longitude, message.altitude); // Emit signal with platform info
+}
+
+// A peer's heartbeat deadline passed
+void CommunicationManager::onLivenessExpired(int peer)
+{
+    if (peer == AnsPeer)
+    {
+        emit ansCommunicationLost(); // No ANS heartbeat within the timeout
+    }
+    else if (peer == LauncherPeer)
+    {
+        emit launcherCommunicationLost(); // No Launcher heartbeat within the timeout
+    }
+}
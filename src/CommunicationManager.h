@@ -1,66 +1,193 @@
-#ifndef COMMUNICATIONMANAGER_H
-#define COMMUNICATIONMANAGER_H
-
-#include <QObject>
-#include <QUdpSocket>
-#include <QTimer>
-#include <QDateTime>
-
-// Class responsible for managing communication with ANS and Launcher
-class CommunicationManager : public QObject
-{
-    Q_OBJECT
-
-public:
-    // Constructor and Destructor
-    explicit CommunicationManager(QObject *parent = nullptr); // Initializes the communication manager
-    ~CommunicationManager();                                  // Cleans up resources
-
-    // Check if there has been a recent heartbeat from ANS or Launcher
-    bool hasRecentANSHeartbeat() const;
-    bool hasRecentLauncherHeartbeat() const;
-
-    // Update the last heartbeat timestamps
-    void updateANSLastHeartbeat();
-    void updateLauncherLastHeartbeat();
-
-    // Start and stop communication
-    void start();
-    void stop();
-
-signals:
-    // Signals emitted on receiving heartbeats or communication loss
-    void ansHeartbeatReceived();
-    void launcherHeartbeatReceived();
-    void ansCommunicationLost();
-    void launcherCommunicationLost();
-    void platformInfoReceived(double latitude, double longitude, double altitude);
-
-private slots:
-    // Private slots for handling heartbeat sending and reading datagrams
-    void sendHeartbeat();
-    void readPendingDatagrams();
-    void checkCommunicationStatus();
-
-private:
-    QUdpSocket *socket;              // Socket for UDP communication
-    QTimer *heartbeatTimer;          // Timer for sending heartbeats
-    QTimer *communicationCheckTimer; // Timer for checking communication status
-
-    const quint16 AKS_PORT = 5000;      // Port for AKS communication
-    const quint16 ANS_PORT = 5001;      // Port for ANS communication
-    const quint16 LAUNCHER_PORT = 5002; // Port for Launcher communication
-
-    int ansMissedHeartbeats;      // Counter for missed ANS heartbeats
-    int launcherMissedHeartbeats; // Counter for missed Launcher heartbeats
-
-    // Process received heartbeats and platform info
-    void processANSHeartbeat();
-    void processLauncherHeartbeat();
-    void processPlatformInfo(const QByteArray &data);
-
-    QDateTime lastANSHeartbeat;      // Timestamp of the last ANS heartbeat
-    QDateTime lastLauncherHeartbeat; // Timestamp of the last Launcher heartbeat
-};
-
-#endif
+#ifndef COMMUNICATIONMANAGER_H
+#define COMMUNICATIONMANAGER_H
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <atomic>
+#include <memory>
+#include "DeadlineScheduler.h"
+#include "IngestQueue.h"
+#include "LinkStatistics.h"
+#include "MonotonicClock.h"
+#include "NetworkConfig.h"
+#include "Protocol.h"
+
+class DatagramCapture;
+class NetworkIOThread;
+
+namespace Metrics
+{
+    class Counter;
+    class Histogram;
+}
+
+// Class responsible for managing communication with ANS and Launcher
+class CommunicationManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Overload accounting of the receive path
+    struct IngestStatistics
+    {
+        quint64 shedHeartbeats;   // Heartbeats dropped on a full ingest queue
+        quint64 shedPlatformInfo; // Platform info superseded by a newer position before dispatch
+        quint64 malformed;        // Datagrams that were oversized, unknown or malformed
+        quint64 deferredWakeups;  // Wakeups that used up their budget and left the rest for the next event loop pass
+    };
+
+    // Constructor and Destructor; timers and heartbeat ages run on 'clock' (the steady clock if null)
+    explicit CommunicationManager(QObject *parent = nullptr, MonotonicClock *clock = nullptr); // Initializes the communication manager
+    ~CommunicationManager();                                                                   // Cleans up resources
+
+    // Check if a heartbeat from ANS or Launcher arrived within the heartbeat timeout
+    bool hasRecentANSHeartbeat() const;
+    bool hasRecentLauncherHeartbeat() const;
+
+    // Endpoints and multicast settings used by the next start(); read from the environment by default
+    void setNetworkConfig(const NetworkConfig &config);
+    const NetworkConfig &networkConfig() const;
+
+    // Start and stop communication; start() also begins a capture if AKS_CAPTURE names a file
+    void start();
+    void stop();
+
+    // Start the timers without a socket, for feeding datagrams through handleDatagram() (replay);
+    // outgoing datagrams are discarded
+    void startOffline();
+
+    // Record every received and sent datagram to 'path' (appended); returns false if it cannot be opened
+    bool startCapture(const QString &path);
+    void stopCapture();
+    bool isCapturing() const;
+
+    // Process one received datagram at once, without the ingest queue (replay, benchmarks);
+    // captures keep only the port, so the peer is recognised by 'senderPort' alone
+    void handleDatagram(const char *data, qint64 size, quint16 senderPort);
+
+    // Heartbeat link statistics (RTT, jitter, loss, reordering) per peer
+    LinkStatistics::Snapshot ansLinkStatistics() const;
+    LinkStatistics::Snapshot launcherLinkStatistics() const;
+
+    // True when a dedicated network I/O thread owns the socket (AKS_NET_IO_THREAD=1)
+    bool usesIOThread() const;
+
+    // Shed, malformed and deferred datagrams since construction (I/O thread included)
+    IngestStatistics ingestStatistics() const;
+
+    // Encoding used towards each peer; switches to binary once the peer has sent a binary message
+    Protocol::Encoding ansEncoding() const;
+    Protocol::Encoding launcherEncoding() const;
+
+signals:
+    // Signals emitted on receiving heartbeats or communication loss;
+    // a loss is signalled once, exactly HEARTBEAT_TIMEOUT_MS after the peer's last heartbeat
+    void ansHeartbeatReceived();
+    void launcherHeartbeatReceived();
+    void ansCommunicationLost();
+    void launcherCommunicationLost();
+    void platformInfoReceived(double latitude, double longitude, double altitude);
+
+private slots:
+    // Private slots for handling heartbeat sending and reading datagrams
+    void sendHeartbeat();
+    void readPendingDatagrams();      // Read up to one budget of datagrams, then dispatch them
+    void onLivenessExpired(int peer); // A peer's heartbeat deadline passed
+    void drainInbound();              // Dispatch messages queued by the network I/O thread
+    void logLinkStatistics();         // Write the link statistics of both peers to the log
+
+private:
+    // Keys of the peers in the liveness scheduler
+    enum Peer
+    {
+        AnsPeer = 0,
+        LauncherPeer = 1
+    };
+
+    MonotonicClock *clock;           // Source of time and timers
+    QUdpSocket *socket;              // Socket for UDP communication
+    ClockTimer *heartbeatTimer;      // Timer for sending heartbeats
+    DeadlineScheduler *liveness;     // Heartbeat deadline of each peer
+    ClockTimer *linkStatisticsTimer; // Timer for logging link statistics
+    QByteArray receiveBuffer;        // Preallocated buffer every datagram is read into
+    QHostAddress senderAddress;      // Source address of the datagram last read
+    NetworkConfig network;           // Bind endpoint, peer endpoints and heartbeat group
+
+    IngestQueue ingest;                        // Datagrams read from the QUdpSocket in one wakeup, before dispatch
+    bool readPosted;                           // A readPendingDatagrams call is already queued
+    quint64 malformedCount;                    // Undecodable datagrams read on this thread
+    quint64 deferredWakeups;                   // Wakeups that ran out of budget
+    std::unique_ptr<NetworkIOThread> ioThread; // Optional I/O thread that owns the socket instead of QUdpSocket
+    std::atomic<bool> drainPosted;             // A drainInbound call is already queued on the main thread
+    std::unique_ptr<DatagramCapture> capture;  // Datagram recorder, opened by startCapture()
+    ClockTimer *captureFlushTimer;             // Writes the capture's last batch once traffic stops, created with it
+    bool offline;                              // Started by startOffline(), there is no socket
+
+    Protocol::Encoding ansWireEncoding;                  // Encoding understood by ANS
+    Protocol::Encoding launcherWireEncoding;             // Encoding understood by Launcher
+    quint32 heartbeatSequence;                           // Sequence number of the next heartbeat
+    char sendBuffer[Protocol::MAX_ENCODED_MESSAGE_SIZE]; // Buffer outgoing messages are encoded into
+
+    LinkStatistics ansLink;        // Heartbeat statistics for ANS
+    LinkStatistics launcherLink;   // Heartbeat statistics for Launcher
+    quint64 ansLostAtLastLog;      // ANS loss counter when the statistics were last logged
+    quint64 launcherLostAtLastLog; // Launcher loss counter when the statistics were last logged
+
+    qint64 ansLastHeartbeatNs;      // Clock time of the last ANS heartbeat, 0 before the first
+    qint64 launcherLastHeartbeatNs; // Clock time of the last Launcher heartbeat, 0 before the first
+
+    // Process-wide metrics (see Metrics::Registry), shared by every manager instance
+    Metrics::Counter *ansReceivedMetric;            // Datagrams from ANS
+    Metrics::Counter *launcherReceivedMetric;       // Datagrams from Launcher
+    Metrics::Counter *ansSentMetric;                // Datagrams to ANS
+    Metrics::Counter *launcherSentMetric;           // Datagrams to Launcher
+    Metrics::Counter *multicastSentMetric;          // Heartbeats to the multicast group
+    Metrics::Counter *parseFailureMetric;           // Unknown or malformed datagrams
+    Metrics::Counter *unknownSenderMetric;          // Datagrams from neither ANS nor Launcher
+    Metrics::Counter *budgetExhaustedMetric;        // Receive wakeups that hit INGEST_BUDGET_PER_WAKEUP
+    Metrics::Histogram *ansHeartbeatGapMetric;      // Time between two ANS heartbeats
+    Metrics::Histogram *launcherHeartbeatGapMetric; // Time between two Launcher heartbeats
+
+    // Start the heartbeat, liveness and statistics timers once the socket is up
+    void startTimers();
+
+    // Start the network I/O thread; returns false if it is disabled or unavailable
+    bool startIOThread();
+
+    // Set up multicast sending on the QUdpSocket; returns false if the system refuses it
+    bool setUpMulticast();
+
+    // Queue one drainInbound call on the main thread (called on the I/O thread)
+    void scheduleDrain();
+
+    // Decode a datagram read from the socket into the ingest queue; datagrams from unknown senders
+    // and malformed ones are counted and dropped
+    void ingestDatagram(const char *data, qint64 size, NetworkConfig::Sender sender, qint64 receivedNs);
+
+    // Dispatch a decoded message from 'sender', received at 'receivedNs' (clock time)
+    void dispatchMessage(const Protocol::Message &message, NetworkConfig::Sender sender, qint64 receivedNs);
+
+    // Feed a heartbeat's sequence, timestamp and echo into a peer's link statistics, and its gap into the metrics
+    void recordHeartbeat(LinkStatistics &link, Metrics::Histogram *gapMetric, qint64 &lastHeartbeatNs,
+                         const Protocol::Message &message, qint64 receivedNs);
+
+    // Log one peer's link statistics; warns if heartbeats were lost since the last report
+    void logPeerStatistics(const char *peerName, const LinkStatistics &link, quint64 &lostAtLastLog);
+
+    // Send a datagram through the socket or the I/O thread, counted in 'sentMetric'
+    void sendDatagram(const NetworkConfig::Endpoint &destination, Metrics::Counter *sentMetric, const char *data, qint64 length);
+
+    // Send one heartbeat in the encoding the receivers understand
+    void sendHeartbeatTo(const NetworkConfig::Endpoint &destination, Metrics::Counter *sentMetric, Protocol::Encoding encoding);
+
+    // Switch a peer's encoding when it starts sending a different one
+    void updatePeerEncoding(Protocol::Encoding &peerEncoding, Protocol::Encoding received, const char *peerName);
+
+    // Process received heartbeats and platform info
+    void processANSHeartbeat();
+    void processLauncherHeartbeat();
+    void processPlatformInfo(const Protocol::Message &message);
+};
+
+#endif
@@ -1,84 +1,197 @@
-#include "ConfigReader.h"
-#include <QFile>
-#include <QTextStream>
-#include <QDebug>
-#include <QDir>
-#include <QFileInfo>
-
-// Constructor for ConfigReader
-ConfigReader::ConfigReader(QObject *parent)
-    : QObject(parent)
-{
-}
-
-// Load missile configuration from a specified file
-bool ConfigReader::loadMissileConfig(const QString &filename)
-{
-    QFile file(filename); // Create a QFile object for the given filename
-    if (!file.exists())   // Check if the file exists
-    {
-        lastError = QString("Config file does not exist: %1").arg(QDir::toNativeSeparators(QFileInfo(file).absoluteFilePath()));
-        qDebug() << lastError; // Log the error
-        return false;          // Return false if the file does not exist
-    }
-
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) // Attempt to open the file
-    {
-        lastError = QString("Failed to open config file: %1. Error: %2").arg(filename).arg(file.errorString());
-        qDebug() << lastError; // Log the error
-        return false;          // Return false if the file cannot be opened
-    }
-
-    missileConfigs.clear(); // Clear any existing missile configurations
-    QTextStream in(&file);  // Create a QTextStream to read the file
-    int lineNumber = 0;     // Initialize line number for error reporting
-    while (!in.atEnd())     // Read the file line by line
-    {
-        QString line = in.readLine().trimmed();     // Read and trim the line
-        lineNumber++;                               // Increment line number
-        if (line.isEmpty() || line.startsWith("#")) // Skip empty lines and comments
-        {
-            continue; // Go to the next line
-        }
-
-        QStringList parts = line.split(","); // Split the line by commas
-        if (parts.size() != 3)               // Check if the line has the correct number of parts
-        {
-            lastError = QString("Invalid format in config file at line %1: %2").arg(lineNumber).arg(line);
-            qDebug() << lastError; // Log the error
-            file.close();          // Close the file
-            return false;          // Return false for invalid format
-        }
-
-        bool ok;
-        int index = parts[0].toInt(&ok);   // Convert the first part to an integer
-        if (!ok || index < 0 || index > 3) // Validate the index
-        {
-            lastError = QString("Invalid missile index at line %1: %2").arg(lineNumber).arg(parts[0]);
-            qDebug() << lastError; // Log the error
-            file.close();          // Close the file
-            return false;          // Return false for invalid index
-        }
-
-        QString type = parts[1].trimmed();                       // Get the missile type
-        bool healthy = (parts[2].trimmed().toLower() == "true"); // Determine if the missile is healthy
-
-        missileConfigs.append({index, type, healthy}); // Append the configuration to the list
-    }
-
-    file.close();                                                                           // Close the file after reading
-    qDebug() << "Successfully loaded" << missileConfigs.size() << "missile configurations"; // Log success message
-    return true;                                                                            // Return true if loading was successful
-}
-
-// Get the list of missile configurations
-QVector<MissileConfig> ConfigReader::getMissileConfigs() const
-{
-    return missileConfigs; // Return the missile configurations
-}
-
-// Get the last error message
-QString ConfigReader::getLastError() const
-{
-    return lastError; // Return the last error message
+#include "ConfigReader.h"
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include "GlobalConstants.h"
+
+// Constructor for ConfigReader
+ConfigReader::ConfigReader(QObject *parent)
+    : QObject(parent), watcher(nullptr), reloadTimer(nullptr)
+{
+}
+
+// Load missile configuration from a specified file
+bool ConfigReader::loadMissileConfig(const QString &filename)
+{
+    QVector<MissileConfig> configs;
+    if (!parseMissileConfig(filename, configs, lastError)) // Parse into a new list, the current one stays valid
+    {
+        qDebug() << lastError; // Log the error
+        return false;          // Return false if the file cannot be used
+    }
+
+    missileConfigs = configs;                                                               // Take the new configuration as a whole
+    qDebug() << "Successfully loaded" << missileConfigs.size() << "missile configurations"; // Log success message
+    return true;                                                                            // Return true if loading was successful
+}
+
+// Parse a missile configuration file
+bool ConfigReader::parseMissileConfig(const QString &filename, QVector<MissileConfig> &configs, QString &error)
+{
+    QFile file(filename); // Create a QFile object for the given filename
+    if (!file.exists())   // Check if the file exists
+    {
+        error = QString("Config file does not exist: %1").arg(QDir::toNativeSeparators(QFileInfo(file).absoluteFilePath()));
+        return false; // Return false if the file does not exist
+    }
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) // Attempt to open the file
+    {
+        error = QString("Failed to open config file: %1. Error: %2").arg(filename).arg(file.errorString());
+        return false; // Return false if the file cannot be opened
+    }
+
+    configs.clear();       // Start from an empty list
+    QTextStream in(&file); // Create a QTextStream to read the file
+    int lineNumber = 0;    // Initialize line number for error reporting
+    while (!in.atEnd())    // Read the file line by line
+    {
+        QString line = in.readLine().trimmed();     // Read and trim the line
+        lineNumber++;                               // Increment line number
+        if (line.isEmpty() || line.startsWith("#")) // Skip empty lines and comments
+        {
+            continue; // Go to the next line
+        }
+
+        QStringList parts = line.split(","); // Split the line by commas
+        if (parts.size() != 3)               // Check if the line has the correct number of parts
+        {
+            error = QString("Invalid format in config file at line %1: %2").arg(lineNumber).arg(line);
+            return false; // Return false for invalid format
+        }
+
+        bool ok;
+        int index = parts[0].toInt(&ok);   // Convert the first part to an integer
+        if (!ok || index < 0 || index > 3) // Validate the index
+        {
+            error = QString("Invalid missile index at line %1: %2").arg(lineNumber).arg(parts[0]);
+            return false; // Return false for invalid index
+        }
+
+        QString type = parts[1].trimmed();                       // Get the missile type
+        bool healthy = (parts[2].trimmed().toLower() == "true"); // Determine if the missile is healthy
+        if (type.toUtf8().size() >= Events::MissileStatus::TYPE_SIZE)
+        {
+            // The status events carry the type in a fixed buffer; a cut name would no longer match the file
+            error = QString("Missile type longer than %1 bytes at line %2: %3").arg(Events::MissileStatus::TYPE_SIZE - 1).arg(lineNumber).arg(type);
+            return false;
+        }
+
+        configs.append({index, type, healthy}); // Append the configuration to the list
+    }
+    return true; // The whole file is valid
+}
+
+// Watch the configuration file for changes
+void ConfigReader::watchMissileConfig(const QString &filename)
+{
+    if (!watcher)
+    {
+        watcher = new QFileSystemWatcher(this);
+        reloadTimer = new QTimer(this);
+        reloadTimer->setSingleShot(true);
+        reloadTimer->setInterval(GlobalConstants::CONFIG_RELOAD_DELAY_MS);
+        connect(watcher, &QFileSystemWatcher::fileChanged, this, &ConfigReader::onWatchedPathChanged);
+        connect(watcher, &QFileSystemWatcher::directoryChanged, this, &ConfigReader::onWatchedPathChanged);
+        connect(reloadTimer, &QTimer::timeout, this, &ConfigReader::reloadMissileConfig);
+    }
+    watchedFile = QFileInfo(filename).absoluteFilePath();
+    watcher->addPath(QFileInfo(watchedFile).absolutePath()); // Sees the file being replaced or created
+    if (QFileInfo::exists(watchedFile))
+    {
+        watcher->addPath(watchedFile);
+    }
+}
+
+// Restart the debounce timer
+void ConfigReader::onWatchedPathChanged()
+{
+    reloadTimer->start(); // Editors write in several steps; reload once they are done
+}
+
+// Parse the watched file and report what changed
+void ConfigReader::reloadMissileConfig()
+{
+    if (QFileInfo::exists(watchedFile) && !watcher->files().contains(watchedFile))
+    {
+        watcher->addPath(watchedFile); // A replaced file is a new inode, watch it again
+    }
+
+    QVector<MissileConfig> configs;
+    QString error;
+    bool parsed = parseMissileConfig(watchedFile, configs, error);
+    if (parsed && configs.isEmpty())
+    {
+        // Most likely caught in the middle of a save; taking it would report every missile as removed
+        error = QString("Missile configuration %1 has no entries, ignoring it").arg(watchedFile);
+        parsed = false;
+    }
+    if (!parsed)
+    {
+        lastError = error;
+        qDebug() << lastError;                 // Log the error
+        emit missileConfigReloadFailed(error); // The running configuration is left alone
+        return;
+    }
+
+    QVector<MissileConfig> changed = diffMissileConfigs(missileConfigs, configs);
+    missileConfigs = configs; // Swap in the new configuration as a whole
+    if (!changed.isEmpty())
+    {
+        emit missileConfigChanged(changed);
+    }
+}
+
+// Entries of 'next' that differ from 'previous'
+QVector<MissileConfig> ConfigReader::diffMissileConfigs(const QVector<MissileConfig> &previous, const QVector<MissileConfig> &next)
+{
+    // Effective configuration per index; a later line for the same index wins, as when it is applied in order
+    const int missileCount = 4;
+    MissileConfig before[missileCount];
+    MissileConfig after[missileCount];
+    bool present[2][missileCount] = {};
+    for (const MissileConfig &config : previous)
+    {
+        before[config.index] = config;
+        present[0][config.index] = true;
+    }
+    for (const MissileConfig &config : next)
+    {
+        after[config.index] = config;
+        present[1][config.index] = true;
+    }
+
+    QVector<MissileConfig> changed;
+    for (int index = 0; index < missileCount; ++index)
+    {
+        if (!present[0][index] && !present[1][index])
+        {
+            continue; // Not configured before or now
+        }
+        if (!present[1][index])
+        {
+            changed.append({index, QString(), false}); // Removed from the file
+        }
+        else if (!present[0][index] || before[index].type != after[index].type || before[index].healthy != after[index].healthy)
+        {
+            changed.append(after[index]); // Added or modified
+        }
+    }
+    return changed;
+}
+
+// Get the list of missile configurations
+QVector<MissileConfig> ConfigReader::getMissileConfigs() const
+{
+    return missileConfigs; // Return the missile configurations
+}
+
+// Get the last error message
+QString ConfigReader::getLastError() const
+{
+    return lastError; // Return the last error message
 }
\ No newline at end of file
@@ -1,34 +1,63 @@
-#ifndef CONFIGREADER_H
-#define CONFIGREADER_H
-
-#include <QObject>
-#include <QVector>
-#include <QString>
-#include "AKSCore.h"
-
-class ConfigReader : public QObject
-{
-    Q_OBJECT
-
-public:
-    // Constructor: Initializes the ConfigReader with an optional parent QObject
-    explicit ConfigReader(QObject *parent = nullptr);
-
-    // Loads missile configuration from a specified file
-    bool loadMissileConfig(const QString &filename);
-
-    // Returns a QVector containing all loaded MissileConfig objects
-    QVector<MissileConfig> getMissileConfigs() const;
-
-    // Returns the last error message encountered during operations
-    QString getLastError() const;
-
-private:
-    // Stores the missile configurations loaded from the file
-    QVector<MissileConfig> missileConfigs;
-
-    // Holds the last error message for debugging purposes
-    QString lastError;
-};
-
+#ifndef CONFIGREADER_H
+#define CONFIGREADER_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include "AKSCore.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+class ConfigReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Constructor: Initializes the ConfigReader with an optional parent QObject
+    explicit ConfigReader(QObject *parent = nullptr);
+
+    // Loads missile configuration from a specified file; on failure the previous configuration is kept
+    bool loadMissileConfig(const QString &filename);
+
+    // Watch the file for changes and reload it when it changes (see missileConfigChanged).
+    // The directory is watched too, so a file replaced by an editor or created later is picked up.
+    void watchMissileConfig(const QString &filename);
+
+    // Compare two configurations by missile index; returns the entries of 'next' that differ from 'previous'.
+    // A missile missing from 'next' is returned as unhealthy with an empty type, as it would be after a restart.
+    static QVector<MissileConfig> diffMissileConfigs(const QVector<MissileConfig> &previous, const QVector<MissileConfig> &next);
+
+    // Returns a QVector containing all loaded MissileConfig objects
+    QVector<MissileConfig> getMissileConfigs() const;
+
+    // Returns the last error message encountered during operations
+    QString getLastError() const;
+
+signals:
+    // A watched file was reloaded; 'changed' holds only the missiles whose configuration differs
+    void missileConfigChanged(const QVector<MissileConfig> &changed);
+
+    // A watched file changed but is invalid; the previous configuration stays in effect
+    void missileConfigReloadFailed(const QString &error);
+
+private slots:
+    void onWatchedPathChanged(); // Restart the debounce timer
+    void reloadMissileConfig();  // Parse the watched file and report what changed
+
+private:
+    // Parse 'filename' into 'configs'; returns false and sets 'error' if the file cannot be read or is invalid
+    static bool parseMissileConfig(const QString &filename, QVector<MissileConfig> &configs, QString &error);
+
+    // Stores the missile configurations loaded from the file
+    QVector<MissileConfig> missileConfigs;
+
+    // Holds the last error message for debugging purposes
+    QString lastError;
+
+    QFileSystemWatcher *watcher; // Watches the configuration file and its directory, created on demand
+    QTimer *reloadTimer;         // Waits for a burst of change notifications to settle
+    QString watchedFile;         // File reloaded on changes
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "DatagramCapture.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <cstring>
+#include "GlobalConstants.h"
+#include "MonotonicTime.h"
+
+namespace CaptureFormat
+{
+    // Append a file header to a buffer
+    void appendFileHeader(QByteArray &out, qint64 wallClockMs, qint64 monotonicNs)
+    {
+        uchar fields[FILE_HEADER_SIZE - sizeof(FILE_MAGIC)];
+        qToLittleEndian(FORMAT_VERSION, fields);
+        qToLittleEndian(wallClockMs, fields + 4);
+        qToLittleEndian(monotonicNs, fields + 12);
+        out.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+        out.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+    }
+
+    // Check a file header
+    bool readFileHeader(const char *data, qint64 size, qint64 *wallClockMs, qint64 *monotonicNs)
+    {
+        if (size < FILE_HEADER_SIZE || std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        {
+            return false; // Not a capture session header
+        }
+        const uchar *fields = reinterpret_cast<const uchar *>(data + sizeof(FILE_MAGIC));
+        if (qFromLittleEndian<quint32>(fields) != FORMAT_VERSION)
+        {
+            return false; // Written by an incompatible version
+        }
+        *wallClockMs = qFromLittleEndian<qint64>(fields + 4);
+        *monotonicNs = qFromLittleEndian<qint64>(fields + 12);
+        return true;
+    }
+
+    // Append a record to a buffer
+    void appendRecord(QByteArray &out, Direction direction, quint16 peerPort, qint64 timestampNs,
+                      const char *data, quint16 length)
+    {
+        uchar header[RECORD_HEADER_SIZE];
+        qToLittleEndian(timestampNs, header);
+        qToLittleEndian(peerPort, header + 8);
+        qToLittleEndian(length, header + 10);
+        header[12] = direction;
+        out.append(reinterpret_cast<const char *>(header), RECORD_HEADER_SIZE);
+        out.append(data, length);
+    }
+
+    // Read one record
+    bool readRecord(const char *&cursor, const char *end, Record &record)
+    {
+        if (end - cursor < RECORD_HEADER_SIZE)
+        {
+            return false; // Truncated header
+        }
+        const uchar *header = reinterpret_cast<const uchar *>(cursor);
+        record.timestampNs = qFromLittleEndian<qint64>(header);
+        record.peerPort = qFromLittleEndian<quint16>(header + 8);
+        record.length = qFromLittleEndian<quint16>(header + 10);
+        record.direction = header[12] == Sent ? Sent : Received;
+        if (end - cursor - RECORD_HEADER_SIZE < record.length)
+        {
+            return false; // Truncated datagram, e.g. the process died mid-write
+        }
+        record.data = cursor + RECORD_HEADER_SIZE;
+        cursor += RECORD_HEADER_SIZE + record.length;
+        return true;
+    }
+}
+
+// Constructor for DatagramCapture
+DatagramCapture::DatagramCapture()
+    : batchStartNs(0), records(0)
+{
+}
+
+// Destructor for DatagramCapture
+DatagramCapture::~DatagramCapture()
+{
+    close();
+}
+
+// Open 'path' for appending and start a new capture session
+bool DatagramCapture::open(const QString &path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.isOpen())
+    {
+        writeBatchLocked();
+        file.close();
+    }
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        return false;
+    }
+    batch.resize(0);
+    batch.reserve(GlobalConstants::CAPTURE_BATCH_BYTES + GlobalConstants::MAX_DATAGRAM_SIZE);
+    CaptureFormat::appendFileHeader(batch, QDateTime::currentMSecsSinceEpoch(), MonotonicTime::nowNs());
+    writeBatchLocked(); // The header goes out at once, so even an empty session is visible
+    records = 0;
+    return true;
+}
+
+// Write what is left and close the file
+void DatagramCapture::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.isOpen())
+    {
+        writeBatchLocked();
+        file.close();
+    }
+}
+
+// True between open() and close()
+bool DatagramCapture::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return file.isOpen();
+}
+
+// Record one datagram
+void DatagramCapture::record(CaptureFormat::Direction direction, quint16 peerPort, qint64 timestampNs, const char *data, qint64 length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.isOpen() || length < 0 || length > 0xFFFF)
+    {
+        return;
+    }
+    if (batch.isEmpty())
+    {
+        batchStartNs = timestampNs;
+    }
+    CaptureFormat::appendRecord(batch, direction, peerPort, timestampNs, data, quint16(length));
+    ++records;
+
+    // Write in large batches, but never keep records in memory for more than the flush interval
+    const qint64 flushIntervalNs = qint64(GlobalConstants::CAPTURE_FLUSH_INTERVAL_MS) * 1000000;
+    if (batch.size() >= GlobalConstants::CAPTURE_BATCH_BYTES || timestampNs - batchStartNs >= flushIntervalNs)
+    {
+        writeBatchLocked();
+    }
+}
+
+// Write the records collected so far
+void DatagramCapture::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.isOpen())
+    {
+        writeBatchLocked();
+    }
+}
+
+// Datagrams recorded since open()
+quint64 DatagramCapture::recordCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return records;
+}
+
+// Write the batch buffer to the file
+void DatagramCapture::writeBatchLocked()
+{
+    if (batch.isEmpty())
+    {
+        return;
+    }
+    file.write(batch); // One write for the whole batch
+    file.flush();      // Hand it to the OS, so a crash loses at most one batch
+    batch.resize(0);   // Keep the allocated capacity for the next batch
+}
@@ -0,0 +1,94 @@
+#ifndef DATAGRAMCAPTURE_H
+#define DATAGRAMCAPTURE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <mutex>
+
+// Capture file format shared by DatagramCapture and DatagramReplayer.
+//
+// File layout (all integers little-endian):
+//   FileHeader : magic "AKSDCAP\0" (8 bytes), format version (u32), wall-clock ms (i64), monotonic ns (i64)
+//   Record*    : timestamp ns (i64), peer port (u16), length (u16), direction (u8), datagram bytes
+//
+// Timestamps are raw monotonic nanoseconds, the same clock as the AKS heartbeat timestamps, so echoed
+// round trips replay unchanged. The header's two clock readings are taken at the same instant and map
+// them back to calendar time. Every capture session appends a new header, so one file may hold several.
+namespace CaptureFormat
+{
+    const char FILE_MAGIC[8] = {'A', 'K', 'S', 'D', 'C', 'A', 'P', '\0'}; // Identifies a capture file
+    const quint32 FORMAT_VERSION = 1;                                    // Current capture format version
+    const int FILE_HEADER_SIZE = 28;                                     // Magic + version + two clock anchors
+    const int RECORD_HEADER_SIZE = 13;                                   // Fixed part of every record
+
+    // Which way a datagram went
+    enum Direction : quint8
+    {
+        Received = 0, // From a peer to the AKS
+        Sent = 1      // From the AKS to a peer
+    };
+
+    // A record as read back from a capture
+    struct Record
+    {
+        qint64 timestampNs;  // Monotonic time the datagram was read or written
+        quint16 peerPort;    // Sender port (Received) or destination port (Sent)
+        quint16 length;      // Datagram size in bytes
+        Direction direction; // Received or Sent
+        const char *data;    // Points into the buffer the record was read from
+    };
+
+    // Append a file header with the current wall-clock and monotonic times to a buffer
+    void appendFileHeader(QByteArray &out, qint64 wallClockMs, qint64 monotonicNs);
+
+    // Check a file header; returns false if 'data' does not start with one of a supported version
+    bool readFileHeader(const char *data, qint64 size, qint64 *wallClockMs, qint64 *monotonicNs);
+
+    // Append a record to a buffer
+    void appendRecord(QByteArray &out, Direction direction, quint16 peerPort, qint64 timestampNs,
+                      const char *data, quint16 length);
+
+    // Read one record; advances 'cursor' and returns false if the remaining data is truncated
+    bool readRecord(const char *&cursor, const char *end, Record &record);
+}
+
+// Append-only recorder of every datagram CommunicationManager receives and sends.
+// Records are collected in a batch buffer and written when it is full or a second old, so capturing
+// costs a copy per datagram on the network path. Safe to call from the main and the network I/O thread.
+// The age is only checked when a record arrives; the owner calls flush() every CAPTURE_FLUSH_INTERVAL_MS
+// so the last batch is written after traffic stops too.
+class DatagramCapture
+{
+public:
+    DatagramCapture();  // Constructor
+    ~DatagramCapture(); // Writes what is left and closes the file
+
+    // Open 'path' for appending and start a new capture session; returns false if it cannot be opened
+    bool open(const QString &path);
+
+    // Write what is left and close the file; later records are ignored
+    void close();
+
+    // True between open() and close()
+    bool isOpen() const;
+
+    // Record one datagram (thread-safe)
+    void record(CaptureFormat::Direction direction, quint16 peerPort, qint64 timestampNs, const char *data, qint64 length);
+
+    // Write the records collected so far (thread-safe)
+    void flush();
+
+    // Datagrams recorded since open()
+    quint64 recordCount() const;
+
+private:
+    void writeBatchLocked(); // Write the batch buffer to the file; caller holds mutex
+
+    mutable std::mutex mutex; // Guards everything below
+    QFile file;               // Capture file, opened for appending
+    QByteArray batch;         // Records not yet written
+    qint64 batchStartNs;      // Timestamp of the oldest record in the batch
+    quint64 records;          // Datagrams recorded since open()
+};
+
+#endif
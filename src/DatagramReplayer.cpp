@@ -0,0 +1,199 @@
+#include "DatagramReplayer.h"
+#include "GlobalConstants.h"
+#include "Logger.h"
+#include <cmath>
+
+// Constructor for DatagramReplayer
+DatagramReplayer::DatagramReplayer(CommunicationManager *manager, ManualClock *clock, QObject *parent)
+    : QObject(parent), manager(manager), clock(clock), cursor(nullptr), end(nullptr), firstNs(0), lastNs(0),
+      previousNs(0), startVirtualNs(0), speed(0.0), pacingTimer(new QTimer(this)), done(false)
+{
+    pacingTimer->setSingleShot(true);
+    pacingTimer->setTimerType(Qt::PreciseTimer); // Datagrams are due with millisecond accuracy
+    connect(pacingTimer, &QTimer::timeout, this, &DatagramReplayer::replayDue);
+}
+
+// Map the capture and move the clock to its first datagram
+bool DatagramReplayer::open(const QString &path)
+{
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LOG_ERROR(QString("DatagramReplayer: Cannot open %1: %2").arg(path, file.errorString()));
+        return false;
+    }
+    const qint64 size = file.size();
+    const char *data = reinterpret_cast<const char *>(file.map(0, size)); // Captures can be large, avoid a copy
+    if (!data)
+    {
+        contents = file.readAll();
+        data = contents.constData();
+    }
+    qint64 wallClockMs = 0, monotonicNs = 0;
+    if (!CaptureFormat::readFileHeader(data, size, &wallClockMs, &monotonicNs))
+    {
+        LOG_ERROR(QString("DatagramReplayer: %1 is not a datagram capture").arg(path));
+        return false;
+    }
+    cursor = data;
+    end = data + size;
+
+    // Walk the records once for the start time and the length of the replay
+    CaptureFormat::Record record;
+    quint64 records = 0;
+    if (peekNext(record))
+    {
+        firstNs = lastNs = previousNs = record.timestampNs;
+    }
+    const char *scan = cursor;
+    const char *firstRecord = cursor;
+    while (true)
+    {
+        qint64 headerWallMs = 0, headerMonotonicNs = 0;
+        if (CaptureFormat::readFileHeader(scan, end - scan, &headerWallMs, &headerMonotonicNs))
+        {
+            scan += CaptureFormat::FILE_HEADER_SIZE;
+            continue;
+        }
+        if (!CaptureFormat::readRecord(scan, end, record))
+        {
+            break;
+        }
+        lastNs += qMax<qint64>(record.timestampNs - previousNs, 0);
+        previousNs = record.timestampNs;
+        ++records;
+    }
+    cursor = firstRecord;
+    previousNs = firstNs;
+
+    if (clock->nowNs() < firstNs)
+    {
+        clock->advance(firstNs - clock->nowNs()); // Nothing runs on the clock yet, so no timer fires
+    }
+    LOG_INFO(QString("DatagramReplayer: %1 records, %2 s from %3")
+                 .arg(records)
+                 .arg(double(lastNs - firstNs) / 1e9, 0, 'f', 3)
+                 .arg(path));
+    return true;
+}
+
+// Replay at 'speed' times the captured pace
+void DatagramReplayer::start(double speed)
+{
+    this->speed = speed > 0.0 ? speed : 0.0;
+    startVirtualNs = clock->nowNs();
+    wallClock.start();
+    pacingTimer->start(0);
+}
+
+// Replay everything that is left right away
+void DatagramReplayer::replayAll()
+{
+    pacingTimer->stop();
+    while (replayNext())
+    {
+    }
+    finish();
+}
+
+// Replay what is due on the wall clock, then wait for the next datagram
+void DatagramReplayer::replayDue()
+{
+    if (speed <= 0.0)
+    {
+        // As fast as possible, in chunks so the event loop (and a GUI) keeps running
+        for (int i = 0; i < GlobalConstants::REPLAY_CHUNK_RECORDS; ++i)
+        {
+            if (!replayNext())
+            {
+                finish();
+                return;
+            }
+        }
+        pacingTimer->start(0);
+        return;
+    }
+
+    const qint64 dueVirtualNs = startVirtualNs + qint64(double(wallClock.nsecsElapsed()) * speed);
+    CaptureFormat::Record record;
+    while (peekNext(record))
+    {
+        const qint64 recordVirtualNs = clock->nowNs() + advanceFor(record.timestampNs);
+        if (recordVirtualNs > dueVirtualNs)
+        {
+            const double waitMs = double(recordVirtualNs - dueVirtualNs) / speed / 1e6;
+            pacingTimer->start(int(std::ceil(waitMs)));
+            return;
+        }
+        replayNext();
+    }
+    finish();
+}
+
+// Replay one record
+bool DatagramReplayer::replayNext()
+{
+    CaptureFormat::Record record;
+    if (!peekNext(record))
+    {
+        return false;
+    }
+    CaptureFormat::readRecord(cursor, end, record); // Consume it
+
+    const qint64 advanceNs = advanceFor(record.timestampNs);
+    previousNs = record.timestampNs;
+    if (advanceNs > 0)
+    {
+        clock->advance(advanceNs); // Fires the manager's heartbeat, liveness and statistics timers on the way
+    }
+    if (record.direction == CaptureFormat::Received)
+    {
+        manager->handleDatagram(record.data, record.length, record.peerPort);
+        ++counters.replayed;
+    }
+    else
+    {
+        ++counters.skipped; // The manager sends its own heartbeats
+    }
+    return true;
+}
+
+// Next record without consuming it, skipping session headers
+bool DatagramReplayer::peekNext(CaptureFormat::Record &record)
+{
+    qint64 wallClockMs = 0, monotonicNs = 0;
+    while (cursor && CaptureFormat::readFileHeader(cursor, end - cursor, &wallClockMs, &monotonicNs))
+    {
+        cursor += CaptureFormat::FILE_HEADER_SIZE;
+        ++counters.sessions;
+    }
+    const char *next = cursor;
+    if (!cursor || !CaptureFormat::readRecord(next, end, record))
+    {
+        counters.truncated = cursor && cursor != end;
+        return false;
+    }
+    return true;
+}
+
+// Clock advance that brings the replay to a record.
+// A later session may start with an earlier clock (e.g. after a reboot); it continues without a gap.
+qint64 DatagramReplayer::advanceFor(qint64 timestampNs) const
+{
+    return qMax<qint64>(timestampNs - previousNs, 0);
+}
+
+// Stop pacing and emit finished()
+void DatagramReplayer::finish()
+{
+    pacingTimer->stop();
+    if (done)
+    {
+        return;
+    }
+    done = true;
+    LOG_INFO(QString("DatagramReplayer: Replayed %1 datagrams (%2 sent by the AKS skipped)")
+                 .arg(counters.replayed)
+                 .arg(counters.skipped));
+    emit finished();
+}
@@ -0,0 +1,80 @@
+#ifndef DATAGRAMREPLAYER_H
+#define DATAGRAMREPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include "CommunicationManager.h"
+#include "DatagramCapture.h"
+#include "MonotonicClock.h"
+
+// Feeds a capture written by DatagramCapture back into a CommunicationManager, without the network.
+// The manager must run on 'clock' and be started with startOffline(). Before each received datagram the
+// clock is advanced to the datagram's capture time, so heartbeat timeouts, link statistics and echoed round
+// trips come out as they did in the field, at any replay speed. Sent datagrams are skipped: the manager
+// produces its own heartbeats from its timers, in virtual time.
+class DatagramReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Counters of a replay
+    struct Stats
+    {
+        quint64 replayed = 0;   // Received datagrams handed to the manager
+        quint64 skipped = 0;    // Sent datagrams in the capture
+        quint64 sessions = 0;   // Capture sessions (file headers) seen
+        bool truncated = false; // The capture ended in a partial record
+    };
+
+    DatagramReplayer(CommunicationManager *manager, ManualClock *clock, QObject *parent = nullptr); // Constructor
+
+    // Map the capture and move the clock to its first datagram; call before starting the manager.
+    // Returns false if the file cannot be read or is not a capture.
+    bool open(const QString &path);
+
+    // Replay at 'speed' times the captured pace (1 = real time); 0 or less replays as fast as possible.
+    // Runs from the event loop; finished() is emitted at the end.
+    void start(double speed);
+
+    // Replay everything that is left right away, without the event loop (as fast as possible)
+    void replayAll();
+
+    // Counters so far
+    const Stats &stats() const { return counters; }
+
+    // Capture time of the first datagram (ns) and the length of the capture
+    qint64 firstTimestampNs() const { return firstNs; }
+    qint64 durationNs() const { return lastNs - firstNs; }
+
+signals:
+    void finished(); // The whole capture has been replayed
+
+private slots:
+    void replayDue(); // Replay what is due on the wall clock, then wait for the next datagram
+
+private:
+    bool replayNext();                            // Replay one record; returns false at the end of the capture
+    bool peekNext(CaptureFormat::Record &record); // Next record without consuming it, skipping session headers
+    qint64 advanceFor(qint64 timestampNs) const;  // Clock advance that brings the replay to a record
+    void finish();                                // Stop pacing and emit finished()
+
+    CommunicationManager *manager; // Receives the datagrams
+    ManualClock *clock;            // Virtual time of the manager
+    QFile file;                    // The capture file
+    const char *cursor;            // Next unread byte of the capture
+    const char *end;               // End of the capture
+    QByteArray contents;           // File contents when it cannot be mapped
+    qint64 firstNs;                // Capture time of the first record
+    qint64 lastNs;                 // firstNs plus the replayed length of the capture
+    qint64 previousNs;             // Capture time of the previous record
+    qint64 startVirtualNs;         // Clock time when start() was called
+    double speed;                  // Replay speed factor, 0 for as fast as possible
+    QElapsedTimer wallClock;       // Real time since start()
+    QTimer *pacingTimer;           // Wakes the replay for the next datagram (real time)
+    Stats counters;                // Counters so far
+    bool done;                     // finished() has been emitted
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "DeadlineScheduler.h"
+#include <algorithm>
+#include <limits>
+
+// Constructor for DeadlineScheduler
+DeadlineScheduler::DeadlineScheduler(MonotonicClock *clock, QObject *parent)
+    : QObject(parent), clock(clock), timer(clock->createTimer(this)), nextSequence(0)
+{
+    timer->setSingleShot(true); // Re-armed for the next deadline after every expiry pass
+    timer->setPrecise(true);    // A coarse timer could report a loss up to 5% of the timeout late
+    connect(timer, &ClockTimer::timeout, this, &DeadlineScheduler::processDue);
+}
+
+// (Re)arm a key
+void DeadlineScheduler::arm(int key, int timeoutMs)
+{
+    if (key < 0)
+    {
+        return;
+    }
+    if (key >= keys.size())
+    {
+        keys.resize(key + 1);
+    }
+
+    KeyState &state = keys[key];
+    state.deadlineNs = clock->nowNs() + qint64(qMax(timeoutMs, 0)) * 1000000;
+    state.armed = true;
+    if (!state.queued || state.deadlineNs < state.entryDeadlineNs)
+    {
+        push(key, state.deadlineNs); // The queued entry would fire too late (or there is none)
+        rearmTimer();
+    }
+    // Otherwise the queued entry fires early and processDue moves it to the new deadline
+}
+
+// Disarm a key
+void DeadlineScheduler::cancel(int key)
+{
+    if (key >= 0 && key < keys.size())
+    {
+        keys[key].armed = false; // The heap entry is discarded when it reaches the top
+    }
+}
+
+// Disarm every key
+void DeadlineScheduler::cancelAll()
+{
+    for (KeyState &state : keys)
+    {
+        state.armed = false;
+        state.queued = false;
+    }
+    heap.clear();
+    timer->stop();
+}
+
+// True while a key is armed
+bool DeadlineScheduler::isArmed(int key) const
+{
+    return key >= 0 && key < keys.size() && keys[key].armed;
+}
+
+// Clock time at which a key expires
+qint64 DeadlineScheduler::deadlineNs(int key) const
+{
+    return isArmed(key) ? keys[key].deadlineNs : -1;
+}
+
+// Expire every key whose deadline has passed
+void DeadlineScheduler::processDue()
+{
+    const qint64 nowNs = clock->nowNs();
+    while (!heap.empty() && heap.front().deadlineNs <= nowNs)
+    {
+        Entry entry = heap.front();
+        std::pop_heap(heap.begin(), heap.end(), &DeadlineScheduler::later);
+        heap.pop_back();
+
+        KeyState &state = keys[entry.key];
+        if (!state.queued || state.entrySequence != entry.sequence)
+        {
+            continue; // Superseded by an earlier entry for the same key
+        }
+        state.queued = false;
+        if (!state.armed)
+        {
+            continue; // Cancelled
+        }
+        if (state.deadlineNs > nowNs)
+        {
+            push(entry.key, state.deadlineNs); // Re-armed since the entry was queued
+            continue;
+        }
+
+        state.armed = false;
+        emit expired(entry.key); // May re-arm keys; 'state' is not used after this
+    }
+    rearmTimer();
+}
+
+// Heap order: earliest deadline on top, ties in push order
+bool DeadlineScheduler::later(const Entry &a, const Entry &b)
+{
+    return a.deadlineNs != b.deadlineNs ? a.deadlineNs > b.deadlineNs : a.sequence > b.sequence;
+}
+
+// Queue a new live entry for a key
+void DeadlineScheduler::push(int key, qint64 deadlineNs)
+{
+    KeyState &state = keys[key];
+    state.entryDeadlineNs = deadlineNs;
+    state.entrySequence = nextSequence++;
+    state.queued = true;
+    heap.push_back({deadlineNs, state.entrySequence, key});
+    std::push_heap(heap.begin(), heap.end(), &DeadlineScheduler::later);
+}
+
+// Point the timer at the earliest entry
+void DeadlineScheduler::rearmTimer()
+{
+    if (heap.empty())
+    {
+        timer->stop();
+        return;
+    }
+    // Round up so the timer never fires before the deadline
+    const qint64 delayNs = qMax<qint64>(heap.front().deadlineNs - clock->nowNs(), 0);
+    const qint64 delayMs = (delayNs + 999999) / 1000000;
+    timer->start(int(qMin<qint64>(delayMs, std::numeric_limits<int>::max())));
+}
@@ -0,0 +1,73 @@
+#ifndef DEADLINESCHEDULER_H
+#define DEADLINESCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+#include <vector>
+#include "MonotonicClock.h"
+
+// Per-key deadlines on a single timer.
+// Deadlines live in a min-heap and one single-shot ClockTimer is armed for the earliest of them,
+// so nothing wakes up while every deadline is still in the future. Pushing a deadline further out
+// (the usual case: a heartbeat arrived) only updates the key's state; the heap entry is moved
+// when it reaches the top, which keeps the heap at about one entry per key.
+class DeadlineScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeadlineScheduler(MonotonicClock *clock, QObject *parent = nullptr); // Constructor
+
+    // (Re)arm 'key' to expire 'timeoutMs' from now; keys are small non-negative integers
+    void arm(int key, int timeoutMs);
+
+    // Disarm 'key' without expiring it
+    void cancel(int key);
+
+    // Disarm every key
+    void cancelAll();
+
+    // True while 'key' is armed and has not expired
+    bool isArmed(int key) const;
+
+    // Clock time at which 'key' expires, or -1 if it is not armed
+    qint64 deadlineNs(int key) const;
+
+signals:
+    void expired(int key); // Emitted once when an armed key reaches its deadline
+
+private slots:
+    void processDue(); // Expire every key whose deadline has passed and re-arm the timer
+
+private:
+    // A heap entry; stale once its key was disarmed or re-queued earlier
+    struct Entry
+    {
+        qint64 deadlineNs; // When the entry falls due
+        quint64 sequence;  // Push order, identifies the key's current entry and breaks ties
+        int key;           // Key it belongs to
+    };
+
+    // Per-key state
+    struct KeyState
+    {
+        qint64 deadlineNs = 0;      // Current deadline (may be later than the queued entry)
+        qint64 entryDeadlineNs = 0; // Deadline of the key's live heap entry
+        quint64 entrySequence = 0;  // Sequence of the key's live heap entry
+        bool armed = false;         // Deadline pending
+        bool queued = false;        // A live heap entry exists
+    };
+
+    static bool later(const Entry &a, const Entry &b); // Heap order: earliest deadline on top
+
+    void push(int key, qint64 deadlineNs); // Queue a new live entry for 'key'
+    void rearmTimer();                     // Point the timer at the earliest entry
+
+    MonotonicClock *clock;   // Source of time and of the timer
+    ClockTimer *timer;       // Single-shot timer for the earliest entry
+    std::vector<Entry> heap; // Min-heap of entries
+    QVector<KeyState> keys;  // State indexed by key
+    quint64 nextSequence;    // Sequence of the next pushed entry
+};
+
+#endif
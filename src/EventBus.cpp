@@ -0,0 +1,159 @@
+#include "EventBus.h"
+#include <algorithm>
+
+// Constructor for EventBus
+EventBus::EventBus(QObject *parent)
+    : QObject(parent), dispatchDepth(0), needsCompaction(false), published(0), coalesced(0)
+{
+}
+
+// Register a type-erased handler
+void EventBus::addSubscriber(Events::Channel channel, QObject *receiver, Delivery delivery, int eventSize,
+                             std::function<void(const void *)> handler)
+{
+    std::shared_ptr<Subscriber> subscriber = std::make_shared<Subscriber>();
+    subscriber->receiver = receiver;
+    subscriber->delivery = delivery;
+    subscriber->eventSize = eventSize;
+    subscriber->handler = std::move(handler);
+    channels[channel].push_back(std::move(subscriber)); // A handler running in dispatch() may subscribe; it gets the current event too
+    connect(receiver, &QObject::destroyed, this, &EventBus::onReceiverDestroyed, Qt::UniqueConnection);
+}
+
+// End every subscription of 'receiver'
+void EventBus::unsubscribe(QObject *receiver)
+{
+    for (std::vector<std::shared_ptr<Subscriber>> &subscribers : channels)
+    {
+        for (const std::shared_ptr<Subscriber> &subscriber : subscribers)
+        {
+            if (subscriber->receiver == receiver)
+            {
+                subscriber->active.store(false, std::memory_order_relaxed); // Deliveries already posted are dropped
+            }
+        }
+    }
+    if (dispatchDepth > 0)
+    {
+        needsCompaction = true; // A dispatch() is iterating the lists
+        return;
+    }
+    compact();
+}
+
+// Drop the subscriptions of a destroyed receiver
+void EventBus::onReceiverDestroyed(QObject *receiver)
+{
+    unsubscribe(receiver);
+}
+
+// Active subscribers of an event type
+int EventBus::subscriberCount(Events::Channel channel) const
+{
+    return int(std::count_if(channels[channel].begin(), channels[channel].end(),
+                             [](const std::shared_ptr<Subscriber> &subscriber)
+                             { return subscriber->active.load(std::memory_order_relaxed); }));
+}
+
+// Events published so far
+quint64 EventBus::publishedCount() const
+{
+    return published;
+}
+
+// Events superseded in a Coalesced slot before delivery
+quint64 EventBus::coalescedCount() const
+{
+    return coalesced.load(std::memory_order_relaxed);
+}
+
+// Deliver an event to one channel
+void EventBus::dispatch(Events::Channel channel, const void *event)
+{
+    ++published;
+    ++dispatchDepth;
+    std::vector<std::shared_ptr<Subscriber>> &subscribers = channels[channel];
+    for (size_t i = 0; i < subscribers.size(); ++i) // By index, a Direct handler may subscribe and grow the list
+    {
+        Subscriber *subscriber = subscribers[i].get(); // Stays alive, the list is only compacted outside dispatch()
+        if (!subscriber->active.load(std::memory_order_relaxed))
+        {
+            continue;
+        }
+        switch (subscriber->delivery)
+        {
+        case Direct:
+            subscriber->handler(event);
+            break;
+        case Queued:
+            post(subscribers[i], event);
+            break;
+        case Coalesced:
+            coalesce(subscribers[i], event);
+            break;
+        }
+    }
+    if (--dispatchDepth == 0 && needsCompaction)
+    {
+        compact();
+    }
+}
+
+// Copy the event and deliver it from the receiver's event loop
+void EventBus::post(const std::shared_ptr<Subscriber> &subscriber, const void *event)
+{
+    EventCopy copy;
+    std::memcpy(copy.bytes, event, size_t(subscriber->eventSize));
+    std::shared_ptr<Subscriber> target = subscriber; // The delivery may run after the subscription ended
+    auto deliver = [target, copy]()
+    {
+        if (target->active.load(std::memory_order_relaxed))
+        {
+            target->handler(copy.bytes);
+        }
+    };
+    QMetaObject::invokeMethod(subscriber->receiver, deliver, Qt::QueuedConnection); // Dropped by Qt if the receiver is deleted first
+}
+
+// Keep the newest event and deliver it once from the receiver's event loop
+void EventBus::coalesce(const std::shared_ptr<Subscriber> &subscriber, const void *event)
+{
+    {
+        std::lock_guard<std::mutex> lock(subscriber->mutex);
+        std::memcpy(subscriber->latest.bytes, event, size_t(subscriber->eventSize)); // Latest wins
+        if (subscriber->scheduled)
+        {
+            coalesced.fetch_add(1, std::memory_order_relaxed); // The pending event is superseded
+            return;
+        }
+        subscriber->scheduled = true;
+    }
+    std::shared_ptr<Subscriber> target = subscriber;
+    auto deliver = [target]()
+    {
+        EventCopy copy;
+        {
+            std::lock_guard<std::mutex> lock(target->mutex);
+            copy = target->latest;
+            target->scheduled = false; // Events published from now on schedule the next delivery
+        }
+        if (target->active.load(std::memory_order_relaxed))
+        {
+            target->handler(copy.bytes);
+        }
+    };
+    QMetaObject::invokeMethod(subscriber->receiver, deliver, Qt::QueuedConnection);
+}
+
+// Remove ended subscriptions
+void EventBus::compact()
+{
+    needsCompaction = false;
+    for (std::vector<std::shared_ptr<Subscriber>> &subscribers : channels)
+    {
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                         [](const std::shared_ptr<Subscriber> &subscriber)
+                                         { return !subscriber->active.load(std::memory_order_relaxed); }),
+                          subscribers.end());
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <QObject>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "Events.h"
+
+// Typed publish/subscribe from AKSCore to its consumers (GUI, headless service, audit log).
+// publish() hands an event from Events.h to every subscriber of its type. Each subscriber picks how
+// it is delivered:
+//  - Direct:    the handler runs inside publish()
+//  - Queued:    every event is copied and delivered in order from the receiver's event loop
+//  - Coalesced: only the newest event is kept and delivered from the receiver's event loop, so a burst
+//               costs one delivery; for state that supersedes itself (positions, link status)
+// Subscriptions end when the receiver is destroyed. The bus is used from the thread it lives in, and
+// so are Direct receivers; Queued and Coalesced receivers may live in any thread with an event loop,
+// but one that lives elsewhere must be unsubscribed (from the bus's thread) before it is destroyed.
+class EventBus : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Delivery
+    {
+        Direct,
+        Queued,
+        Coalesced
+    };
+
+    explicit EventBus(QObject *parent = nullptr); // Constructor
+
+    // Call 'handler' with every published 'Event' (as const Event &) while 'receiver' exists
+    template <typename Event, typename Handler>
+    void subscribe(QObject *receiver, Delivery delivery, Handler handler)
+    {
+        static_assert(std::is_trivially_copyable<Event>::value, "Events are copied bit for bit");
+        static_assert(sizeof(Event) <= MAX_EVENT_SIZE, "Event too large to be queued");
+        addSubscriber(Event::CHANNEL, receiver, delivery, sizeof(Event),
+                      [handler](const void *event) { handler(*static_cast<const Event *>(event)); });
+    }
+
+    // Publish an event to the subscribers of its type
+    template <typename Event>
+    void publish(const Event &event)
+    {
+        static_assert(std::is_trivially_copyable<Event>::value, "Events are copied bit for bit");
+        dispatch(Event::CHANNEL, &event);
+    }
+
+    // End every subscription of 'receiver'
+    void unsubscribe(QObject *receiver);
+
+    int subscriberCount(Events::Channel channel) const; // Active subscribers of an event type
+    quint64 publishedCount() const;                     // Events published so far
+    quint64 coalescedCount() const;                     // Events superseded in a Coalesced slot before delivery
+
+private slots:
+    void onReceiverDestroyed(QObject *receiver); // Drop the subscriptions of a destroyed receiver
+
+private:
+    static const int MAX_EVENT_SIZE = 64; // Largest event type that can be queued or coalesced
+
+    // Copy of an event travelling to a Queued receiver
+    struct EventCopy
+    {
+        alignas(8) unsigned char bytes[MAX_EVENT_SIZE];
+    };
+
+    // One subscription; shared with the deliveries posted to the receiver's event loop
+    struct Subscriber
+    {
+        QObject *receiver;                         // Context of the handler
+        Delivery delivery;                         // How events reach it
+        int eventSize;                             // sizeof the event type
+        std::function<void(const void *)> handler; // Typed handler
+        std::atomic<bool> active{true};            // Cleared by unsubscribe(), checked before each delivery
+        std::mutex mutex;                          // Coalesced: guards latest and scheduled
+        bool scheduled = false;                    // Coalesced: a delivery is posted and has not run yet
+        EventCopy latest;                          // Coalesced: newest undelivered event
+    };
+
+    // Register a type-erased handler
+    void addSubscriber(Events::Channel channel, QObject *receiver, Delivery delivery, int eventSize,
+                       std::function<void(const void *)> handler);
+
+    void dispatch(Events::Channel channel, const void *event);                       // Deliver an event to one channel
+    void post(const std::shared_ptr<Subscriber> &subscriber, const void *event);     // Queued delivery
+    void coalesce(const std::shared_ptr<Subscriber> &subscriber, const void *event); // Coalesced delivery
+    void compact();                                                                  // Remove ended subscriptions
+
+    std::vector<std::shared_ptr<Subscriber>> channels[Events::ChannelCount]; // Subscribers per event type
+    int dispatchDepth;                                                       // Nested dispatch() calls running
+    bool needsCompaction;                                                    // Subscriptions ended during a dispatch
+    quint64 published;                                                       // Events published
+    std::atomic<quint64> coalesced;                                          // Events superseded before delivery
+};
+
+#endif
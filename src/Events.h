@@ -0,0 +1,71 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <QByteArray>
+#include <QString>
+#include <cstring>
+
+// Events AKSCore publishes on its EventBus.
+// Each event is a plain struct that is copied bit for bit (no Qt containers, no pointers), so queued and
+// coalesced delivery copy it without allocating, and CHANNEL names the subscriber list it goes to.
+namespace Events
+{
+    // Subscriber lists of the bus, one per event type
+    enum Channel
+    {
+        PlatformInfoChannel,
+        CommunicationStatusChannel,
+        MissileStatusChannel,
+        ChannelCount
+    };
+
+    // Platform position reported by ANS
+    struct PlatformInfo
+    {
+        static constexpr Channel CHANNEL = PlatformInfoChannel;
+
+        double latitude;  // Latitude in degrees
+        double longitude; // Longitude in degrees
+        double altitude;  // Altitude in meters
+    };
+
+    // Link status of both peers; published whenever either one changes
+    struct CommunicationStatus
+    {
+        static constexpr Channel CHANNEL = CommunicationStatusChannel;
+
+        bool ansConnected;      // ANS heartbeats are arriving
+        bool launcherConnected; // Launcher heartbeats are arriving
+    };
+
+    // Status of one missile
+    struct MissileStatus
+    {
+        static constexpr Channel CHANNEL = MissileStatusChannel;
+        static constexpr int TYPE_SIZE = 32; // Bytes of the type name, including the terminating null
+
+        int index;            // Missile index
+        bool healthy;         // Health status
+        bool powered;         // Power status
+        bool fired;           // Fired status
+        char type[TYPE_SIZE]; // Missile type, UTF-8 and null-terminated (ConfigReader rejects longer names)
+
+        // Store a type name; a longer one is cut at the last whole UTF-8 code point that fits
+        void setType(const QString &name)
+        {
+            const QByteArray utf8 = name.toUtf8();
+            int length = qMin(utf8.size(), TYPE_SIZE - 1);
+            while (length < utf8.size() && length > 0 && (uchar(utf8[length]) & 0xC0) == 0x80)
+            {
+                --length; // Byte 'length' continues a code point, so the cut would split it
+            }
+            std::memcpy(type, utf8.constData(), size_t(length));
+            type[length] = '\0';
+        }
+
+        // Type name as a QString
+        QString typeName() const { return QString::fromUtf8(type); }
+    };
+}
+
+#endif
@@ -1,11 +1,46 @@
-#ifndef GLOBALCONSTANTS_H
-#define GLOBALCONSTANTS_H
-
-namespace GlobalConstants
-{
-    const int HEARTBEAT_TIMEOUT_MS = 5000;            // Timeout for heartbeats (5 seconds)
-    const int HEARTBEAT_INTERVAL_MS = 1000;           // Interval for sending heartbeats (1 second)
-    const int COMMUNICATION_CHECK_INTERVAL_MS = 5000; // Interval for checking communication (5 second)
-}
-
+#ifndef GLOBALCONSTANTS_H
+#define GLOBALCONSTANTS_H
+
+#include <QtGlobal>
+
+namespace GlobalConstants
+{
+    const int HEARTBEAT_TIMEOUT_MS = 5000;             // Silence after which a peer is reported lost (5 seconds)
+    const int HEARTBEAT_INTERVAL_MS = 1000;            // Interval for sending heartbeats (1 second)
+    const int MAX_DATAGRAM_SIZE = 65536;               // Size of the receive buffer (largest UDP payload)
+    const int LINK_STATISTICS_LOG_INTERVAL_MS = 10000; // Interval for logging heartbeat link statistics (10 seconds)
+    const int GUI_FALLBACK_REFRESH_HZ = 60;            // Display refresh rate assumed when the screen does not report one
+    const int IPC_PLATFORM_EVENT_INTERVAL_MS = 100;    // Shortest time between two platform events to headless IPC subscribers
+    const int IPC_PROBE_TIMEOUT_MS = 200;              // Time a running instance gets to answer on the IPC socket name
+    const int CONFIG_RELOAD_DELAY_MS = 200;            // Quiet time after a configuration file change before it is reloaded
+    const int STARTUP_TIMELINE_TIMEOUT_MS = 30000;     // Longest startup milestones are waited for before the timeline is logged
+
+    const int NET_IO_QUEUE_CAPACITY = 1024; // Messages buffered between the network I/O thread and the main thread
+    const int NET_IO_BATCH_SIZE = 32;       // Datagrams read or sent per system call
+    const int NET_IO_SLOT_BYTES = 2048;     // Receive buffer per datagram of a batch (larger datagrams are dropped)
+    const int NET_IO_POLL_TIMEOUT_MS = 100; // Longest the I/O thread sleeps before rechecking its stop flag
+
+    const int INGEST_BUDGET_PER_WAKEUP = 256; // Received messages dispatched before the receive path yields to the event loop
+
+    const int CAPTURE_BATCH_BYTES = 64 * 1024;  // Captured bytes collected before they are written
+    const int CAPTURE_FLUSH_INTERVAL_MS = 1000; // Longest a captured datagram waits in memory
+    const int REPLAY_CHUNK_RECORDS = 4096;      // Records replayed per event loop pass at maximum speed
+
+    const int METRICS_EXPORT_INTERVAL_MS = 5000; // Interval for rewriting the metrics file (AKS_METRICS_FILE)
+    const int TRACE_BUFFER_EVENTS = 1 << 18;     // Trace spans kept per thread (24 bytes each); later spans are dropped
+
+    const int TELEMETRY_HISTORY_SAMPLES = 1 << 16;   // Platform positions kept for trends (32 bytes each, about 18 minutes at 60 Hz)
+    const qint64 TREND_PLOT_SPAN_MS = 60 * 60 * 1000; // Time shown by the GUI trend plots (1 hour)
+
+    const int LOG_QUEUE_CAPACITY = 8192;     // Maximum number of log entries waiting for the writer thread
+    const int LOG_WAKE_THRESHOLD = 256;      // Pending entries that wake the writer before its flush interval
+    const int LOG_FLUSH_INTERVAL_MS = 200;   // Maximum time an entry waits before being written
+    const int LOG_BATCH_BYTES = 64 * 1024;   // Batch size that triggers a write to the log file
+    const int LOG_CRASH_DRAIN_MS = 300;      // Time a fatal signal handler waits for the writer to drain the queue
+
+    const qint64 LOG_SEGMENT_MAX_BYTES = 16 * 1024 * 1024;     // Rotate the log file after 16 MB
+    const qint64 LOG_SEGMENT_MAX_AGE_MS = 24 * 60 * 60 * 1000; // Rotate the log file after 24 hours
+    const int LOG_RETAINED_SEGMENTS = 10;                      // Number of rotated (compressed) segments to keep
+}
+
 #endif
\ No newline at end of file
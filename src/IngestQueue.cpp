@@ -0,0 +1,62 @@
+#include "IngestQueue.h"
+#include "Metrics.h"
+
+// Constructor for IngestQueue
+IngestQueue::IngestQueue(int capacity)
+    : fifo(size_t(capacity)), latestPending(false), shedFifo(0), shedLatest(0)
+{
+    Metrics::Registry &metrics = Metrics::Registry::instance();
+    shedHeartbeatMetric = &metrics.counter("aks_ingest_shed_total", "Received messages dropped under overload, per kind.",
+                                           "kind=\"heartbeat\"");
+    shedPlatformInfoMetric = &metrics.counter("aks_ingest_shed_total", "Received messages dropped under overload, per kind.",
+                                              "kind=\"platform_info\"");
+}
+
+// Queue a message by its kind's policy
+bool IngestQueue::push(const Entry &entry)
+{
+    if (entry.message.type == Protocol::PlatformInfo)
+    {
+        std::lock_guard<std::mutex> lock(latestMutex); // Uncontended unless take() runs at the same moment
+        if (latestPending.load(std::memory_order_relaxed))
+        {
+            shedLatest.fetch_add(1, std::memory_order_relaxed);
+            shedPlatformInfoMetric->increment();
+        }
+        latest = entry; // Latest wins
+        latestPending.store(true, std::memory_order_release);
+        return true;
+    }
+    if (!fifo.tryPush(entry))
+    {
+        shedFifo.fetch_add(1, std::memory_order_relaxed);
+        shedHeartbeatMetric->increment();
+        return false;
+    }
+    return true;
+}
+
+// Take the next message
+bool IngestQueue::take(Entry &entry)
+{
+    if (latestPending.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(latestMutex);
+        entry = latest;
+        latestPending.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    return fifo.tryPop(entry);
+}
+
+// Heartbeats and other messages dropped on a full FIFO
+quint64 IngestQueue::shedHeartbeats() const
+{
+    return shedFifo.load(std::memory_order_relaxed);
+}
+
+// Platform info replaced by a newer one before it was taken
+quint64 IngestQueue::shedPlatformInfo() const
+{
+    return shedLatest.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,58 @@
+#ifndef INGESTQUEUE_H
+#define INGESTQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <mutex>
+#include "LockFreeQueue.h"
+#include "NetworkConfig.h"
+#include "Protocol.h"
+
+namespace Metrics
+{
+    class Counter;
+}
+
+// Decoded datagrams waiting to be dispatched to the core, with a bounded size and a policy per message kind:
+//  - Heartbeats (and every other kind) are kept, in order, in a bounded FIFO. They are shed only when the
+//    FIFO is full, which takes a flood far above any real heartbeat rate.
+//  - Platform info is latest-wins: it has a single slot, and a newer position replaces one not yet taken,
+//    since only the current position matters. A storm of positions therefore costs one dispatch per drain.
+//    Producers push only positions from ANS, so no other sender can replace them.
+// Shed messages are counted in the aks_ingest_shed_total metric. One producer thread and one consumer
+// thread, which may be the same (CommunicationManager reading its QUdpSocket).
+class IngestQueue
+{
+public:
+    // A decoded datagram
+    struct Entry
+    {
+        Protocol::Message message;    // Decoded content
+        NetworkConfig::Sender sender; // Peer the datagram came from
+        qint64 receivedNs;            // Clock time when the datagram was read
+    };
+
+    explicit IngestQueue(int capacity); // Room for 'capacity' heartbeats, plus the platform info slot
+
+    // Queue a message by its kind's policy (producer only); returns false if it was shed
+    bool push(const Entry &entry);
+
+    // Take the next message (consumer only): the latest platform info first, so a heartbeat flood
+    // cannot hold positions back, then the FIFO. Returns false if nothing is waiting.
+    bool take(Entry &entry);
+
+    quint64 shedHeartbeats() const;   // Heartbeats and other messages dropped on a full FIFO
+    quint64 shedPlatformInfo() const; // Platform info replaced by a newer one before it was taken
+
+private:
+    SpscQueue<Entry> fifo;                    // Heartbeats and other kept messages
+    std::mutex latestMutex;                   // Guards latest
+    Entry latest;                             // Newest platform info not yet taken
+    std::atomic<bool> latestPending;          // latest holds a message; checked without the lock
+    std::atomic<quint64> shedFifo;            // Dropped on a full FIFO
+    std::atomic<quint64> shedLatest;          // Replaced in the latest slot
+    Metrics::Counter *shedHeartbeatMetric;    // Process-wide count of shedFifo
+    Metrics::Counter *shedPlatformInfoMetric; // Process-wide count of shedLatest
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "LinkStatistics.h"
+#include <cstdlib>
+
+namespace
+{
+    const int SEQUENCE_WINDOW = 64;        // Recent sequence numbers remembered for duplicate detection
+    const qint32 PEER_RESTART_GAP = -1000; // A jump this far back means the peer restarted its sequence
+    const qint64 BUCKET_BOUNDS_US[LinkStatistics::RTT_BUCKET_COUNT - 1] = {
+        100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000}; // Bucket upper bounds
+}
+
+// Constructor for LinkStatistics
+LinkStatistics::LinkStatistics()
+{
+    reset();
+}
+
+// Forget everything
+void LinkStatistics::reset()
+{
+    stats = Snapshot();
+    haveSequence = false;
+    highestSequence = 0;
+    highestTimestampNs = 0;
+    recentWindow = 0;
+    haveTransit = false;
+    previousTransitNs = 0;
+    jitterNs = 0.0;
+    haveEcho = false;
+    lastEchoSequence = 0;
+    rttSumNs = 0.0;
+}
+
+// Account for a heartbeat carrying the peer's sequence number and send time
+void LinkStatistics::recordHeartbeat(quint32 sequence, qint64 senderTimestampNs, qint64 receivedNs)
+{
+    qint32 distance = static_cast<qint32>(sequence - highestSequence); // Wraps correctly at 2^32
+    // An old sequence number with a newer send time, or a huge jump back, means the peer restarted
+    bool restarted = distance < PEER_RESTART_GAP || (distance <= 0 && senderTimestampNs > highestTimestampNs);
+    if (haveSequence && restarted)
+    {
+        haveSequence = false; // Peer restarted; counters carry on from a fresh sequence
+        haveTransit = false;
+    }
+
+    if (!haveSequence)
+    {
+        haveSequence = true;
+        highestSequence = sequence;
+        highestTimestampNs = senderTimestampNs;
+        recentWindow = 1;
+    }
+    else if (distance > 0)
+    {
+        stats.lost += quint64(distance - 1); // Everything skipped is lost until it shows up late
+        recentWindow = distance < SEQUENCE_WINDOW ? (recentWindow << distance) | 1 : 1;
+        highestSequence = sequence;
+        highestTimestampNs = senderTimestampNs;
+    }
+    else if (distance == 0)
+    {
+        ++stats.duplicates;
+        return;
+    }
+    else
+    {
+        int age = -distance;
+        if (age < SEQUENCE_WINDOW)
+        {
+            quint64 bit = quint64(1) << age;
+            if (recentWindow & bit)
+            {
+                ++stats.duplicates;
+                return;
+            }
+            recentWindow |= bit;
+        }
+        ++stats.reordered; // Late, but not lost after all
+        if (stats.lost > 0)
+        {
+            --stats.lost;
+        }
+    }
+    ++stats.received;
+
+    // RFC 3550: J += (|D| - J) / 16, where D is the change in transit time between two packets
+    qint64 transitNs = receivedNs - senderTimestampNs;
+    if (haveTransit)
+    {
+        double difference = double(std::llabs(transitNs - previousTransitNs));
+        jitterNs += (difference - jitterNs) / 16.0;
+    }
+    previousTransitNs = transitNs;
+    haveTransit = true;
+}
+
+// Account for an echoed AKS heartbeat
+void LinkStatistics::recordEcho(quint32 echoSequence, qint64 echoTimestampNs, qint64 echoDelayNs, qint64 receivedNs)
+{
+    if (haveEcho && echoSequence == lastEchoSequence)
+    {
+        return; // Same round trip echoed again
+    }
+    qint64 rttNs = receivedNs - echoTimestampNs - echoDelayNs;
+    if (rttNs < 0 || echoTimestampNs < 0)
+    {
+        return; // Not one of our timestamps (e.g. we restarted)
+    }
+    haveEcho = true;
+    lastEchoSequence = echoSequence;
+
+    stats.rttLastNs = rttNs;
+    stats.rttMinNs = stats.rttSamples == 0 ? rttNs : qMin(stats.rttMinNs, rttNs);
+    stats.rttMaxNs = qMax(stats.rttMaxNs, rttNs);
+    ++stats.rttSamples;
+    rttSumNs += double(rttNs);
+
+    int bucket = 0;
+    while (bucket < RTT_BUCKET_COUNT - 1 && rttNs / 1000 >= BUCKET_BOUNDS_US[bucket])
+    {
+        ++bucket;
+    }
+    ++stats.rttHistogram[bucket];
+}
+
+// Current statistics
+LinkStatistics::Snapshot LinkStatistics::snapshot() const
+{
+    Snapshot result = stats;
+    quint64 expected = result.received + result.lost;
+    result.lossRatio = expected > 0 ? double(result.lost) / double(expected) : 0.0;
+    result.jitterNs = qint64(jitterNs);
+    result.rttMeanNs = result.rttSamples > 0 ? qint64(rttSumNs / double(result.rttSamples)) : 0;
+    return result;
+}
+
+// Upper bound of a histogram bucket in microseconds
+qint64 LinkStatistics::rttBucketUpperBoundUs(int bucket)
+{
+    return bucket >= 0 && bucket < RTT_BUCKET_COUNT - 1 ? BUCKET_BOUNDS_US[bucket] : -1;
+}
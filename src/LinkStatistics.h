@@ -0,0 +1,62 @@
+#ifndef LINKSTATISTICS_H
+#define LINKSTATISTICS_H
+
+#include <QtGlobal>
+
+// Health statistics for the heartbeat link to one peer.
+// Sequence numbers give loss, reordering and duplicates; sender timestamps give the RFC 3550
+// interarrival jitter; echoed AKS heartbeats give round-trip times, kept in a fixed histogram.
+class LinkStatistics
+{
+public:
+    static const int RTT_BUCKET_COUNT = 14; // Number of round-trip histogram buckets
+
+    // A copy of the statistics at one point in time
+    struct Snapshot
+    {
+        quint64 received = 0;                        // Distinct heartbeats received
+        quint64 lost = 0;                            // Sequence numbers not (yet) received
+        quint64 reordered = 0;                       // Heartbeats that arrived after a newer one
+        quint64 duplicates = 0;                      // Heartbeats received more than once
+        double lossRatio = 0.0;                      // lost / (received + lost)
+        qint64 jitterNs = 0;                         // Interarrival jitter (RFC 3550)
+        quint64 rttSamples = 0;                      // Round trips measured
+        qint64 rttLastNs = 0;                        // Latest round-trip time
+        qint64 rttMinNs = 0;                         // Shortest round-trip time
+        qint64 rttMaxNs = 0;                         // Longest round-trip time
+        qint64 rttMeanNs = 0;                        // Average round-trip time
+        quint64 rttHistogram[RTT_BUCKET_COUNT] = {}; // Round trips per bucket, see rttBucketUpperBoundUs()
+    };
+
+    LinkStatistics(); // Constructor
+
+    // Forget everything, e.g. when the peer restarts
+    void reset();
+
+    // Account for a heartbeat carrying the peer's sequence number and send time
+    void recordHeartbeat(quint32 sequence, qint64 senderTimestampNs, qint64 receivedNs);
+
+    // Account for an echoed AKS heartbeat (our own timestamp and the peer's hold time)
+    void recordEcho(quint32 echoSequence, qint64 echoTimestampNs, qint64 echoDelayNs, qint64 receivedNs);
+
+    // Current statistics
+    Snapshot snapshot() const;
+
+    // Upper bound of a histogram bucket in microseconds; -1 for the last, open-ended bucket
+    static qint64 rttBucketUpperBoundUs(int bucket);
+
+private:
+    Snapshot stats;            // Running counters
+    bool haveSequence;         // At least one heartbeat seen
+    quint32 highestSequence;   // Newest sequence number seen
+    qint64 highestTimestampNs; // Send time of the newest sequence number
+    quint64 recentWindow;      // Bit n set: highestSequence - n has been seen
+    bool haveTransit;          // previousTransitNs is valid
+    qint64 previousTransitNs;  // Receive time minus sender time of the previous heartbeat
+    double jitterNs;           // Jitter estimate kept at full precision
+    bool haveEcho;             // lastEchoSequence is valid
+    quint32 lastEchoSequence;  // Echo already accounted for (peers repeat it until a new heartbeat arrives)
+    double rttSumNs;           // Sum of all round trips, for the mean
+};
+
+#endif
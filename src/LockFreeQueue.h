@@ -0,0 +1,204 @@
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace LockFreeQueueDetail
+{
+    // Round a requested capacity up to the next power of two (minimum 2)
+    inline size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+// Bounded multi-producer/multi-consumer queue based on Dmitry Vyukov's array queue.
+// The capacity is rounded up to a power of two and all storage is allocated up front,
+// so tryPush/tryPop never block and never allocate.
+template <typename T>
+class BoundedMpmcQueue
+{
+public:
+    // Constructor: preallocates room for at least 'capacity' elements
+    explicit BoundedMpmcQueue(size_t capacity)
+        : mask(LockFreeQueueDetail::roundUpToPowerOfTwo(capacity) - 1), cells(new Cell[mask + 1]), enqueuePos(0), dequeuePos(0)
+    {
+        for (size_t i = 0; i <= mask; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed); // Each cell starts ready for its first lap
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue &) = delete;
+    BoundedMpmcQueue &operator=(const BoundedMpmcQueue &) = delete;
+
+    // Try to append an element; returns false if the queue is full
+    bool tryPush(T &&value)
+    {
+        Cell *cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break; // Slot claimed
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // Queue is full
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed); // Another producer won the slot
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release); // Publish to consumers
+        return true;
+    }
+
+    // Try to remove the oldest element; returns false if the queue is empty
+    bool tryPop(T &value)
+    {
+        Cell *cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break; // Slot claimed
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // Queue is empty
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed); // Another consumer won the slot
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release); // Hand the slot back to producers
+        return true;
+    }
+
+    // Approximate number of queued elements (exact only when no push/pop is in flight)
+    size_t sizeApprox() const
+    {
+        size_t enqueued = enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeued = dequeuePos.load(std::memory_order_relaxed);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+    // Number of elements the queue can hold
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence; // Lap counter used to detect full/empty slots
+        T data;                       // Stored element
+    };
+
+    const size_t mask;                          // Capacity - 1, used to wrap positions
+    std::unique_ptr<Cell[]> cells;              // Preallocated ring of cells
+    alignas(64) std::atomic<size_t> enqueuePos; // Next position to write (producers)
+    alignas(64) std::atomic<size_t> dequeuePos; // Next position to read (consumers)
+};
+
+// Bounded single-producer/single-consumer ring buffer.
+// Exactly one thread may push and exactly one thread may pop; each side caches the other's
+// index so the shared cache lines are only touched when the queue looks full or empty.
+template <typename T>
+class SpscQueue
+{
+public:
+    // Constructor: preallocates room for at least 'capacity' elements
+    explicit SpscQueue(size_t capacity)
+        : mask(LockFreeQueueDetail::roundUpToPowerOfTwo(capacity) - 1), elements(new T[mask + 1]),
+          head(0), cachedTail(0), tail(0), cachedHead(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Try to append an element (producer thread only); returns false if the queue is full
+    bool tryPush(const T &value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - cachedHead > mask)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (position - cachedHead > mask)
+            {
+                return false; // Queue is full
+            }
+        }
+        elements[position & mask] = value;
+        tail.store(position + 1, std::memory_order_release); // Publish to the consumer
+        return true;
+    }
+
+    // Try to remove the oldest element (consumer thread only); returns false if the queue is empty
+    bool tryPop(T &value)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == cachedTail)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (position == cachedTail)
+            {
+                return false; // Queue is empty
+            }
+        }
+        value = elements[position & mask];
+        head.store(position + 1, std::memory_order_release); // Hand the slot back to the producer
+        return true;
+    }
+
+    // Approximate number of queued elements
+    size_t sizeApprox() const
+    {
+        size_t written = tail.load(std::memory_order_acquire);
+        size_t read = head.load(std::memory_order_acquire);
+        return written >= read ? written - read : 0;
+    }
+
+    // Number of elements the queue can hold
+    size_t capacity() const { return mask + 1; }
+
+private:
+    const size_t mask;             // Capacity - 1, used to wrap positions
+    std::unique_ptr<T[]> elements; // Preallocated ring of elements
+
+    alignas(64) std::atomic<size_t> head; // Next position to read (consumer)
+    size_t cachedTail;                    // Consumer's last view of tail
+    alignas(64) std::atomic<size_t> tail; // Next position to write (producer)
+    size_t cachedHead;                    // Producer's last view of head
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "LogArchiver.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+
+namespace
+{
+    const qint64 GZIP_CHUNK_BYTES = 1024 * 1024; // Segment bytes read and compressed at a time
+
+    // CRC-32 (IEEE 802.3) as required by the gzip trailer
+    quint32 crc32(const QByteArray &data)
+    {
+        static quint32 table[256];
+        static bool tableReady = false;
+        if (!tableReady)
+        {
+            for (quint32 i = 0; i < 256; ++i)
+            {
+                quint32 value = i;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+                table[i] = value;
+            }
+            tableReady = true; // Only the archiver thread computes checksums
+        }
+
+        quint32 crc = 0xFFFFFFFFu;
+        const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+        for (int i = 0; i < data.size(); ++i)
+        {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // Compress 'data' into one gzip member at the end of 'target'
+    bool writeGzipMember(QIODevice &target, const QByteArray &data)
+    {
+        // qCompress produces a 4-byte length, a 2-byte zlib header, the deflate stream and a 4-byte Adler-32;
+        // gzip wants the bare deflate stream between its own header and trailer.
+        // For empty input qCompress returns only the length, so an empty final block is written instead.
+        static const char emptyStream[2] = {'\x03', '\x00'};
+        const QByteArray zlib = qCompress(data, 6);
+        if (!data.isEmpty() && zlib.size() < 10)
+        {
+            return false;
+        }
+        const QByteArray stream = data.isEmpty() ? QByteArray::fromRawData(emptyStream, sizeof(emptyStream))
+                                                 : QByteArray::fromRawData(zlib.constData() + 6, zlib.size() - 10);
+
+        static const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'}; // Deflate, no flags, unknown OS
+        uchar trailer[8];
+        qToLittleEndian(crc32(data), trailer);
+        qToLittleEndian(static_cast<quint32>(data.size()), trailer + 4);
+
+        return target.write(header, sizeof(header)) == sizeof(header) &&
+               target.write(stream) == stream.size() &&
+               target.write(reinterpret_cast<const char *>(trailer), sizeof(trailer)) == sizeof(trailer);
+    }
+}
+
+// Constructor for LogArchiver
+LogArchiver::LogArchiver() : stopping(false), retainedSegments(0)
+{
+}
+
+// Destructor for LogArchiver
+LogArchiver::~LogArchiver()
+{
+    stop(); // Finish pending work
+}
+
+// Start the archiver thread
+void LogArchiver::start(const QString &activeFileName, int retainedSegments)
+{
+    this->activeFileName = activeFileName;
+    this->retainedSegments = retainedSegments;
+    stopping = false;
+    thread = std::thread(&LogArchiver::run, this);
+}
+
+// Queue a rotated segment for compression
+void LogArchiver::archive(const QString &segmentPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || !thread.joinable())
+        {
+            return; // Not running; the segment stays uncompressed and is picked up by retention later
+        }
+        pending.push_back(segmentPath);
+    }
+    condition.notify_one();
+}
+
+// Finish queued compressions and stop the thread
+void LogArchiver::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_one();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+// Archiver thread main loop
+void LogArchiver::run()
+{
+    for (;;)
+    {
+        QString segmentPath;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]()
+                           { return stopping || !pending.empty(); });
+            if (pending.empty())
+            {
+                return; // Stopping and nothing left to do
+            }
+            segmentPath = pending.front();
+            pending.pop_front();
+        }
+
+        if (gzipFile(segmentPath, segmentPath + ".gz"))
+        {
+            QFile::remove(segmentPath); // Keep only the compressed copy
+        }
+        enforceRetention();
+    }
+}
+
+// Delete the oldest segments beyond the retention count
+void LogArchiver::enforceRetention()
+{
+    if (retainedSegments <= 0)
+    {
+        return; // Unlimited retention
+    }
+
+    QFileInfo activeInfo(activeFileName);
+    QDir directory(activeInfo.absolutePath());
+    QString pattern = activeInfo.completeBaseName() + ".*." + activeInfo.suffix();
+    QStringList segments = directory.entryList(QStringList() << pattern << pattern + ".gz", QDir::Files, QDir::Name);
+
+    // Names embed the rotation time and a zero-padded counter, so name order is age order
+    for (int i = 0; i + retainedSegments < segments.size(); ++i)
+    {
+        directory.remove(segments[i]);
+    }
+}
+
+// True when the segment must be rotated before more bytes are written to it
+bool LogArchiver::needsRotation(qint64 segmentBytes, qint64 incomingBytes, qint64 segmentAgeNs, qint64 maxBytes, qint64 maxAgeNs)
+{
+    if (segmentBytes == 0)
+    {
+        return false; // Never rotate an empty segment
+    }
+    if (maxBytes > 0 && segmentBytes + incomingBytes > maxBytes)
+    {
+        return true;
+    }
+    return maxAgeNs > 0 && segmentAgeNs >= maxAgeNs;
+}
+
+// Name for a segment rotated out of 'activeFileName' at the current time
+QString LogArchiver::rotatedSegmentName(const QString &activeFileName)
+{
+    QFileInfo activeInfo(activeFileName);
+    QString stem = activeInfo.path() + QDir::separator() + activeInfo.completeBaseName() + "." +
+                   QDateTime::currentDateTimeUtc().toString("yyyyMMdd-hhmmss") + "Z"; // UTC: no DST jump can reorder names
+    QString suffix = "." + activeInfo.suffix();
+
+    // The counter tells apart several rotations within one second and keeps them in rotation order
+    QString name;
+    for (int attempt = 0; name.isEmpty() || QFile::exists(name) || QFile::exists(name + ".gz"); ++attempt)
+    {
+        name = QString("%1-%2%3").arg(stem).arg(attempt, 3, 10, QChar('0')).arg(suffix);
+    }
+    return name;
+}
+
+// Compress a file into gzip format, one chunk at a time.
+// Each chunk becomes its own gzip member; gzip and zcat read the concatenated members as one stream.
+bool LogArchiver::gzipFile(const QString &sourcePath, const QString &targetPath)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    bool ok = true;
+    for (;;)
+    {
+        const QByteArray chunk = source.read(GZIP_CHUNK_BYTES);
+        if (source.error() != QFileDevice::NoError || !writeGzipMember(target, chunk))
+        {
+            ok = false;
+            break;
+        }
+        if (chunk.isEmpty() || source.atEnd())
+        {
+            break; // An empty file still gets one (empty) member
+        }
+    }
+    target.close();
+    if (!ok)
+    {
+        QFile::remove(targetPath); // Never leave a partial archive behind
+    }
+    return ok;
+}
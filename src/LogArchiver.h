@@ -0,0 +1,51 @@
+#ifndef LOGARCHIVER_H
+#define LOGARCHIVER_H
+
+#include <QString>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Compresses rotated log segments and enforces the retention count on a background thread,
+// so the log writer only has to rename the finished segment before it continues.
+class LogArchiver
+{
+public:
+    LogArchiver();  // Constructor
+    ~LogArchiver(); // Destructor, finishes pending work
+
+    // Start the archiver thread; 'activeFileName' is the live log (e.g. "aks_log.txt"),
+    // rotated segments are named after it and at most 'retainedSegments' of them are kept
+    void start(const QString &activeFileName, int retainedSegments);
+
+    // Queue a rotated segment for compression (returns immediately)
+    void archive(const QString &segmentPath);
+
+    // Finish queued compressions and stop the thread
+    void stop();
+
+    // True when a segment holding 'segmentBytes' and open for 'segmentAgeNs' must be rotated before 'incomingBytes'
+    // more are written to it; a limit of 0 disables that check, an empty segment is never rotated
+    static bool needsRotation(qint64 segmentBytes, qint64 incomingBytes, qint64 segmentAgeNs, qint64 maxBytes, qint64 maxAgeNs);
+
+    // Name for a segment rotated out of 'activeFileName' at the current time (UTC), e.g. "aks_log.20240131-235959Z-000.txt"
+    static QString rotatedSegmentName(const QString &activeFileName);
+
+    // Compress a file into gzip format, streaming it in chunks
+    static bool gzipFile(const QString &sourcePath, const QString &targetPath);
+
+private:
+    void run();              // Archiver thread main loop
+    void enforceRetention(); // Delete the oldest segments beyond the retention count
+
+    std::thread thread;                // Background archiver thread
+    std::mutex mutex;                  // Guards pending and stopping
+    std::condition_variable condition; // Signals new work or stop
+    std::deque<QString> pending;       // Segments waiting for compression
+    bool stopping;                     // Set when the thread should exit
+    QString activeFileName;            // Name of the live log file
+    int retainedSegments;              // Number of rotated segments to keep
+};
+
+#endif
@@ -1,65 +1,651 @@
-#include "Logger.h"
-
-// Constructor for Logger class
-Logger::Logger(QObject *parent) : QObject(parent)
-{
-    logFile.setFileName("aks_log.txt"); // Set the log file name
-    // Attempt to open the log file for writing
-    if (logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
-    {
-        logStream.setDevice(&logFile); // Set the log stream to the log file
-    }
-}
-
-// Destructor for Logger class
-Logger::~Logger()
-{
-    // Close the log file if it is open
-    if (logFile.isOpen())
-    {
-        logFile.close();
-    }
-}
-
-// Singleton instance of Logger
-Logger &Logger::instance()
-{
-    static Logger instance; // Create a static instance of Logger
-    return instance;        // Return the instance
-}
-
-// Log a message with a specific log level
-void Logger::log(LogLevel level, const QString &message)
-{
-    // Create a log entry with the current date, time, log level, and message
-    QString logEntry = QString("%1 [%2] %3\n")
-                           .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz")) // Current timestamp
-                           .arg(levelToString(level))                                             // Convert log level to string
-                           .arg(message);                                                         // The log message
-
-    logStream << logEntry; // Write the log entry to the log stream
-    logStream.flush();     // Ensure the log entry is written to the file
-
-    // Also print to console for debugging purposes
-    qDebug().noquote() << logEntry; // Output the log entry to the console
-}
-
-// Convert log level enum to string representation
-QString Logger::levelToString(LogLevel level)
-{
-    switch (level) // Check the log level
-    {
-    case Debug:
-        return "DEBUG"; // Return string for Debug level
-    case Info:
-        return "INFO"; // Return string for Info level
-    case Warning:
-        return "WARNING"; // Return string for Warning level
-    case Error:
-        return "ERROR"; // Return string for Error level
-    case Critical:
-        return "CRITICAL"; // Return string for Critical level
-    default:
-        return "UNKNOWN"; // Return string for unknown log level
-    }
-}
\ No newline at end of file
+#include "Logger.h"
+#include "GlobalConstants.h"
+#include "Metrics.h"
+#include "Trace.h"
+#include <QDebug>
+#include <chrono>
+#include <csignal>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <poll.h>
+#endif
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const int CRASH_SIGNALS[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL}; // Handled right in the signal handler
+    const int TERMINATION_SIGNALS[] = {SIGTERM, SIGINT};           // Handled on the writer thread
+    const int STDERR_FD = 2;
+
+    thread_local bool onWriterThread = false; // A crash on the writer thread cannot wait for the writer
+
+    // Write raw bytes to a descriptor; async-signal-safe
+    void writeRaw(int fd, const char *data, int size)
+    {
+#ifdef Q_OS_WIN
+        _write(fd, data, unsigned(size));
+#else
+        ssize_t written = ::write(fd, data, size_t(size));
+        Q_UNUSED(written); // Nothing left to report a failure to
+#endif
+    }
+}
+
+std::atomic<int> Logger::pendingSignal(0);
+std::atomic<int> Logger::crashSignal(0);
+std::atomic<int> Logger::crashWakeFd(-1);
+std::atomic<int> Logger::crashDrainedFd(-1);
+std::atomic<int> Logger::signalLogFd(-1);
+
+// Constructor for Logger class
+Logger::Logger(QObject *parent)
+    : QObject(parent), format(TextFormat), queue(GlobalConstants::LOG_QUEUE_CAPACITY), running(true), flushRequested(false),
+      minimumLevel(Debug), droppedEntries(0), cachedSecond(-1), segmentBytes(0), segmentOpenedNs(0)
+{
+    batch.reserve(GlobalConstants::LOG_BATCH_BYTES * 2); // Preallocate the batch buffer once
+    wakeFds[0] = wakeFds[1] = crashDrainedFds[0] = crashDrainedFds[1] = -1;
+
+    Metrics::Registry &metrics = Metrics::Registry::instance();
+    queueDepthMetric = &metrics.gauge("aks_log_queue_depth", "Log entries waiting for the writer thread.");
+    droppedMetric = &metrics.counter("aks_log_entries_dropped_total", "Log entries discarded because the queue was full.");
+    writeLatencyMetric = &metrics.histogram("aks_log_write_seconds", "Time to write one batch to the log file.",
+                                            {10000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000, 50000000, 100000000},
+                                            1e-9); // Nanoseconds, 10 us to 100 ms
+
+    // Pair the monotonic clock used for timestamps with the wall clock once, at startup
+    wallClockAnchorMs = QDateTime::currentMSecsSinceEpoch();
+    monotonicAnchorNs = monotonicNowNs();
+
+    if (qgetenv("AKS_LOG_FORMAT").toLower() == "binary")
+    {
+        format = BinaryFormat;
+    }
+
+    LogLevel level;
+    if (levelFromString(qgetenv("AKS_LOG_LEVEL"), &level))
+    {
+        minimumLevel.store(level, std::memory_order_relaxed);
+    }
+
+#ifdef QT_NO_DEBUG
+    bool echo = false; // Release builds do not pay for console output by default
+#else
+    bool echo = true;
+#endif
+    QByteArray echoSetting = qgetenv("AKS_LOG_CONSOLE");
+    if (!echoSetting.isEmpty())
+    {
+        echo = echoSetting != "0" && echoSetting.toLower() != "false";
+    }
+    consoleEcho.store(echo, std::memory_order_relaxed);
+
+    // Rotation settings, overridable from the environment
+    bool ok;
+    int maxSizeMb = qEnvironmentVariableIntValue("AKS_LOG_MAX_SIZE_MB", &ok);
+    maxSegmentBytes = ok ? qint64(maxSizeMb) * 1024 * 1024 : GlobalConstants::LOG_SEGMENT_MAX_BYTES;
+    int maxAgeMinutes = qEnvironmentVariableIntValue("AKS_LOG_MAX_AGE_MIN", &ok);
+    maxSegmentAgeNs = (ok ? qint64(maxAgeMinutes) * 60 * 1000 : GlobalConstants::LOG_SEGMENT_MAX_AGE_MS) * 1000000;
+    int retainedSegments = qEnvironmentVariableIntValue("AKS_LOG_RETENTION", &ok);
+    if (!ok)
+    {
+        retainedSegments = GlobalConstants::LOG_RETAINED_SEGMENTS;
+    }
+
+    logFile.setFileName(format == BinaryFormat ? "aks_log.bin" : "aks_log.txt"); // Set the log file name
+    openSegment();
+    archiver.start(logFile.fileName(), retainedSegments); // Compression happens off the writer thread
+
+#ifdef Q_OS_UNIX
+    if (::pipe(wakeFds) == 0 && ::pipe(crashDrainedFds) == 0)
+    {
+        // Neither side may block: a full pipe already means a pending wake-up
+        ::fcntl(wakeFds[0], F_SETFL, ::fcntl(wakeFds[0], F_GETFL) | O_NONBLOCK);
+        ::fcntl(wakeFds[1], F_SETFL, ::fcntl(wakeFds[1], F_GETFL) | O_NONBLOCK);
+        crashWakeFd.store(wakeFds[1], std::memory_order_relaxed);
+        crashDrainedFd.store(crashDrainedFds[0], std::memory_order_relaxed);
+    }
+    else
+    {
+        qWarning() << "Logger: Cannot create the wake pipes, a crash loses queued entries";
+    }
+#endif
+
+    writerThread = std::thread(&Logger::writerLoop, this); // Start the background writer
+    installSignalHandlers();                               // Make sure queued entries survive signals
+}
+
+// Destructor for Logger class
+Logger::~Logger()
+{
+    shutdown(); // Drain anything still queued
+
+    // Close the log file if it is open
+    if (logFile.isOpen())
+    {
+        logFile.close();
+    }
+
+#ifdef Q_OS_UNIX
+    crashDrainedFd.store(-1, std::memory_order_relaxed);
+    for (int fd : {wakeFds[0], wakeFds[1], crashDrainedFds[0], crashDrainedFds[1]})
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+// Singleton instance of Logger
+Logger &Logger::instance()
+{
+    static Logger instance; // Create a static instance of Logger
+    return instance;        // Return the instance
+}
+
+// Log a message with a specific log level
+void Logger::log(LogLevel level, const QString &message)
+{
+    if (!isEnabled(level))
+    {
+        return;
+    }
+
+    LogEntry entry;
+    entry.timestampNs = monotonicNowNs(); // Capture the time at the call site
+    entry.level = level;
+    entry.message = message; // Implicitly shared, no deep copy
+    enqueue(std::move(entry));
+}
+
+// Hand an entry to the writer thread
+void Logger::enqueue(LogEntry &&entry)
+{
+    // After shutdown there is no writer thread, so write synchronously
+    if (!running.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        appendEntry(entry);
+        writeBatch();
+        return;
+    }
+
+    LogLevel level = entry.level;
+    if (!queue.tryPush(std::move(entry)))
+    {
+        droppedEntries.fetch_add(1, std::memory_order_relaxed); // Never block the caller on a full queue
+        droppedMetric->increment();
+        return;
+    }
+
+    // shutdown() may have done its final drain between the check above and the push, then nobody else would
+    // pop the entry. Paired with the seq_cst exchange in shutdown(): either it sees the entry or we see the flag.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!running.load(std::memory_order_relaxed))
+    {
+        drainQueue();
+        return;
+    }
+
+    // Wake the writer early for severe entries or when a full batch is waiting
+    const size_t depth = queue.sizeApprox();
+    queueDepthMetric->set(qint64(depth));
+    bool wakeWriter = level >= Error || depth >= static_cast<size_t>(GlobalConstants::LOG_WAKE_THRESHOLD);
+    if (wakeWriter && !flushRequested.exchange(true, std::memory_order_acq_rel))
+    {
+        wakeWriterThread();
+    }
+}
+
+// Wake the writer thread before its flush interval expires
+void Logger::wakeWriterThread()
+{
+#ifdef Q_OS_UNIX
+    if (wakeFds[1] >= 0)
+    {
+        const char byte = 0;
+        writeRaw(wakeFds[1], &byte, 1); // The byte stays in the pipe until the writer reads it, so the wakeup is not lost
+        return;
+    }
+#endif
+    // Taking the lock orders the flag before the writer's predicate check or after its wait, so the wakeup is not lost
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakeCondition.notify_one();
+}
+
+// Sleep until woken or until one flush interval has passed
+void Logger::waitForWakeup()
+{
+#ifdef Q_OS_UNIX
+    if (wakeFds[0] >= 0)
+    {
+        pollfd wake;
+        wake.fd = wakeFds[0];
+        wake.events = POLLIN;
+        wake.revents = 0;
+        if (::poll(&wake, 1, GlobalConstants::LOG_FLUSH_INTERVAL_MS) > 0)
+        {
+            char drain[64];
+            while (::read(wakeFds[0], drain, sizeof(drain)) > 0)
+            {
+                // Wake-ups carry no data
+            }
+        }
+        return;
+    }
+#endif
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeCondition.wait_for(lock, std::chrono::milliseconds(GlobalConstants::LOG_FLUSH_INTERVAL_MS), [this]()
+                           { return !running.load(std::memory_order_acquire) || flushRequested.load(std::memory_order_acquire); });
+}
+
+// Block until every entry logged so far has been written to the log file
+void Logger::flush()
+{
+    drainQueue(); // The queue supports multiple consumers, so drain on the caller's thread
+}
+
+// Drain the queue and stop the writer thread
+void Logger::shutdown()
+{
+    crashWakeFd.store(-1, std::memory_order_relaxed); // A crash from now on must not wait for a writer that is leaving
+    const bool wasRunning = running.exchange(false, std::memory_order_seq_cst); // See enqueue()
+    wakeWriterThread();
+
+    if (wasRunning)
+    {
+        restoreTerminationHandlers(); // The writer thread no longer acts on them
+        if (writerThread.joinable())
+        {
+            writerThread.join(); // The writer drains the queue before exiting
+        }
+    }
+
+    drainQueue();    // Pick up entries pushed while the writer was exiting
+    archiver.stop(); // Finish compressing rotated segments
+
+    const int signalNumber = pendingSignal.load(std::memory_order_relaxed);
+    if (signalNumber != 0)
+    {
+        terminateOnSignal(signalNumber); // Arrived while the writer was exiting
+    }
+}
+
+// Writer thread main loop
+void Logger::writerLoop()
+{
+    Trace::setThreadName("log-writer");
+    onWriterThread = true;
+
+    while (running.load(std::memory_order_acquire))
+    {
+        waitForWakeup();
+        flushRequested.store(false, std::memory_order_release);
+
+        const int crashedOn = crashSignal.load(std::memory_order_acquire);
+        if (crashedOn != 0)
+        {
+            drainOnCrash(crashedOn);
+            return; // The crashing thread ends the process
+        }
+
+        drainQueue(); // Either the flush interval expired or a batch threshold was reached
+
+        const int signalNumber = pendingSignal.load(std::memory_order_relaxed);
+        if (signalNumber != 0)
+        {
+            terminateOnSignal(signalNumber); // Noticed within one flush interval
+        }
+    }
+
+    drainQueue(); // Final drain on shutdown
+}
+
+// Move all queued entries into the batch buffer and write it out
+void Logger::drainQueue()
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    drainQueueLocked();
+}
+
+// Same as drainQueue, caller holds writeMutex
+void Logger::drainQueueLocked()
+{
+    quint64 dropped = droppedEntries.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+    {
+        LogEntry notice;
+        notice.timestampNs = monotonicNowNs();
+        notice.level = Warning;
+        notice.message = QString("Logger: %1 entries dropped, queue was full").arg(dropped);
+        appendEntry(notice);
+    }
+
+    LogEntry entry;
+    while (queue.tryPop(entry))
+    {
+        appendEntry(entry);
+        if (batch.size() >= GlobalConstants::LOG_BATCH_BYTES)
+        {
+            writeBatch(); // Size threshold reached, write a large chunk
+        }
+    }
+
+    writeBatch();
+    queueDepthMetric->set(qint64(queue.sizeApprox()));
+}
+
+// Format a single entry into the batch buffer
+void Logger::appendEntry(const LogEntry &entry)
+{
+    if (format == BinaryFormat)
+    {
+        appendBinaryEntry(entry);
+        return;
+    }
+
+    if (entry.messageId == BinaryLog::FreeText)
+    {
+        appendTextEntry(entry, entry.message);
+    }
+    else
+    {
+        appendTextEntry(entry, BinaryLog::formatMessage(entry.messageId, entry.payload, entry.payloadSize, entry.argCount));
+    }
+}
+
+// Format an entry as a human-readable line
+void Logger::appendTextEntry(const LogEntry &entry, const QString &message)
+{
+    qint64 timestamp = wallClockAnchorMs + (entry.timestampNs - monotonicAnchorNs) / 1000000;
+
+    // The date/time text only changes once per second, so cache it
+    qint64 second = timestamp / 1000;
+    if (second != cachedSecond)
+    {
+        cachedSecond = second;
+        cachedSecondText = QDateTime::fromMSecsSinceEpoch(second * 1000).toString("yyyy-MM-dd hh:mm:ss").toLatin1();
+    }
+
+    int millis = static_cast<int>(timestamp % 1000);
+    const char millisText[] = {'.', char('0' + millis / 100), char('0' + (millis / 10) % 10), char('0' + millis % 10)};
+
+    int lineStart = batch.size();
+    batch.append(cachedSecondText);               // Current timestamp
+    batch.append(millisText, sizeof(millisText)); // Milliseconds
+    batch.append(" [");
+    batch.append(levelToString(entry.level)); // Convert log level to string
+    batch.append("] ");
+    batch.append(message.toUtf8()); // The log message
+
+    // Also print to console for debugging purposes
+    if (isConsoleEchoEnabled())
+    {
+        qDebug().noquote() << QString::fromUtf8(batch.constData() + lineStart, batch.size() - lineStart);
+    }
+
+    batch.append('\n');
+}
+
+// Encode an entry as a binary record
+void Logger::appendBinaryEntry(const LogEntry &entry)
+{
+    if (entry.messageId != BinaryLog::FreeText)
+    {
+        BinaryLog::appendRecord(batch, entry.timestampNs, static_cast<quint8>(entry.level), entry.messageId,
+                                entry.argCount, entry.payload, entry.payloadSize);
+        if (isConsoleEchoEnabled())
+        {
+            qDebug().noquote() << BinaryLog::formatMessage(entry.messageId, entry.payload, entry.payloadSize, entry.argCount);
+        }
+        return;
+    }
+
+    // Free-text messages are stored as a single string argument
+    QByteArray utf8 = entry.message.toUtf8();
+    scratch.resize(qMin(utf8.size() + 3, 0xFFFF));
+    BinaryLog::ArgWriter writer(scratch.data(), scratch.size());
+    writer.add(utf8.constData());
+    BinaryLog::appendRecord(batch, entry.timestampNs, static_cast<quint8>(entry.level), BinaryLog::FreeText,
+                            static_cast<quint8>(writer.argCount()), scratch.constData(), static_cast<quint16>(writer.size()));
+    if (isConsoleEchoEnabled())
+    {
+        qDebug().noquote() << entry.message;
+    }
+}
+
+// Write the batch buffer to the file and clear it
+void Logger::writeBatch()
+{
+    if (batch.isEmpty())
+    {
+        return;
+    }
+    TRACE_SCOPE("Logger::writeBatch");
+
+    if (segmentNeedsRotation())
+    {
+        rotateSegment();
+    }
+
+    if (logFile.isOpen())
+    {
+        const qint64 writeStartNs = monotonicNowNs();
+        logFile.write(batch); // One write for the whole batch
+        logFile.flush();      // Hand the batch to the OS
+        writeLatencyMetric->observe(monotonicNowNs() - writeStartNs);
+        segmentBytes += batch.size();
+    }
+    batch.resize(0); // Keep the allocated capacity for the next batch
+}
+
+// Open the active log file and prepare it as a new segment
+void Logger::openSegment()
+{
+    // Attempt to open the log file for writing
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Append;
+    if (format == TextFormat)
+    {
+        mode |= QIODevice::Text;
+    }
+    if (!logFile.open(mode))
+    {
+        qWarning() << "Logger: Failed to open log file:" << logFile.errorString();
+        return;
+    }
+
+    segmentBytes = logFile.size();
+    segmentOpenedNs = monotonicNowNs();
+    if (format == TextFormat)
+    {
+        signalLogFd.store(logFile.handle(), std::memory_order_relaxed); // A text line would corrupt a binary log
+    }
+
+#ifdef Q_OS_LINUX
+    // Reserve the blocks for a full segment up front so appends never wait for block allocation.
+    // FALLOC_FL_KEEP_SIZE leaves the visible file size alone, so readers only see written data.
+    if (maxSegmentBytes > segmentBytes)
+    {
+        fallocate(logFile.handle(), FALLOC_FL_KEEP_SIZE, segmentBytes, maxSegmentBytes - segmentBytes);
+    }
+#endif
+
+    if (format == BinaryFormat)
+    {
+        QByteArray header;
+        if (segmentBytes == 0)
+        {
+            BinaryLog::appendFileHeader(header); // New file, start with the header
+        }
+
+        // Every segment records the clock anchor so the decoder can recover calendar time
+        char anchor[BinaryLog::MAX_PAYLOAD_BYTES];
+        BinaryLog::ArgWriter writer(anchor, sizeof(anchor));
+        writer.add(wallClockAnchorMs);
+        writer.add(monotonicAnchorNs);
+        BinaryLog::appendRecord(header, monotonicNowNs(), Info, BinaryLog::SessionStart,
+                                static_cast<quint8>(writer.argCount()), anchor, static_cast<quint16>(writer.size()));
+        logFile.write(header);
+        logFile.flush();
+        segmentBytes += header.size();
+    }
+}
+
+// Check whether the active segment is full or too old
+bool Logger::segmentNeedsRotation() const
+{
+    return logFile.isOpen() && LogArchiver::needsRotation(segmentBytes, batch.size(), monotonicNowNs() - segmentOpenedNs,
+                                                         maxSegmentBytes, maxSegmentAgeNs);
+}
+
+// Close the active segment, hand it to the archiver and start a new one
+void Logger::rotateSegment()
+{
+    QString activeName = logFile.fileName();
+    signalLogFd.store(-1, std::memory_order_relaxed);
+    logFile.close();
+
+    QString rotatedName = LogArchiver::rotatedSegmentName(activeName);
+    if (QFile::rename(activeName, rotatedName))
+    {
+        archiver.archive(rotatedName); // Compressed on the archiver thread
+    }
+
+    logFile.setFileName(activeName);
+    openSegment();
+}
+
+// Install the handlers for fatal signals
+void Logger::installSignalHandlers()
+{
+    for (int signalNumber : CRASH_SIGNALS)
+    {
+        std::signal(signalNumber, &Logger::handleFatalSignal);
+    }
+    for (int signalNumber : TERMINATION_SIGNALS)
+    {
+        std::signal(signalNumber, &Logger::handleTerminationSignal);
+    }
+}
+
+// Give SIGTERM and SIGINT their default actions back
+void Logger::restoreTerminationHandlers()
+{
+    for (int signalNumber : TERMINATION_SIGNALS)
+    {
+        std::signal(signalNumber, SIG_DFL);
+    }
+}
+
+// Record SIGTERM or SIGINT; the writer thread drains the queue and then terminates the process
+void Logger::handleTerminationSignal(int signalNumber)
+{
+    pendingSignal.store(signalNumber, std::memory_order_relaxed);
+}
+
+// Wake the writer thread and give it LOG_CRASH_DRAIN_MS to write the queue, then let the default action
+// terminate the process. Nothing is formatted here; if the writer cannot answer in time (the crash is on the
+// writer thread, or another thread crashed while holding the write lock), a notice says entries were lost.
+void Logger::handleFatalSignal(int signalNumber)
+{
+    bool drained = false;
+#ifdef Q_OS_UNIX
+    const int wakeFd = crashWakeFd.load(std::memory_order_relaxed);
+    const int drainedFd = crashDrainedFd.load(std::memory_order_relaxed);
+    int noCrash = 0;
+    if (!onWriterThread && wakeFd >= 0 && drainedFd >= 0 && crashSignal.compare_exchange_strong(noCrash, signalNumber))
+    {
+        const char byte = 0;
+        writeRaw(wakeFd, &byte, 1);
+        pollfd answer;
+        answer.fd = drainedFd;
+        answer.events = POLLIN;
+        answer.revents = 0;
+        drained = ::poll(&answer, 1, GlobalConstants::LOG_CRASH_DRAIN_MS) > 0;
+    }
+#endif
+
+    static const char prefix[] = "[CRITICAL] Logger: fatal signal ";
+    static const char drainedSuffix[] = ", queued entries written\n";
+    static const char lostSuffix[] = ", entries not written yet are lost\n";
+    const char number[] = {char('0' + signalNumber / 10 % 10), char('0' + signalNumber % 10)};
+    const int skip = signalNumber < 10 ? 1 : 0; // No leading zero
+    const char *suffix = drained ? drainedSuffix : lostSuffix;
+    const int suffixSize = drained ? int(sizeof(drainedSuffix)) - 1 : int(sizeof(lostSuffix)) - 1;
+
+    // The writer already logged a drained crash itself
+    const int fds[] = {STDERR_FD, drained ? -1 : signalLogFd.load(std::memory_order_relaxed)};
+    for (int fd : fds)
+    {
+        if (fd >= 0)
+        {
+            writeRaw(fd, prefix, int(sizeof(prefix)) - 1);
+            writeRaw(fd, number + skip, int(sizeof(number)) - skip);
+            writeRaw(fd, suffix, suffixSize);
+        }
+    }
+    std::signal(signalNumber, SIG_DFL);
+    std::raise(signalNumber);
+}
+
+// Write everything queued, then take the default action of 'signalNumber'
+void Logger::terminateOnSignal(int signalNumber)
+{
+    LogEntry notice;
+    notice.timestampNs = monotonicNowNs();
+    notice.level = Warning;
+    notice.message = QString("Logger: terminated by signal %1").arg(signalNumber);
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        appendEntry(notice);
+        drainQueueLocked();
+    }
+    std::signal(signalNumber, SIG_DFL);
+    std::raise(signalNumber); // Ends the whole process, not just this thread
+}
+
+// Write everything queued and a notice, then tell the crashing thread's handler it may re-raise
+void Logger::drainOnCrash(int signalNumber)
+{
+    LogEntry notice;
+    notice.timestampNs = monotonicNowNs();
+    notice.level = Critical;
+    notice.message = QString("Logger: fatal signal %1").arg(signalNumber);
+    {
+        std::lock_guard<std::mutex> lock(writeMutex); // Held by the crashed thread: the handler's wait times out
+        drainQueueLocked();
+        appendEntry(notice);
+        writeBatch();
+    }
+#ifdef Q_OS_UNIX
+    const char byte = 0;
+    writeRaw(crashDrainedFds[1], &byte, 1);
+#endif
+}
+
+// Convert log level enum to string representation
+const char *Logger::levelToString(LogLevel level)
+{
+    return BinaryLog::levelName(level); // Shared with the offline log decoder
+}
+
+// Parse a level name such as "debug" or "WARNING"
+bool Logger::levelFromString(const QByteArray &name, LogLevel *level)
+{
+    QByteArray upper = name.trimmed().toUpper();
+    for (int candidate = Debug; candidate <= Critical; ++candidate)
+    {
+        if (upper == levelToString(static_cast<LogLevel>(candidate)))
+        {
+            *level = static_cast<LogLevel>(candidate);
+            return true;
+        }
+    }
+    return false;
+}
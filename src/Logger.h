@@ -3,10 +3,36 @@
 
 #include <QObject>
 #include <QFile>
-#include <QTextStream>
+#include <QByteArray>
 #include <QDateTime>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "BinaryLogFormat.h"
+#include "LockFreeQueue.h"
+#include "LogArchiver.h"
 
-// Logger class for handling log messages
+namespace Metrics
+{
+    class Counter;
+    class Gauge;
+    class Histogram;
+}
+
+// Lowest level that is compiled in at all (0 = Debug ... 4 = Critical).
+// Release builds (QT_NO_DEBUG) drop LOG_DEBUG calls entirely unless overridden with DEFINES.
+#ifndef AKS_LOG_COMPILE_LEVEL
+#ifdef QT_NO_DEBUG
+#define AKS_LOG_COMPILE_LEVEL 1
+#else
+#define AKS_LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+// Logger class for handling log messages.
+// Callers only enqueue entries; a dedicated writer thread formats them and writes them to disk in batches.
 class Logger : public QObject
 {
     Q_OBJECT
@@ -22,29 +48,192 @@ public:
         Critical // Critical error messages
     };
 
+    // Enum for the on-disk log format
+    enum OutputFormat
+    {
+        TextFormat,  // Human-readable lines in aks_log.txt (default)
+        BinaryFormat // Compact records in aks_log.bin, decoded offline by aks_log_decoder
+    };
+
     // Get the singleton instance of Logger
     static Logger &instance();
 
-    // Log a message with a specific log level
+    // Log a message with a specific log level (thread-safe, never blocks on file I/O)
     void log(LogLevel level, const QString &message);
 
+    // Log a catalogued message; the arguments are copied as raw values and formatted by the writer thread
+    template <typename... Args>
+    void logEvent(LogLevel level, BinaryLog::MessageId messageId, const Args &...args)
+    {
+        if (!isEnabled(level))
+        {
+            return;
+        }
+
+        LogEntry entry;
+        entry.timestampNs = monotonicNowNs();
+        entry.level = level;
+        entry.messageId = messageId;
+        BinaryLog::ArgWriter writer(entry.payload, sizeof(entry.payload));
+        int expand[] = {0, (writer.add(args), 0)...}; // Encode each argument in order
+        Q_UNUSED(expand);
+        entry.argCount = static_cast<quint8>(writer.argCount());
+        entry.payloadSize = static_cast<quint16>(writer.size());
+        enqueue(std::move(entry));
+    }
+
+    // Format the log file is written in (selected with AKS_LOG_FORMAT=binary)
+    OutputFormat outputFormat() const { return format; }
+
+    // Check whether entries of a level are currently recorded (the LOG_* macros test this before building the message)
+    bool isEnabled(LogLevel level) const { return level >= minimumLevel.load(std::memory_order_relaxed); }
+
+    // Set the lowest level that is recorded (initially AKS_LOG_LEVEL, or Debug)
+    void setMinimumLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+    LogLevel getMinimumLevel() const { return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed)); }
+
+    // Enable or disable echoing entries to the console (initially AKS_LOG_CONSOLE, on in debug builds only)
+    void setConsoleEcho(bool enabled) { consoleEcho.store(enabled, std::memory_order_relaxed); }
+    bool isConsoleEchoEnabled() const { return consoleEcho.load(std::memory_order_relaxed); }
+
+    // Block until every entry logged so far has been written to the log file
+    void flush();
+
+    // Drain the queue and stop the writer thread; later log calls are written synchronously
+    void shutdown();
+
 private:
+    // Entry handed from the logging thread to the writer thread
+    struct LogEntry
+    {
+        qint64 timestampNs = 0;                     // Monotonic timestamp, captured at the call site
+        LogLevel level = Info;                      // Level of the entry
+        quint16 messageId = BinaryLog::FreeText;    // Catalogued message, or FreeText for 'message'
+        quint8 argCount = 0;                        // Number of arguments in 'payload'
+        quint16 payloadSize = 0;                    // Bytes used in 'payload'
+        char payload[BinaryLog::MAX_PAYLOAD_BYTES]; // Encoded arguments of a catalogued message
+        QString message;                            // Free-text message
+    };
+
     // Private constructor for singleton pattern
     explicit Logger(QObject *parent = nullptr);
     ~Logger();
 
-    QFile logFile;         // File to write logs to
-    QTextStream logStream; // Stream to write to the log file
+    QFile logFile;            // File to write logs to
+    OutputFormat format;      // Format of the log file
+    qint64 wallClockAnchorMs; // Wall-clock time at startup, pairs with monotonicAnchorNs
+    qint64 monotonicAnchorNs; // Monotonic time at startup
+
+    BoundedMpmcQueue<LogEntry> queue;         // Pending entries waiting for the writer thread
+    std::thread writerThread;                 // Background thread that performs all file I/O
+    std::mutex wakeMutex;                     // Mutex paired with wakeCondition
+    std::condition_variable wakeCondition;    // Wakes the writer thread before its flush interval expires (without wakeFds)
+    int wakeFds[2];                           // Pipe that wakes the writer from poll() on Unix, usable from a signal handler
+    int crashDrainedFds[2];                   // Pipe the writer answers a fatal signal handler on once the queue is written
+    std::mutex writeMutex;                    // Serializes writes from the writer thread and from flush paths
+    std::atomic<bool> running;                // False once shutdown has been requested
+    std::atomic<bool> flushRequested;         // Set when a caller needs the queue written right away
+    std::atomic<int> minimumLevel;            // Lowest LogLevel that is recorded
+    std::atomic<bool> consoleEcho;            // Whether the writer also prints entries to the console
+    std::atomic<quint64> droppedEntries;      // Entries discarded because the queue was full
+    QByteArray batch;                         // Reused buffer holding formatted entries (guarded by writeMutex)
+    qint64 cachedSecond;                      // Second whose formatted text is cached (guarded by writeMutex)
+    QByteArray cachedSecondText;              // "yyyy-MM-dd hh:mm:ss" for cachedSecond (guarded by writeMutex)
+    QByteArray scratch;                       // Reused buffer for encoding free-text records (guarded by writeMutex)
+
+    qint64 maxSegmentBytes; // Rotate once the active segment would exceed this size (0 = never)
+    qint64 maxSegmentAgeNs; // Rotate once the active segment is this old (0 = never)
+    qint64 segmentBytes;    // Bytes in the active segment (guarded by writeMutex)
+    qint64 segmentOpenedNs; // Monotonic time the active segment was opened (guarded by writeMutex)
+    LogArchiver archiver;   // Compresses rotated segments and enforces retention
+
+    Metrics::Gauge *queueDepthMetric;       // Entries waiting for the writer thread
+    Metrics::Counter *droppedMetric;        // Entries discarded on a full queue
+    Metrics::Histogram *writeLatencyMetric; // Time of one batch write to the log file
+
+    // Current monotonic time in nanoseconds
+    static qint64 monotonicNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Hand an entry to the writer thread
+    void enqueue(LogEntry &&entry);
+
+    // Writer thread main loop
+    void writerLoop();
+
+    // Wake the writer thread before its flush interval expires
+    void wakeWriterThread();
+
+    // Sleep until woken or until one flush interval has passed (writer thread)
+    void waitForWakeup();
+
+    // Move all queued entries into the batch buffer and write it out
+    void drainQueue();
+    void drainQueueLocked(); // Same as drainQueue, caller holds writeMutex
+
+    // Format a single entry into the batch buffer
+    void appendEntry(const LogEntry &entry);
+    void appendTextEntry(const LogEntry &entry, const QString &message);
+    void appendBinaryEntry(const LogEntry &entry);
+
+    // Write the batch buffer to the file and clear it
+    void writeBatch();
+
+    // Segment rotation (caller holds writeMutex)
+    void openSegment();                // Open the active log file as a new segment
+    bool segmentNeedsRotation() const; // Check the size and age limits
+    void rotateSegment();              // Rename the active segment, queue it for compression, open a new one
+
+    // Fatal signals. The handlers only touch atomics, write(2) bytes formatted in advance and poll(2),
+    // nothing else is async-signal-safe: a crash inside the logger or the allocator must not deadlock them.
+    // A crash handler wakes the writer thread and waits a bounded time while it drains the queue.
+    static std::atomic<int> pendingSignal;                 // SIGTERM or SIGINT waiting for the writer thread (0 if none)
+    static std::atomic<int> crashSignal;                   // Crash signal the writer thread drains the queue for (0 if none)
+    static std::atomic<int> crashWakeFd;                   // Write end of wakeFds while the writer thread runs (-1 otherwise)
+    static std::atomic<int> crashDrainedFd;                // Read end of crashDrainedFds (-1 if none)
+    static std::atomic<int> signalLogFd;                   // Descriptor of the active text segment for the crash notice (-1 if none)
+    static void installSignalHandlers();                   // Install the handlers below
+    static void restoreTerminationHandlers();              // Default actions, once no writer thread is left to act
+    static void handleTerminationSignal(int signalNumber); // Record the signal for the writer thread
+    static void handleFatalSignal(int signalNumber);       // Let the writer drain the queue, then die
+    void terminateOnSignal(int signalNumber);              // Drain the queue, then take the signal's default action
+    void drainOnCrash(int signalNumber);                   // Writer side of a crash: write the queue, then answer the handler
 
     // Convert log level to string representation
-    QString levelToString(LogLevel level);
+    static const char *levelToString(LogLevel level);
+
+    // Parse a level name such as "debug" or "WARNING"; returns false if the name is unknown
+    static bool levelFromString(const QByteArray &name, LogLevel *level);
 };
 
+// Run a logging statement only if its level is compiled in and currently enabled.
+// The message expression is not evaluated when the level is disabled.
+#define AKS_LOG_IF(level, statement)                                                        \
+    do                                                                                      \
+    {                                                                                       \
+        if ((level) >= AKS_LOG_COMPILE_LEVEL && Logger::instance().isEnabled(level))        \
+        {                                                                                   \
+            statement;                                                                      \
+        }                                                                                   \
+    } while (0)
+
 // Macros for logging at different levels
-#define LOG_DEBUG(msg) Logger::instance().log(Logger::Debug, msg)
-#define LOG_INFO(msg) Logger::instance().log(Logger::Info, msg)
-#define LOG_WARNING(msg) Logger::instance().log(Logger::Warning, msg)
-#define LOG_ERROR(msg) Logger::instance().log(Logger::Error, msg)
-#define LOG_CRITICAL(msg) Logger::instance().log(Logger::Critical, msg)
+#if AKS_LOG_COMPILE_LEVEL > 0
+#define LOG_DEBUG(msg) \
+    do                 \
+    {                  \
+    } while (0)
+#else
+#define LOG_DEBUG(msg) AKS_LOG_IF(Logger::Debug, Logger::instance().log(Logger::Debug, msg))
+#endif
+#define LOG_INFO(msg) AKS_LOG_IF(Logger::Info, Logger::instance().log(Logger::Info, msg))
+#define LOG_WARNING(msg) AKS_LOG_IF(Logger::Warning, Logger::instance().log(Logger::Warning, msg))
+#define LOG_ERROR(msg) AKS_LOG_IF(Logger::Error, Logger::instance().log(Logger::Error, msg))
+#define LOG_CRITICAL(msg) AKS_LOG_IF(Logger::Critical, Logger::instance().log(Logger::Critical, msg))
+
+// Macro for logging a catalogued message (see BinaryLog::MessageId) with raw argument values
+#define LOG_EVENT(level, messageId, ...) AKS_LOG_IF(level, Logger::instance().logEvent(level, messageId, __VA_ARGS__))
 
 #endif
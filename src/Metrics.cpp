@@ -0,0 +1,163 @@
+#include "Metrics.h"
+
+namespace
+{
+    // Append "name{labels}" (or just the name without labels)
+    void appendSeriesName(QByteArray &out, const QByteArray &name, const char *suffix, const QByteArray &labels)
+    {
+        out.append(name);
+        out.append(suffix);
+        if (!labels.isEmpty())
+        {
+            out.append('{');
+            out.append(labels);
+            out.append('}');
+        }
+        out.append(' ');
+    }
+
+    // Append a sample value and end the line
+    void appendValue(QByteArray &out, double value)
+    {
+        out.append(QByteArray::number(value, 'g', 15));
+        out.append('\n');
+    }
+}
+
+namespace Metrics
+{
+    // Constructor for Histogram
+    Histogram::Histogram(const std::vector<qint64> &upperBounds)
+        : bounds(upperBounds), buckets(new std::atomic<quint64>[upperBounds.size() + 1])
+    {
+        for (size_t i = 0; i <= bounds.size(); ++i)
+        {
+            buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Get the process-wide registry
+    Registry &Registry::instance()
+    {
+        static Registry registry; // Constructed on first use, so it outlives the Logger singleton that registers in its constructor
+        return registry;
+    }
+
+    // Register a counter
+    Counter &Registry::counter(const char *name, const char *help, const char *labels)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Series &series = findOrAdd(name, help, CounterType, 1.0, labels);
+        if (!series.counter)
+        {
+            series.counter.reset(new Counter());
+        }
+        return *series.counter;
+    }
+
+    // Register a gauge
+    Gauge &Registry::gauge(const char *name, const char *help, const char *labels)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Series &series = findOrAdd(name, help, GaugeType, 1.0, labels);
+        if (!series.gauge)
+        {
+            series.gauge.reset(new Gauge());
+        }
+        return *series.gauge;
+    }
+
+    // Register a histogram
+    Histogram &Registry::histogram(const char *name, const char *help, const std::vector<qint64> &upperBounds,
+                                   double exportScale, const char *labels)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Series &series = findOrAdd(name, help, HistogramType, exportScale, labels);
+        if (!series.histogram)
+        {
+            series.histogram.reset(new Histogram(upperBounds));
+        }
+        return *series.histogram;
+    }
+
+    // Find the series of 'name' and 'labels', adding the family and the series as needed
+    Registry::Series &Registry::findOrAdd(const char *name, const char *help, Type type, double exportScale, const char *labels)
+    {
+        Family *family = nullptr;
+        for (Family &candidate : families)
+        {
+            if (candidate.name == name)
+            {
+                family = &candidate;
+                break;
+            }
+        }
+        if (!family)
+        {
+            families.emplace_back();
+            family = &families.back();
+            family->name = name;
+            family->help = help;
+            family->type = type;
+            family->exportScale = exportScale;
+        }
+        Q_ASSERT(family->type == type); // One name, one type
+
+        for (Series &series : family->series)
+        {
+            if (series.labels == labels)
+            {
+                return series;
+            }
+        }
+        family->series.emplace_back();
+        family->series.back().labels = labels;
+        return family->series.back();
+    }
+
+    // Append every metric in the Prometheus text exposition format
+    void Registry::writePrometheusText(QByteArray &out) const
+    {
+        static const char *const TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Family &family : families)
+        {
+            out.append("# HELP ").append(family.name).append(' ').append(family.help).append('\n');
+            out.append("# TYPE ").append(family.name).append(' ').append(TYPE_NAMES[family.type]).append('\n');
+            for (const Series &series : family.series)
+            {
+                if (family.type == CounterType)
+                {
+                    appendSeriesName(out, family.name, "", series.labels);
+                    appendValue(out, double(series.counter->value()));
+                    continue;
+                }
+                if (family.type == GaugeType)
+                {
+                    appendSeriesName(out, family.name, "", series.labels);
+                    appendValue(out, double(series.gauge->value()));
+                    continue;
+                }
+
+                // Histogram buckets are cumulative in the exposition format
+                const Histogram &histogram = *series.histogram;
+                const QByteArray labelPrefix = series.labels.isEmpty() ? QByteArray() : series.labels + ',';
+                quint64 cumulative = 0;
+                for (size_t i = 0; i <= histogram.upperBounds().size(); ++i)
+                {
+                    cumulative += histogram.bucketCount(i);
+                    const QByteArray bound = i < histogram.upperBounds().size()
+                                                 ? QByteArray::number(double(histogram.upperBounds()[i]) * family.exportScale, 'g', 15)
+                                                 : QByteArray("+Inf");
+                    appendSeriesName(out, family.name, "_bucket", labelPrefix + "le=\"" + bound + '"');
+                    appendValue(out, double(cumulative));
+                }
+                appendSeriesName(out, family.name, "_sum", series.labels);
+                appendValue(out, double(histogram.total()) * family.exportScale);
+                appendSeriesName(out, family.name, "_count", series.labels);
+                appendValue(out, double(cumulative));
+            }
+        }
+    }
+}
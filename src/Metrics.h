@@ -0,0 +1,125 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Process-wide runtime metrics: counters, gauges and fixed-bucket histograms, exported in the
+// Prometheus text format (see MetricsExporter).
+//
+// Metrics are registered once, typically in a constructor, and the returned reference is kept.
+// Updates are a single relaxed atomic operation on the metric's own cache line, so they cost a
+// few nanoseconds and are safe from any thread; only registration and export take a lock.
+namespace Metrics
+{
+    // Monotonically increasing count of events
+    class alignas(64) Counter
+    {
+    public:
+        void increment(quint64 amount = 1) { count.fetch_add(amount, std::memory_order_relaxed); }
+        quint64 value() const { return count.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<quint64> count{0}; // Events so far
+    };
+
+    // Value that goes up and down, e.g. a queue depth
+    class alignas(64) Gauge
+    {
+    public:
+        void set(qint64 value) { current.store(value, std::memory_order_relaxed); }
+        void add(qint64 amount) { current.fetch_add(amount, std::memory_order_relaxed); }
+        qint64 value() const { return current.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<qint64> current{0}; // Latest value
+    };
+
+    // Distribution of integer observations (e.g. nanoseconds) over fixed buckets
+    class Histogram
+    {
+    public:
+        // 'upperBounds' must be ascending; values above the last bound land in the +Inf bucket
+        explicit Histogram(const std::vector<qint64> &upperBounds);
+
+        // Count one observation
+        void observe(qint64 value)
+        {
+            size_t bucket = 0;
+            while (bucket < bounds.size() && value > bounds[bucket])
+            {
+                ++bucket; // A dozen bounds at most, a linear scan beats a binary search
+            }
+            buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            sum.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        const std::vector<qint64> &upperBounds() const { return bounds; }
+        quint64 bucketCount(size_t bucket) const { return buckets[bucket].load(std::memory_order_relaxed); } // bucket == upperBounds().size() is +Inf
+        qint64 total() const { return sum.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<qint64> bounds;                     // Bucket upper bounds (inclusive)
+        std::unique_ptr<std::atomic<quint64>[]> buckets; // Observations per bucket, plus the +Inf bucket
+        alignas(64) std::atomic<qint64> sum{0};         // Sum of all observations
+    };
+
+    // Owns every metric and writes them in the Prometheus text format
+    class Registry
+    {
+    public:
+        // Get the process-wide registry
+        static Registry &instance();
+
+        // Register a metric, or return the one already registered under 'name' and 'labels'.
+        // 'labels' is the Prometheus label set without braces, e.g. peer="ans".
+        Counter &counter(const char *name, const char *help, const char *labels = "");
+        Gauge &gauge(const char *name, const char *help, const char *labels = "");
+
+        // Histograms are exported in the observation unit multiplied by 'exportScale' (e.g. 1e-9 for ns as seconds)
+        Histogram &histogram(const char *name, const char *help, const std::vector<qint64> &upperBounds,
+                             double exportScale, const char *labels = "");
+
+        // Append every metric in the Prometheus text exposition format
+        void writePrometheusText(QByteArray &out) const;
+
+    private:
+        enum Type
+        {
+            CounterType,
+            GaugeType,
+            HistogramType
+        };
+
+        // One metric of a family
+        struct Series
+        {
+            QByteArray labels;                    // Label set without braces
+            std::unique_ptr<Counter> counter;     // Set for counters
+            std::unique_ptr<Gauge> gauge;         // Set for gauges
+            std::unique_ptr<Histogram> histogram; // Set for histograms
+        };
+
+        // Metrics sharing one name, HELP and TYPE line
+        struct Family
+        {
+            QByteArray name;            // Metric name
+            QByteArray help;            // HELP text
+            Type type;                  // Counter, gauge or histogram
+            double exportScale;         // Histograms: observation unit to exported unit
+            std::vector<Series> series; // One per label set
+        };
+
+        Registry() = default;
+
+        Series &findOrAdd(const char *name, const char *help, Type type, double exportScale, const char *labels); // Caller holds mutex
+
+        mutable std::mutex mutex;     // Guards families (not the metric values)
+        std::vector<Family> families; // In registration order
+    };
+}
+
+#endif
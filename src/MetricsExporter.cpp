@@ -0,0 +1,114 @@
+#include "MetricsExporter.h"
+#include <QLocalSocket>
+#include <QSaveFile>
+#include "GlobalConstants.h"
+#include "Logger.h"
+#include "Metrics.h"
+
+// Constructor for MetricsExporter
+MetricsExporter::MetricsExporter(MonotonicClock *clock, QObject *parent)
+    : QObject(parent), exportTimer(clock->createTimer(this)), server(new QLocalServer(this))
+{
+    connect(exportTimer, &ClockTimer::timeout, this, &MetricsExporter::writeFile);
+    connect(server, &QLocalServer::newConnection, this, &MetricsExporter::onNewConnection);
+}
+
+// Destructor for MetricsExporter
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+// Start exporting to the targets named in the environment
+bool MetricsExporter::start()
+{
+    bool exporting = false;
+    const QString path = qEnvironmentVariable("AKS_METRICS_FILE");
+    if (!path.isEmpty())
+    {
+        const int intervalMs = qEnvironmentVariableIsSet("AKS_METRICS_INTERVAL_MS") ? qEnvironmentVariableIntValue("AKS_METRICS_INTERVAL_MS")
+                                                                                    : GlobalConstants::METRICS_EXPORT_INTERVAL_MS;
+        exporting |= exportToFile(path, qMax(intervalMs, 100));
+    }
+    const QString socketName = qEnvironmentVariable("AKS_METRICS_SOCKET");
+    if (!socketName.isEmpty())
+    {
+        exporting |= exportToSocket(socketName);
+    }
+    return exporting;
+}
+
+// Stop exporting
+void MetricsExporter::stop()
+{
+    if (exportTimer->isActive())
+    {
+        exportTimer->stop();
+        writeFile(); // The file ends with the final values
+    }
+    server->close();
+}
+
+// Rewrite 'path' with the current metrics every 'intervalMs'
+bool MetricsExporter::exportToFile(const QString &path, int intervalMs)
+{
+    filePath = path;
+    writeFile();
+    exportTimer->start(intervalMs);
+    LOG_INFO(QString("MetricsExporter: Writing metrics to %1 every %2 ms").arg(path).arg(intervalMs));
+    return true;
+}
+
+// Serve the current metrics on the local socket 'name'
+bool MetricsExporter::exportToSocket(const QString &name)
+{
+    // A socket that still answers belongs to a live instance; only a stale one may be removed
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(GlobalConstants::IPC_PROBE_TIMEOUT_MS))
+    {
+        LOG_ERROR(QString("MetricsExporter: Another instance is already serving metrics on %1").arg(name));
+        return false;
+    }
+    QLocalServer::removeServer(name); // Clean up a socket left behind by a crashed instance
+
+    server->setSocketOptions(QLocalServer::UserAccessOption); // Metrics only for the user running the AKS
+    if (!server->listen(name))
+    {
+        LOG_ERROR(QString("MetricsExporter: Failed to listen on %1: %2").arg(name, server->errorString()));
+        return false;
+    }
+    LOG_INFO(QString("MetricsExporter: Serving metrics on %1").arg(server->fullServerName()));
+    return true;
+}
+
+// Rewrite the metrics file
+void MetricsExporter::writeFile()
+{
+    if (filePath.isEmpty())
+    {
+        return;
+    }
+    text.resize(0); // Keep the capacity of the previous export
+    Metrics::Registry::instance().writePrometheusText(text);
+
+    // Written to a temporary file and renamed, so a reader never sees half an export
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(text) != text.size() || !file.commit())
+    {
+        LOG_WARNING(QString("MetricsExporter: Cannot write %1: %2").arg(filePath, file.errorString()));
+    }
+}
+
+// Answer a socket client with the current metrics
+void MetricsExporter::onNewConnection()
+{
+    while (QLocalSocket *client = server->nextPendingConnection())
+    {
+        text.resize(0);
+        Metrics::Registry::instance().writePrometheusText(text);
+        connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+        client->write(text);
+        client->disconnectFromServer(); // Closes once the text is out
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QLocalServer>
+#include "MonotonicClock.h"
+
+// Publishes the Metrics::Registry in the Prometheus text format.
+// With AKS_METRICS_FILE the text is rewritten atomically every METRICS_EXPORT_INTERVAL_MS, for the
+// node exporter's textfile collector or a plain 'cat'. With AKS_METRICS_SOCKET a local socket
+// (a Unix domain socket on Linux) answers every connection with the current text and closes it.
+class MetricsExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(MonotonicClock *clock, QObject *parent = nullptr); // Constructor, the export timer runs on 'clock'
+    ~MetricsExporter();                                                         // Writes the file a last time
+
+    // Start exporting to the targets named by AKS_METRICS_FILE and AKS_METRICS_SOCKET; returns false if neither is set
+    bool start();
+    void stop();
+
+    // Rewrite 'path' with the current metrics every 'intervalMs'
+    bool exportToFile(const QString &path, int intervalMs);
+
+    // Serve the current metrics on the local socket 'name'
+    bool exportToSocket(const QString &name);
+
+private slots:
+    void writeFile();       // Rewrite the metrics file
+    void onNewConnection(); // Answer a socket client
+
+private:
+    ClockTimer *exportTimer; // Paces the file exports
+    QLocalServer *server;    // Serves the socket exports
+    QString filePath;        // Metrics file, empty if not exported to a file
+    QByteArray text;         // Reused buffer for the exposition text
+};
+
+#endif
@@ -0,0 +1,167 @@
+#include "MinMaxDecimator.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    const qint64 NO_DIRTY_COLUMN = std::numeric_limits<qint64>::max(); // firstDirty when nothing changed
+}
+
+// Constructor for MinMaxDecimator
+MinMaxDecimator::MinMaxDecimator()
+    : columns(1), count(1), columnNs(1), newest(0), empty(true), scrolled(0), firstDirty(NO_DIRTY_COLUMN)
+{
+}
+
+// Show 'spanNs' of time over 'columnCount' columns
+void MinMaxDecimator::setGeometry(int columnCount, qint64 spanNs)
+{
+    columnCount = std::max(columnCount, 1);
+    const qint64 newColumnNs = std::max<qint64>(spanNs / columnCount, 1);
+    if (columnCount == count && newColumnNs == columnNs)
+    {
+        return;
+    }
+
+    const QVector<Column> previous = columns;
+    const int previousCount = count;
+    const qint64 previousColumnNs = columnNs;
+    const qint64 previousNewest = newest;
+
+    columns = QVector<Column>(columnCount);
+    count = columnCount;
+    columnNs = newColumnNs;
+    scrolled = count; // Everything moved
+    firstDirty = NO_DIRTY_COLUMN;
+    if (empty)
+    {
+        return;
+    }
+
+    // Merge each old column into the new column holding its start time
+    newest = floorDiv(previousNewest * previousColumnNs, columnNs);
+    for (qint64 number = previousNewest - previousCount + 1; number <= previousNewest; ++number)
+    {
+        const Column &old = previous[int(floorMod(number, previousCount))];
+        const qint64 target = floorDiv(number * previousColumnNs, columnNs);
+        if (!old.valid || target <= newest - count)
+        {
+            continue; // Empty, or older than the new plot
+        }
+        Column &merged = columns[int(floorMod(target, count))];
+        merged.minimum = merged.valid ? std::min(merged.minimum, old.minimum) : old.minimum;
+        merged.maximum = merged.valid ? std::max(merged.maximum, old.maximum) : old.maximum;
+        merged.valid = true;
+    }
+}
+
+// Fold a sample into its column
+void MinMaxDecimator::add(qint64 timestampNs, double value)
+{
+    const qint64 number = floorDiv(timestampNs, columnNs);
+    if (empty)
+    {
+        newest = number;
+        empty = false;
+    }
+    else if (number > newest)
+    {
+        // Scroll: the columns between the old newest and this one start out empty
+        const qint64 advance = number - newest;
+        if (advance >= count)
+        {
+            std::fill(columns.begin(), columns.end(), Column());
+        }
+        else
+        {
+            for (qint64 skipped = newest + 1; skipped <= number; ++skipped)
+            {
+                columns[int(floorMod(skipped, count))] = Column();
+            }
+        }
+        scrolled = int(std::min<qint64>(qint64(scrolled) + advance, count));
+        newest = number;
+    }
+    else if (number <= newest - count)
+    {
+        return; // Older than the plot
+    }
+
+    Column &target = columns[int(floorMod(number, count))];
+    if (!target.valid)
+    {
+        target.minimum = value;
+        target.maximum = value;
+        target.valid = true;
+    }
+    else if (value < target.minimum)
+    {
+        target.minimum = value;
+    }
+    else if (value > target.maximum)
+    {
+        target.maximum = value;
+    }
+    else
+    {
+        return; // Inside the column's extremes, nothing to redraw
+    }
+    firstDirty = std::min(firstDirty, number);
+}
+
+// Forget every sample
+void MinMaxDecimator::clear()
+{
+    std::fill(columns.begin(), columns.end(), Column());
+    newest = 0;
+    empty = true;
+    scrolled = count;
+    firstDirty = NO_DIRTY_COLUMN;
+}
+
+// Smallest and largest sample shown
+bool MinMaxDecimator::valueRange(double &minimum, double &maximum) const
+{
+    bool found = false;
+    for (const Column &column : columns)
+    {
+        if (!column.valid)
+        {
+            continue;
+        }
+        minimum = found ? std::min(minimum, column.minimum) : column.minimum;
+        maximum = found ? std::max(maximum, column.maximum) : column.maximum;
+        found = true;
+    }
+    return found;
+}
+
+// Scroll distance and dirty columns since the previous call
+MinMaxDecimator::Changes MinMaxDecimator::takeChanges()
+{
+    Changes changes;
+    changes.scrolled = scrolled;
+    changes.firstDirty = count - scrolled; // The columns scrolled into view
+    if (firstDirty != NO_DIRTY_COLUMN)
+    {
+        const qint64 x = qint64(count - 1) - (newest - firstDirty);
+        changes.firstDirty = int(std::max<qint64>(0, std::min<qint64>(x, changes.firstDirty)));
+    }
+    scrolled = 0;
+    firstDirty = NO_DIRTY_COLUMN;
+    return changes;
+}
+
+// Division rounding towards minus infinity
+qint64 MinMaxDecimator::floorDiv(qint64 value, qint64 divisor)
+{
+    const qint64 quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+// Remainder of floorDiv, always >= 0
+qint64 MinMaxDecimator::floorMod(qint64 value, qint64 divisor)
+{
+    const qint64 remainder = value % divisor;
+    return remainder < 0 ? remainder + divisor : remainder;
+}
@@ -0,0 +1,71 @@
+#ifndef MINMAXDECIMATOR_H
+#define MINMAXDECIMATOR_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Reduces a time series to one min/max pair per plot column, for trend plots.
+// The plot shows the last 'span' of time over a fixed number of columns, each covering span / columns
+// nanoseconds. Every sample is folded into its column as it arrives (O(1)), so the cost of drawing depends
+// on the plot width only, never on how many samples the span holds; drawing each column as a vertical
+// line from its minimum to its maximum keeps every spike visible, unlike averaging or picking samples.
+//
+// The decimator remembers which columns changed and how far the plot scrolled since takeChanges(), so a
+// widget can shift what it already drew and paint only the new columns.
+class MinMaxDecimator
+{
+public:
+    // Extremes of the samples of one column
+    struct Column
+    {
+        double minimum = 0; // Smallest sample
+        double maximum = 0; // Largest sample
+        bool valid = false; // At least one sample fell into the column
+    };
+
+    // What changed since the previous takeChanges()
+    struct Changes
+    {
+        int scrolled;   // Columns the plot moved left by; columnCount() or more: redraw everything
+        int firstDirty; // Leftmost column to redraw (columnCount() if none); the exposed columns included
+    };
+
+    MinMaxDecimator(); // One column until setGeometry()
+
+    // Show 'spanNs' of time over 'columnCount' columns. Columns already filled are merged into the new
+    // layout (exact when columns get wider, blocky when they get narrower) and everything is marked changed.
+    void setGeometry(int columnCount, qint64 spanNs);
+
+    // Fold a sample into its column, scrolling the plot if it starts a new one. Samples older than the
+    // plot are ignored; timestamps are expected to grow (see TelemetryHistory).
+    void add(qint64 timestampNs, double value);
+
+    // Forget every sample
+    void clear();
+
+    // Column 'x', 0 being the oldest and columnCount() - 1 the newest
+    const Column &column(int x) const { return columns[int(floorMod(newest - (count - 1 - x), count))]; }
+
+    int columnCount() const { return count; }        // Columns of the plot
+    qint64 columnSpanNs() const { return columnNs; } // Time covered by one column
+
+    // Smallest and largest sample shown; returns false if no column holds one (O(columns))
+    bool valueRange(double &minimum, double &maximum) const;
+
+    // Scroll distance and dirty columns since the previous call, then start over
+    Changes takeChanges();
+
+private:
+    static qint64 floorDiv(qint64 value, qint64 divisor); // Division rounding towards minus infinity
+    static qint64 floorMod(qint64 value, qint64 divisor); // Remainder of floorDiv, always >= 0
+
+    QVector<Column> columns; // Ring of columns, indexed by absolute column number modulo count
+    int count;               // Columns of the plot
+    qint64 columnNs;         // Time covered by one column
+    qint64 newest;           // Absolute number (timestamp / columnNs) of the newest column
+    bool empty;              // No sample since construction or clear()
+    int scrolled;            // Columns scrolled since takeChanges()
+    qint64 firstDirty;       // Absolute number of the oldest changed column since takeChanges()
+};
+
+#endif
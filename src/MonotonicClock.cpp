@@ -0,0 +1,212 @@
+#include "MonotonicClock.h"
+#include "MonotonicTime.h"
+#include <QTimer>
+#include <limits>
+
+namespace
+{
+    // ClockTimer backed by a QTimer on the event loop
+    class SteadyClockTimer : public ClockTimer
+    {
+    public:
+        explicit SteadyClockTimer(QObject *parent)
+            : ClockTimer(parent), timer(new QTimer(this))
+        {
+            connect(timer, &QTimer::timeout, this, &ClockTimer::timeout); // Forward the QTimer's timeouts
+        }
+
+        void start(int intervalMs) override { timer->start(intervalMs); }
+        void stop() override { timer->stop(); }
+        bool isActive() const override { return timer->isActive(); }
+        int interval() const override { return timer->interval(); }
+        void setSingleShot(bool singleShot) override { timer->setSingleShot(singleShot); }
+        void setPrecise(bool precise) override { timer->setTimerType(precise ? Qt::PreciseTimer : Qt::CoarseTimer); }
+
+    private:
+        QTimer *timer; // Underlying Qt timer
+    };
+}
+
+// ClockTimer fired by ManualClock::advance()
+class ManualClockTimer : public ClockTimer
+{
+public:
+    ManualClockTimer(ManualClock *clock, QObject *parent)
+        : ClockTimer(parent), clock(clock), intervalMs(0), deadlineNs(0), armSequence(0),
+          active(false), singleShot(false)
+    {
+        clock->registerTimer(this);
+    }
+
+    ~ManualClockTimer()
+    {
+        if (clock)
+        {
+            clock->unregisterTimer(this);
+        }
+    }
+
+    // Arm the timer 'intervalMs' after the current virtual time
+    void start(int intervalMs) override
+    {
+        this->intervalMs = qMax(intervalMs, 0);
+        active = clock != nullptr;
+        if (active)
+        {
+            deadlineNs = clock->currentNs + periodNs();
+            armSequence = clock->nextArmSequence++;
+        }
+    }
+
+    void stop() override { active = false; }
+    bool isActive() const override { return active; }
+    int interval() const override { return intervalMs; }
+    void setSingleShot(bool singleShot) override { this->singleShot = singleShot; }
+    void setPrecise(bool) override {} // Virtual timers always fire exactly at their deadline
+
+    // Re-arm (or disarm) and emit timeout; the clock has already been moved to the deadline
+    void fire()
+    {
+        if (singleShot)
+        {
+            active = false;
+        }
+        else
+        {
+            deadlineNs += periodNs();
+            armSequence = clock->nextArmSequence++;
+        }
+        emit timeout(); // Last, a slot may stop, restart or delete the timer
+    }
+
+    // Time between two periodic firings; a zero interval fires once per virtual millisecond
+    // instead of on every event loop pass, which has no equivalent in virtual time
+    qint64 periodNs() const { return qint64(qMax(intervalMs, 1)) * 1000000; }
+
+    ManualClock *clock;  // Owning clock, cleared if the clock goes away first
+    int intervalMs;      // Interval in milliseconds
+    qint64 deadlineNs;   // Virtual time of the next firing
+    quint64 armSequence; // Tie-breaker for timers with the same deadline
+    bool active;         // Armed
+    bool singleShot;     // Disarm after firing
+};
+
+// Shared steady clock used when no clock is injected
+MonotonicClock *MonotonicClock::system()
+{
+    static SteadyClock clock; // Created on first use, lives until exit
+    return &clock;
+}
+
+// Constructor for SteadyClock
+SteadyClock::SteadyClock(QObject *parent)
+    : MonotonicClock(parent)
+{
+}
+
+// Current steady clock reading
+qint64 SteadyClock::nowNs() const
+{
+    return MonotonicTime::nowNs(); // Same origin as the network I/O thread's receive timestamps
+}
+
+// Create a QTimer-backed timer
+ClockTimer *SteadyClock::createTimer(QObject *parent)
+{
+    return new SteadyClockTimer(parent);
+}
+
+// Constructor for ManualClock
+ManualClock::ManualClock(QObject *parent)
+    : MonotonicClock(parent), currentNs(0), nextArmSequence(0)
+{
+}
+
+// Destructor for ManualClock
+ManualClock::~ManualClock()
+{
+    for (ManualClockTimer *timer : timers)
+    {
+        timer->clock = nullptr; // The timer outlives us but can no longer fire
+        timer->active = false;
+    }
+}
+
+// Current virtual time
+qint64 ManualClock::nowNs() const
+{
+    return currentNs;
+}
+
+// Create a timer fired by advance()
+ClockTimer *ManualClock::createTimer(QObject *parent)
+{
+    return new ManualClockTimer(this, parent);
+}
+
+// Move the clock forward, firing due timers in deadline order
+void ManualClock::advance(qint64 ns)
+{
+    const qint64 targetNs = currentNs + qMax<qint64>(ns, 0);
+    while (ManualClockTimer *timer = nextDueTimer(targetNs))
+    {
+        currentNs = timer->deadlineNs; // Slots see the time the timer was due
+        timer->fire();
+    }
+    currentNs = targetNs;
+}
+
+// Advance straight to the next timer deadline and fire it
+bool ManualClock::advanceToNextTimer()
+{
+    ManualClockTimer *timer = nextDueTimer(std::numeric_limits<qint64>::max());
+    if (!timer)
+    {
+        return false;
+    }
+    currentNs = timer->deadlineNs;
+    timer->fire();
+    return true;
+}
+
+// Number of active timers
+int ManualClock::activeTimerCount() const
+{
+    int count = 0;
+    for (const ManualClockTimer *timer : timers)
+    {
+        count += timer->active ? 1 : 0;
+    }
+    return count;
+}
+
+// Called when a timer is created
+void ManualClock::registerTimer(ManualClockTimer *timer)
+{
+    timers.append(timer);
+}
+
+// Called when a timer is destroyed
+void ManualClock::unregisterTimer(ManualClockTimer *timer)
+{
+    timers.removeOne(timer);
+}
+
+// Earliest active timer due at or before 'limitNs'
+ManualClockTimer *ManualClock::nextDueTimer(qint64 limitNs) const
+{
+    ManualClockTimer *next = nullptr;
+    for (ManualClockTimer *timer : timers)
+    {
+        if (!timer->active || timer->deadlineNs > limitNs)
+        {
+            continue;
+        }
+        if (!next || timer->deadlineNs < next->deadlineNs ||
+            (timer->deadlineNs == next->deadlineNs && timer->armSequence < next->armSequence))
+        {
+            next = timer;
+        }
+    }
+    return next;
+}
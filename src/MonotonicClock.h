@@ -0,0 +1,101 @@
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <QObject>
+#include <QVector>
+
+class ManualClockTimer;
+
+// A timer driven by a MonotonicClock; the clock-agnostic counterpart of QTimer
+class ClockTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ClockTimer(QObject *parent = nullptr) : QObject(parent) {} // Constructor
+
+    virtual void start(int intervalMs) = 0;          // (Re)start the timer with the given interval
+    virtual void stop() = 0;                         // Stop the timer
+    virtual bool isActive() const = 0;               // True while the timer is running
+    virtual int interval() const = 0;                // Interval in milliseconds
+    virtual void setSingleShot(bool singleShot) = 0; // Fire once instead of periodically
+    virtual void setPrecise(bool precise) = 0;       // Millisecond accuracy instead of coarse (up to 5% late) timing
+
+signals:
+    void timeout(); // Emitted every time the interval elapses
+};
+
+// Source of monotonic time and timers.
+// Components that measure ages or run timeouts take a clock instead of using QElapsedTimer and QTimer
+// directly, so the same code runs on the steady clock in production and in virtual time under a ManualClock.
+class MonotonicClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MonotonicClock(QObject *parent = nullptr) : QObject(parent) {} // Constructor
+
+    // Nanoseconds since an arbitrary origin; only differences between two readings are meaningful
+    virtual qint64 nowNs() const = 0;
+
+    // Milliseconds since the same origin
+    qint64 nowMs() const { return nowNs() / 1000000; }
+
+    // Create a timer running on this clock, owned by 'parent'
+    virtual ClockTimer *createTimer(QObject *parent) = 0;
+
+    // Shared steady clock used when no clock is injected
+    static MonotonicClock *system();
+};
+
+// Production clock: std::chrono::steady_clock readings (same origin as MonotonicTime) and QTimer-backed timers
+class SteadyClock : public MonotonicClock
+{
+    Q_OBJECT
+
+public:
+    explicit SteadyClock(QObject *parent = nullptr); // Constructor
+
+    qint64 nowNs() const override;                     // Current steady clock reading
+    ClockTimer *createTimer(QObject *parent) override; // Timer backed by a QTimer
+};
+
+// Virtual clock that only moves when advanced.
+// Timers created on it fire synchronously from advance(), in deadline order and with the clock set to
+// each deadline, so minutes of heartbeat timeouts can be replayed in microseconds without an event loop.
+class ManualClock : public MonotonicClock
+{
+    Q_OBJECT
+
+public:
+    explicit ManualClock(QObject *parent = nullptr); // Constructor, the clock starts at zero
+    ~ManualClock();                                  // Detaches the remaining timers
+
+    qint64 nowNs() const override;                     // Current virtual time
+    ClockTimer *createTimer(QObject *parent) override; // Timer fired by advance()
+
+    // Move the clock forward by 'ns' nanoseconds, firing every timer that falls due on the way
+    void advance(qint64 ns);
+
+    // Move the clock forward by 'ms' milliseconds
+    void advanceMs(qint64 ms) { advance(ms * 1000000); }
+
+    // Advance straight to the next timer deadline and fire it; returns false if no timer is active
+    bool advanceToNextTimer();
+
+    // Number of active timers
+    int activeTimerCount() const;
+
+private:
+    friend class ManualClockTimer;
+
+    void registerTimer(ManualClockTimer *timer);          // Called when a timer is created
+    void unregisterTimer(ManualClockTimer *timer);        // Called when a timer is destroyed
+    ManualClockTimer *nextDueTimer(qint64 limitNs) const; // Earliest active timer due at or before 'limitNs'
+
+    qint64 currentNs;                   // Current virtual time
+    quint64 nextArmSequence;            // Orders timers that share a deadline by the time they were started
+    QVector<ManualClockTimer *> timers; // Every live timer created on this clock
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef MONOTONICTIME_H
+#define MONOTONICTIME_H
+
+#include <QtGlobal>
+#include <chrono>
+
+namespace MonotonicTime
+{
+    // Nanoseconds on the steady clock; only differences between two readings are meaningful
+    inline qint64 nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+}
+
+#endif
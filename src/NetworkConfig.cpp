@@ -0,0 +1,209 @@
+#include "NetworkConfig.h"
+#include "Logger.h"
+
+namespace
+{
+    // Parse a host; "localhost" is accepted, other names are not resolved
+    bool parseHost(const QString &text, QHostAddress &address)
+    {
+        if (text.compare("localhost", Qt::CaseInsensitive) == 0)
+        {
+            address = QHostAddress(QHostAddress::LocalHost);
+            return true;
+        }
+        QHostAddress parsed;
+        if (!parsed.setAddress(text))
+        {
+            return false; // No DNS lookups at startup, the links must come up without a resolver
+        }
+        address = parsed;
+        return true;
+    }
+
+    // Override 'endpoint' from an environment variable, if set
+    void endpointFromEnvironment(const char *name, NetworkConfig::Endpoint &endpoint)
+    {
+        const QString value = qEnvironmentVariable(name);
+        if (!value.isEmpty() && !NetworkConfig::parseEndpoint(value, endpoint))
+        {
+            LOG_ERROR(QString("NetworkConfig: Ignoring invalid %1=%2").arg(name, value));
+        }
+    }
+}
+
+// "address:port", IPv6 addresses in brackets
+QString NetworkConfig::Endpoint::toString() const
+{
+    const QString host = address.protocol() == QAbstractSocket::IPv6Protocol ? "[" + address.toString() + "]" : address.toString();
+    return QString("%1:%2").arg(host).arg(port);
+}
+
+// Interface heartbeats to the group leave from
+QHostAddress NetworkConfig::outgoingInterface() const
+{
+    if (!multicastInterface.isNull())
+    {
+        return multicastInterface;
+    }
+    if (bind.address != QHostAddress::Any && bind.address != QHostAddress::AnyIPv4 && bind.address != QHostAddress::AnyIPv6)
+    {
+        return bind.address; // Bound to one interface, e.g. loopback for local simulators
+    }
+    return QHostAddress(); // The system picks one by its routes
+}
+
+// True when every address is IPv4
+bool NetworkConfig::isIPv4() const
+{
+    const QHostAddress addresses[] = {bind.address, ans.address, launcher.address, multicastGroup.address, multicastInterface};
+    for (const QHostAddress &address : addresses)
+    {
+        if (!address.isNull() && address.protocol() != QAbstractSocket::IPv4Protocol)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Peer whose endpoint is 'address':'port'
+NetworkConfig::Sender NetworkConfig::senderOf(const QHostAddress &address, quint16 port) const
+{
+    if (port == ans.port && address.isEqual(ans.address, QHostAddress::TolerantConversion))
+    {
+        return AnsSender;
+    }
+    if (port == launcher.port && address.isEqual(launcher.address, QHostAddress::TolerantConversion))
+    {
+        return LauncherSender;
+    }
+    return UnknownSender;
+}
+
+// Peer whose endpoint is the IPv4 'ipv4Address':'port'
+NetworkConfig::Sender NetworkConfig::senderOf(quint32 ipv4Address, quint16 port) const
+{
+    if (port == ans.port && ipv4Address == ans.address.toIPv4Address())
+    {
+        return AnsSender;
+    }
+    if (port == launcher.port && ipv4Address == launcher.address.toIPv4Address())
+    {
+        return LauncherSender;
+    }
+    return UnknownSender;
+}
+
+// Check the settings
+bool NetworkConfig::validate(QString *error) const
+{
+    QString problem;
+    if (ans.port == launcher.port && ans.address.isEqual(launcher.address, QHostAddress::TolerantConversion))
+    {
+        problem = QString("ANS and Launcher must not share the endpoint %1").arg(ans.toString());
+    }
+    else if (ans.port == 0 || launcher.port == 0)
+    {
+        problem = "peer ports must not be 0";
+    }
+    else if (usesMulticast() && !multicastGroup.address.isMulticast())
+    {
+        problem = QString("%1 is not a multicast address").arg(multicastGroup.address.toString());
+    }
+    else if (usesMulticast() && multicastGroup.port == 0)
+    {
+        problem = "the multicast port must not be 0";
+    }
+    else if (multicastTtl < 0 || multicastTtl > 255)
+    {
+        problem = QString("multicast TTL %1 is out of range (0-255)").arg(multicastTtl);
+    }
+    if (problem.isEmpty())
+    {
+        return true;
+    }
+    if (error)
+    {
+        *error = problem;
+    }
+    return false;
+}
+
+// One-line summary for the log
+QString NetworkConfig::toString() const
+{
+    QString text = QString("bind %1, ANS %2, Launcher %3").arg(bind.toString(), ans.toString(), launcher.toString());
+    if (usesMulticast())
+    {
+        text += QString(", heartbeats to %1 (TTL %2)").arg(multicastGroup.toString()).arg(multicastTtl);
+    }
+    return text;
+}
+
+// Defaults overridden by the AKS_* variables
+NetworkConfig NetworkConfig::fromEnvironment()
+{
+    NetworkConfig config;
+    endpointFromEnvironment("AKS_BIND", config.bind);
+    endpointFromEnvironment("AKS_ANS_ENDPOINT", config.ans);
+    endpointFromEnvironment("AKS_LAUNCHER_ENDPOINT", config.launcher);
+    endpointFromEnvironment("AKS_MULTICAST_GROUP", config.multicastGroup);
+
+    bool ok;
+    int ttl = qEnvironmentVariableIntValue("AKS_MULTICAST_TTL", &ok);
+    if (ok)
+    {
+        config.multicastTtl = ttl;
+    }
+    const QString interfaceAddress = qEnvironmentVariable("AKS_MULTICAST_INTERFACE");
+    if (!interfaceAddress.isEmpty() && !parseHost(interfaceAddress, config.multicastInterface))
+    {
+        LOG_ERROR(QString("NetworkConfig: Ignoring invalid AKS_MULTICAST_INTERFACE=%1").arg(interfaceAddress));
+    }
+    return config;
+}
+
+// Parse "host:port", "host", ":port" or "[v6]:port" into 'endpoint'
+bool NetworkConfig::parseEndpoint(const QString &text, Endpoint &endpoint)
+{
+    QString host = text.trimmed();
+    QString port;
+    if (host.startsWith('['))
+    {
+        const int close = host.indexOf(']');
+        if (close < 0 || (close + 1 < host.size() && host.at(close + 1) != ':'))
+        {
+            return false;
+        }
+        port = host.mid(close + 2);
+        host = host.mid(1, close - 1);
+    }
+    else if (host.count(':') == 1)
+    {
+        const int colon = host.indexOf(':');
+        port = host.mid(colon + 1);
+        host = host.left(colon);
+    } // More than one colon: a bare IPv6 address without a port
+
+    Endpoint parsed = endpoint;
+    if (!host.isEmpty() && !parseHost(host, parsed.address))
+    {
+        return false;
+    }
+    if (!port.isEmpty())
+    {
+        bool ok = false;
+        const uint value = port.toUInt(&ok);
+        if (!ok || value == 0 || value > 65535)
+        {
+            return false;
+        }
+        parsed.port = quint16(value);
+    }
+    if (host.isEmpty() && port.isEmpty())
+    {
+        return false; // Nothing given
+    }
+    endpoint = parsed;
+    return true;
+}
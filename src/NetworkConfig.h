@@ -0,0 +1,75 @@
+#ifndef NETWORKCONFIG_H
+#define NETWORKCONFIG_H
+
+#include <QHostAddress>
+#include <QString>
+
+// Where the AKS binds and where ANS and Launcher listen.
+// The defaults are the loopback setup the simulators use. fromEnvironment() overrides them from
+// AKS_BIND, AKS_ANS_ENDPOINT and AKS_LAUNCHER_ENDPOINT ("host:port", "host" or ":port").
+// With AKS_MULTICAST_GROUP set, heartbeats go out once to the group instead of once per peer, so the
+// send cost no longer grows with the number of subsystems; AKS_MULTICAST_TTL and AKS_MULTICAST_INTERFACE
+// (the address of the outgoing interface) tune it. Peers still answer to the bind endpoint.
+// A datagram counts as a peer's only if both its source address and its source port match the peer's endpoint.
+struct NetworkConfig
+{
+    // Which peer a received datagram came from
+    enum Sender : quint8
+    {
+        UnknownSender, // Neither endpoint
+        AnsSender,     // The ANS endpoint
+        LauncherSender // The Launcher endpoint
+    };
+
+    // An address and a port
+    struct Endpoint
+    {
+        QHostAddress address; // Host address (numeric or "localhost")
+        quint16 port;         // UDP port
+
+        QString toString() const; // "address:port", IPv6 addresses in brackets
+    };
+
+    static const quint16 DEFAULT_AKS_PORT = 5000;       // Port the AKS binds to
+    static const quint16 DEFAULT_ANS_PORT = 5001;       // Port ANS listens on
+    static const quint16 DEFAULT_LAUNCHER_PORT = 5002;  // Port Launcher listens on
+    static const quint16 DEFAULT_MULTICAST_PORT = 5003; // Port of the heartbeat group when none is given
+
+    Endpoint bind = {QHostAddress(QHostAddress::LocalHost), DEFAULT_AKS_PORT};          // Local endpoint of the AKS socket
+    Endpoint ans = {QHostAddress(QHostAddress::LocalHost), DEFAULT_ANS_PORT};           // ANS
+    Endpoint launcher = {QHostAddress(QHostAddress::LocalHost), DEFAULT_LAUNCHER_PORT}; // Launcher
+    Endpoint multicastGroup = {QHostAddress(), DEFAULT_MULTICAST_PORT};                 // Heartbeat group; a null address disables multicast
+    int multicastTtl = 1;                                                               // Hops a heartbeat may travel (1: the local network)
+    QHostAddress multicastInterface;                                                    // Address of the outgoing interface; null: the bind address
+    bool multicastLoopback = true;                                                      // Deliver heartbeats to group members on this host
+
+    // True when heartbeats go to the multicast group
+    bool usesMulticast() const { return !multicastGroup.address.isNull(); }
+
+    // Interface heartbeats to the group leave from; null leaves the choice to the system
+    QHostAddress outgoingInterface() const;
+
+    // True when every address is IPv4 (the network I/O thread handles IPv4 only)
+    bool isIPv4() const;
+
+    // Peer whose endpoint is 'address':'port'; IPv4-mapped IPv6 addresses match their IPv4 form
+    Sender senderOf(const QHostAddress &address, quint16 port) const;
+
+    // Same for an IPv4 address in host byte order, without building a QHostAddress (network I/O thread)
+    Sender senderOf(quint32 ipv4Address, quint16 port) const;
+
+    // Check the settings; returns false and sets 'error' if they cannot work
+    bool validate(QString *error) const;
+
+    // One-line summary for the log
+    QString toString() const;
+
+    // Defaults overridden by the AKS_* variables; invalid values are logged and ignored
+    static NetworkConfig fromEnvironment();
+
+    // Parse "host:port", "host", ":port" or "[v6]:port" into 'endpoint', keeping the parts not given;
+    // returns false and leaves 'endpoint' untouched if the text is invalid
+    static bool parseEndpoint(const QString &text, Endpoint &endpoint);
+};
+
+#endif
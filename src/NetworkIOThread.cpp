@@ -0,0 +1,413 @@
+#include "NetworkIOThread.h"
+#include "DatagramCapture.h"
+#include "GlobalConstants.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "MonotonicTime.h"
+#include "Trace.h"
+#include <cstring>
+
+#if defined(Q_OS_UNIX)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+#if defined(Q_OS_UNIX)
+    // Socket address of the IPv4 'host' (host byte order) and 'port'
+    sockaddr_in socketAddress(quint32 host, quint16 port)
+    {
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(host);
+        return address;
+    }
+
+    // Route multicast sends: interface, TTL and loopback; returns false if the system refuses an option
+    bool setMulticastOptions(int socketFd, const NetworkConfig &config)
+    {
+        const QHostAddress interfaceAddress = config.outgoingInterface();
+        if (!interfaceAddress.isNull())
+        {
+            in_addr outgoing;
+            outgoing.s_addr = htonl(interfaceAddress.toIPv4Address());
+            if (::setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_IF, &outgoing, sizeof(outgoing)) != 0)
+            {
+                return false;
+            }
+        }
+        const unsigned char ttl = static_cast<unsigned char>(config.multicastTtl);
+        const unsigned char loop = config.multicastLoopback ? 1 : 0;
+        return ::setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) == 0 &&
+               ::setsockopt(socketFd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) == 0;
+    }
+#endif
+}
+
+// Constructor for NetworkIOThread
+NetworkIOThread::NetworkIOThread(std::function<void()> inboundReady)
+    : inboundReady(std::move(inboundReady)),
+      inbound(GlobalConstants::NET_IO_QUEUE_CAPACITY),
+      outbound(GlobalConstants::NET_IO_QUEUE_CAPACITY),
+      running(false),
+      malformed(0),
+      capture(nullptr),
+      parseFailureMetric(&Metrics::Registry::instance().counter("aks_datagram_parse_failures_total",
+                                                                "Received datagrams that were unknown or malformed.")),
+      unknownSenderMetric(&Metrics::Registry::instance().counter("aks_datagrams_unknown_sender_total",
+                                                                 "Received datagrams from neither ANS nor Launcher.")),
+      socketFd(-1),
+      receiveBuffers(new char[GlobalConstants::NET_IO_BATCH_SIZE * GlobalConstants::NET_IO_SLOT_BYTES])
+{
+    wakeFds[0] = wakeFds[1] = -1;
+}
+
+// Destructor for NetworkIOThread
+NetworkIOThread::~NetworkIOThread()
+{
+    stop(); // Join the thread before the queues go away
+}
+
+// Check whether the I/O thread is available on this platform
+bool NetworkIOThread::isSupported()
+{
+#if defined(Q_OS_UNIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Bind the socket and start the thread
+bool NetworkIOThread::start(const NetworkConfig &config)
+{
+#if defined(Q_OS_UNIX)
+    socketFd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketFd < 0 || ::pipe(wakeFds) != 0)
+    {
+        closeAll();
+        return false;
+    }
+
+    sockaddr_in address = socketAddress(config.bind.address.toIPv4Address(), config.bind.port);
+    if (::bind(socketFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        closeAll();
+        return false;
+    }
+    if (config.usesMulticast() && !setMulticastOptions(socketFd, config))
+    {
+        LOG_ERROR(QString("NetworkIOThread: Cannot send to %1: %2").arg(config.multicastGroup.toString(),
+                                                                         QString::fromLocal8Bit(std::strerror(errno))));
+        closeAll();
+        return false;
+    }
+
+    // Both descriptors are drained until EAGAIN, so neither may block
+    ::fcntl(socketFd, F_SETFL, ::fcntl(socketFd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(wakeFds[0], F_SETFL, ::fcntl(wakeFds[0], F_GETFL) | O_NONBLOCK);
+    ::fcntl(wakeFds[1], F_SETFL, ::fcntl(wakeFds[1], F_GETFL) | O_NONBLOCK);
+
+    peers = config; // Read by the thread only
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&NetworkIOThread::run, this);
+    return true;
+#else
+    Q_UNUSED(config);
+    return false;
+#endif
+}
+
+// Stop the thread and close the socket
+void NetworkIOThread::stop()
+{
+    if (!thread.joinable())
+    {
+        closeAll();
+        return;
+    }
+    running.store(false, std::memory_order_release);
+    flushSends(); // Wake the thread so it sees the flag
+    thread.join();
+    closeAll();
+}
+
+// Queue a datagram for sending
+bool NetworkIOThread::queueSend(quint32 address, quint16 port, const char *data, int length)
+{
+    if (length <= 0 || length > int(sizeof(OutboundDatagram::data)))
+    {
+        return false;
+    }
+    OutboundDatagram datagram;
+    datagram.address = address;
+    datagram.port = port;
+    datagram.length = quint16(length);
+    std::memcpy(datagram.data, data, size_t(length));
+    return outbound.tryPush(datagram);
+}
+
+// Wake the I/O thread
+void NetworkIOThread::flushSends()
+{
+#if defined(Q_OS_UNIX)
+    if (wakeFds[1] >= 0)
+    {
+        char byte = 0;
+        ssize_t written = ::write(wakeFds[1], &byte, 1); // A full pipe already means a pending wake-up
+        Q_UNUSED(written);
+    }
+#endif
+}
+
+// Take the next received message
+bool NetworkIOThread::takeInbound(IngestQueue::Entry &message)
+{
+    return inbound.take(message);
+}
+
+// Messages shed because the main thread fell behind
+const IngestQueue &NetworkIOThread::inboundQueue() const
+{
+    return inbound;
+}
+
+// Datagrams that were oversized, unknown or malformed
+quint64 NetworkIOThread::malformedDatagrams() const
+{
+    return malformed.load(std::memory_order_relaxed);
+}
+
+// Record every received datagram into 'capture'
+void NetworkIOThread::setCapture(DatagramCapture *capture)
+{
+    this->capture.store(capture, std::memory_order_release); // Picked up at the next batch
+}
+
+// I/O thread main loop
+void NetworkIOThread::run()
+{
+    Trace::setThreadName("network-io");
+#if defined(Q_OS_UNIX)
+    pollfd descriptors[2];
+    descriptors[0].fd = socketFd;
+    descriptors[0].events = POLLIN;
+    descriptors[1].fd = wakeFds[0];
+    descriptors[1].events = POLLIN;
+
+    while (running.load(std::memory_order_acquire))
+    {
+        descriptors[0].revents = descriptors[1].revents = 0;
+        if (::poll(descriptors, 2, GlobalConstants::NET_IO_POLL_TIMEOUT_MS) < 0 && errno != EINTR)
+        {
+            LOG_ERROR(QString("NetworkIOThread: poll failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno))));
+            break;
+        }
+
+        if (descriptors[1].revents & POLLIN)
+        {
+            char drain[64];
+            while (::read(wakeFds[0], drain, sizeof(drain)) > 0)
+            {
+                // Wake-ups carry no data
+            }
+        }
+        sendPending();
+        if (descriptors[0].revents & POLLIN)
+        {
+            receiveBatch();
+        }
+    }
+    sendPending(); // Do not lose a last heartbeat queued during shutdown
+#endif
+}
+
+// Read and decode everything the socket has
+void NetworkIOThread::receiveBatch()
+{
+    TRACE_SCOPE("NetworkIOThread::receiveBatch");
+    qint64 lengths[GlobalConstants::NET_IO_BATCH_SIZE];
+    quint32 senderAddresses[GlobalConstants::NET_IO_BATCH_SIZE];
+    quint16 senderPorts[GlobalConstants::NET_IO_BATCH_SIZE];
+    bool queued = false;
+    DatagramCapture *activeCapture = capture.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        int received = readBatch(lengths, senderAddresses, senderPorts);
+        qint64 receivedNs = MonotonicTime::nowNs(); // One timestamp per batch
+        for (int i = 0; i < received; ++i)
+        {
+            IngestQueue::Entry inboundMessage;
+            const char *data = receiveBuffers.get() + i * GlobalConstants::NET_IO_SLOT_BYTES;
+            if (activeCapture && lengths[i] >= 0)
+            {
+                activeCapture->record(CaptureFormat::Received, senderPorts[i], receivedNs, data, lengths[i]); // Raw bytes, decodable or not
+            }
+            const NetworkConfig::Sender sender = peers.senderOf(senderAddresses[i], senderPorts[i]);
+            if (sender == NetworkConfig::UnknownSender)
+            {
+                unknownSenderMetric->increment();
+                continue; // Not decoded: a stranger's datagrams never reach the queue
+            }
+            if (lengths[i] < 0 || !Protocol::decode(data, lengths[i], inboundMessage.message))
+            {
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                parseFailureMetric->increment();
+                continue; // Oversized, unknown or malformed datagram
+            }
+            if (inboundMessage.message.type == Protocol::PlatformInfo && sender != NetworkConfig::AnsSender)
+            {
+                continue; // Only ANS reports the position; another peer's must not take the latest-wins slot
+            }
+            inboundMessage.sender = sender;
+            inboundMessage.receivedNs = receivedNs;
+            queued = inbound.push(inboundMessage) || queued; // Shed and counted if the main thread is not keeping up
+        }
+        if (received < GlobalConstants::NET_IO_BATCH_SIZE)
+        {
+            break; // A short batch means the socket is empty
+        }
+    }
+
+    if (queued && inboundReady)
+    {
+        inboundReady(); // One notification per batch
+    }
+}
+
+// Read up to one batch of datagrams into receiveBuffers; returns the number read
+int NetworkIOThread::readBatch(qint64 *lengths, quint32 *senderAddresses, quint16 *senderPorts)
+{
+#if defined(Q_OS_UNIX)
+    const int batchSize = GlobalConstants::NET_IO_BATCH_SIZE;
+    const int slotBytes = GlobalConstants::NET_IO_SLOT_BYTES;
+    sockaddr_in senders[GlobalConstants::NET_IO_BATCH_SIZE];
+    int received = 0;
+
+#if defined(Q_OS_LINUX)
+    // One system call for a whole batch of datagrams
+    mmsghdr messages[GlobalConstants::NET_IO_BATCH_SIZE];
+    iovec vectors[GlobalConstants::NET_IO_BATCH_SIZE];
+    std::memset(messages, 0, sizeof(messages));
+    for (int i = 0; i < batchSize; ++i)
+    {
+        vectors[i].iov_base = receiveBuffers.get() + i * slotBytes;
+        vectors[i].iov_len = size_t(slotBytes);
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &senders[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+    }
+    received = ::recvmmsg(socketFd, messages, unsigned(batchSize), MSG_DONTWAIT, nullptr);
+    if (received < 0)
+    {
+        return 0; // Socket drained (or an error that poll will report again)
+    }
+    for (int i = 0; i < received; ++i)
+    {
+        lengths[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : qint64(messages[i].msg_len);
+        senderAddresses[i] = ntohl(senders[i].sin_addr.s_addr);
+        senderPorts[i] = ntohs(senders[i].sin_port);
+    }
+#else
+    // Without recvmmsg, read one datagram per call
+    for (; received < batchSize; ++received)
+    {
+        socklen_t senderLength = sizeof(senders[received]);
+        ssize_t length = ::recvfrom(socketFd, receiveBuffers.get() + received * slotBytes, size_t(slotBytes), MSG_DONTWAIT,
+                                    reinterpret_cast<sockaddr *>(&senders[received]), &senderLength);
+        if (length < 0)
+        {
+            break; // Socket drained
+        }
+        lengths[received] = length < slotBytes ? qint64(length) : -1; // A full slot may have been truncated
+        senderAddresses[received] = ntohl(senders[received].sin_addr.s_addr);
+        senderPorts[received] = ntohs(senders[received].sin_port);
+    }
+#endif
+    return received;
+#else
+    Q_UNUSED(lengths);
+    Q_UNUSED(senderAddresses);
+    Q_UNUSED(senderPorts);
+    return 0;
+#endif
+}
+
+// Send everything in the outbound queue
+void NetworkIOThread::sendPending()
+{
+#if defined(Q_OS_UNIX)
+    OutboundDatagram datagrams[GlobalConstants::NET_IO_BATCH_SIZE];
+    sockaddr_in destinations[GlobalConstants::NET_IO_BATCH_SIZE];
+    for (;;)
+    {
+        int count = 0;
+        while (count < GlobalConstants::NET_IO_BATCH_SIZE && outbound.tryPop(datagrams[count]))
+        {
+            destinations[count] = socketAddress(datagrams[count].address, datagrams[count].port);
+            ++count;
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+#if defined(Q_OS_LINUX)
+        // The heartbeats to ANS and Launcher (or the one to the multicast group) leave in a single system call
+        mmsghdr messages[GlobalConstants::NET_IO_BATCH_SIZE];
+        iovec vectors[GlobalConstants::NET_IO_BATCH_SIZE];
+        std::memset(messages, 0, sizeof(messages));
+        for (int i = 0; i < count; ++i)
+        {
+            vectors[i].iov_base = datagrams[i].data;
+            vectors[i].iov_len = datagrams[i].length;
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &destinations[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(destinations[i]);
+        }
+        for (int sent = 0; sent < count;)
+        {
+            int result = ::sendmmsg(socketFd, messages + sent, unsigned(count - sent), 0);
+            if (result <= 0)
+            {
+                break; // UDP has no retransmission either; the next heartbeat follows in a second
+            }
+            sent += result;
+        }
+#else
+        for (int i = 0; i < count; ++i)
+        {
+            ::sendto(socketFd, datagrams[i].data, datagrams[i].length, 0,
+                     reinterpret_cast<sockaddr *>(&destinations[i]), sizeof(destinations[i]));
+        }
+#endif
+    }
+#endif
+}
+
+// Close the socket and the wake pipe
+void NetworkIOThread::closeAll()
+{
+#if defined(Q_OS_UNIX)
+    int *descriptors[] = {&socketFd, &wakeFds[0], &wakeFds[1]};
+    for (int *descriptor : descriptors)
+    {
+        if (*descriptor >= 0)
+        {
+            ::close(*descriptor);
+            *descriptor = -1;
+        }
+    }
+#endif
+}
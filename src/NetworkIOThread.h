@@ -0,0 +1,97 @@
+#ifndef NETWORKIOTHREAD_H
+#define NETWORKIOTHREAD_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "IngestQueue.h"
+#include "LockFreeQueue.h"
+#include "NetworkConfig.h"
+#include "Protocol.h"
+
+class DatagramCapture;
+
+namespace Metrics
+{
+    class Counter;
+}
+
+// Optional network I/O thread for CommunicationManager.
+// It owns a native UDP socket, drains it in batches (recvmmsg on Linux, recvfrom elsewhere),
+// decodes every datagram from ANS or Launcher and hands the result to the main thread through an IngestQueue
+// (a bounded SPSC queue for heartbeats, latest-wins for platform info); datagrams from other senders are dropped.
+// Outgoing datagrams travel the other way through a second SPSC queue and are sent in one batch
+// (sendmmsg on Linux), so a stalled GUI thread no longer delays packet handling.
+// Only available on Unix-like systems and IPv4; CommunicationManager falls back to QUdpSocket otherwise.
+class NetworkIOThread
+{
+public:
+    // An encoded datagram waiting to be sent
+    struct OutboundDatagram
+    {
+        quint32 address;                               // Destination IPv4 address, host byte order
+        quint16 port;                                  // Destination port
+        quint16 length;                                // Number of valid bytes in data
+        char data[Protocol::MAX_ENCODED_MESSAGE_SIZE]; // Encoded message
+    };
+
+    // 'inboundReady' is called on the I/O thread after a batch of messages has been queued
+    explicit NetworkIOThread(std::function<void()> inboundReady);
+    ~NetworkIOThread(); // Stops the thread and closes the socket
+
+    // Check whether the I/O thread is available on this platform
+    static bool isSupported();
+
+    // Bind to the IPv4 endpoint 'config.bind', set up multicast sending if configured, and start the thread;
+    // returns false if the socket could not be set up
+    bool start(const NetworkConfig &config);
+
+    // Stop the thread and close the socket
+    void stop();
+
+    // Queue a datagram for the IPv4 'address':'port' (main thread only); returns false if it does not fit or the queue is full
+    bool queueSend(quint32 address, quint16 port, const char *data, int length);
+
+    // Wake the I/O thread to send everything queued so far (main thread only)
+    void flushSends();
+
+    // Take the next received message (main thread only); returns false if none is waiting.
+    // receivedNs is MonotonicTime, the steady clock.
+    bool takeInbound(IngestQueue::Entry &message);
+
+    // Messages shed because the main thread fell behind
+    const IngestQueue &inboundQueue() const;
+
+    // Datagrams that were oversized, unknown or malformed
+    quint64 malformedDatagrams() const;
+
+    // Record every received datagram into 'capture' (null to stop); may be called while the thread runs
+    void setCapture(DatagramCapture *capture);
+
+private:
+    void run();          // I/O thread main loop
+    void receiveBatch(); // Read and decode everything the socket has
+    void sendPending();  // Send everything in the outbound queue
+    void closeAll();     // Close the socket and the wake pipe
+
+    // Read up to one batch; returns the count. Sender addresses are IPv4, host byte order.
+    int readBatch(qint64 *lengths, quint32 *senderAddresses, quint16 *senderPorts);
+
+    std::function<void()> inboundReady;     // Notifies the main thread
+    IngestQueue inbound;                    // I/O thread -> main thread
+    SpscQueue<OutboundDatagram> outbound;   // Main thread -> I/O thread
+    std::thread thread;                     // The I/O thread
+    std::atomic<bool> running;              // Cleared to stop the thread
+    std::atomic<quint64> malformed;         // Datagrams that could not be decoded
+    std::atomic<DatagramCapture *> capture; // Records received datagrams, if set
+    Metrics::Counter *parseFailureMetric;   // Unknown or malformed datagrams, shared with CommunicationManager
+    Metrics::Counter *unknownSenderMetric;  // Datagrams from neither peer, shared with CommunicationManager
+    NetworkConfig peers;                    // Endpoints datagrams are accepted from, set before the thread starts
+    int socketFd;                           // Native UDP socket
+    int wakeFds[2];                         // Pipe used to wake the thread from poll()
+    std::unique_ptr<char[]> receiveBuffers; // One slot per datagram of a batch
+};
+
+#endif
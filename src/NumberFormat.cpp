@@ -0,0 +1,82 @@
+#include "NumberFormat.h"
+#include <cmath>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace
+{
+#if !defined(__cpp_lib_to_chars)
+    // Fallback for standard libraries without floating-point std::to_chars: round to an integer
+    // number of 10^-decimals units and print that. Covers every value that fits in 18 digits.
+    int formatScaled(double value, int decimals, char *buffer, int capacity)
+    {
+        static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+        if (decimals < 0 || decimals > 9 || !std::isfinite(value))
+        {
+            return 0;
+        }
+        const double scaled = std::fabs(value) * powersOfTen[decimals] + 0.5;
+        if (scaled >= 1e18)
+        {
+            return 0;
+        }
+        quint64 units = quint64(scaled);
+
+        char digits[24];
+        int count = 0;
+        do
+        {
+            digits[count++] = char('0' + units % 10);
+            units /= 10;
+        } while (units != 0 || count <= decimals); // At least one digit before the point
+
+        const int length = (value < 0 ? 1 : 0) + count + (decimals > 0 ? 1 : 0);
+        if (length + 1 > capacity)
+        {
+            return 0;
+        }
+        int position = 0;
+        if (value < 0)
+        {
+            buffer[position++] = '-';
+        }
+        for (int i = count - 1; i >= 0; --i)
+        {
+            buffer[position++] = digits[i];
+            if (i == decimals && decimals > 0)
+            {
+                buffer[position++] = '.';
+            }
+        }
+        buffer[position] = '\0';
+        return position;
+    }
+#endif
+}
+
+namespace NumberFormat
+{
+    // Write a value with a fixed number of decimals
+    int formatFixed(double value, int decimals, char *buffer, int capacity)
+    {
+        if (capacity <= 1)
+        {
+            return 0;
+        }
+#if defined(__cpp_lib_to_chars)
+        std::to_chars_result result = std::to_chars(buffer, buffer + capacity - 1, value, std::chars_format::fixed, decimals);
+        if (result.ec != std::errc())
+        {
+            return 0;
+        }
+        *result.ptr = '\0';
+        return int(result.ptr - buffer);
+#else
+        return formatScaled(value, decimals, buffer, capacity);
+#endif
+    }
+}
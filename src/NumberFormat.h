@@ -0,0 +1,17 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <QtGlobal>
+
+// Locale-independent number formatting into caller buffers, without allocating
+namespace NumberFormat
+{
+    // Largest output of formatFixed for values the AKS displays, including the terminating zero
+    const int FIXED_BUFFER_SIZE = 48;
+
+    // Write 'value' with exactly 'decimals' fractional digits (like QString::number(value, 'f', decimals))
+    // and a terminating zero; returns the length, or 0 if it does not fit into 'capacity'
+    int formatFixed(double value, int decimals, char *buffer, int capacity);
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "PlatformInfoCoalescer.h"
+#include "Trace.h"
+#include <limits>
+
+// Constructor for PlatformInfoCoalescer
+PlatformInfoCoalescer::PlatformInfoCoalescer(MonotonicClock *clock, int frameIntervalMs, QObject *parent)
+    : QObject(parent), clock(clock), frameTimer(clock->createTimer(this)),
+      frameIntervalNs(0), lastPublishedNs(std::numeric_limits<qint64>::min() / 2), pending(false),
+      latitude(0.0), longitude(0.0), altitude(0.0), submitted(0), published(0)
+{
+    setFrameInterval(frameIntervalMs);
+    frameTimer->setSingleShot(true); // Armed only while a position is pending
+    frameTimer->setPrecise(true);    // Coarse timing would drift off the frame boundaries
+    connect(frameTimer, &ClockTimer::timeout, this, &PlatformInfoCoalescer::publish);
+}
+
+// Change the pacing
+void PlatformInfoCoalescer::setFrameInterval(int frameIntervalMs)
+{
+    frameIntervalNs = qint64(qMax(frameIntervalMs, 1)) * 1000000;
+}
+
+// Shortest time between two published positions
+int PlatformInfoCoalescer::frameInterval() const
+{
+    return int(frameIntervalNs / 1000000);
+}
+
+// Positions received
+quint64 PlatformInfoCoalescer::submittedCount() const
+{
+    return submitted;
+}
+
+// Positions passed on
+quint64 PlatformInfoCoalescer::publishedCount() const
+{
+    return published;
+}
+
+// Record the newest position
+void PlatformInfoCoalescer::submit(double latitude, double longitude, double altitude)
+{
+    this->latitude = latitude; // Overwrite whatever is still pending
+    this->longitude = longitude;
+    this->altitude = altitude;
+    pending = true;
+    ++submitted;
+
+    if (frameTimer->isActive())
+    {
+        return; // Already waiting for the next frame
+    }
+    const qint64 waitNs = lastPublishedNs + frameIntervalNs - clock->nowNs();
+    if (waitNs <= 0)
+    {
+        publish(); // Quiet for at least a frame, show it now
+        return;
+    }
+    frameTimer->start(int((waitNs + 999999) / 1000000)); // Round up so frames never come too close
+}
+
+// Pass the pending position on
+void PlatformInfoCoalescer::publish()
+{
+    TRACE_SCOPE("PlatformInfoCoalescer::publish");
+    if (!pending)
+    {
+        return;
+    }
+    pending = false;
+    lastPublishedNs = clock->nowNs();
+    ++published;
+    emit platformInfoReady(latitude, longitude, altitude);
+}
@@ -0,0 +1,50 @@
+#ifndef PLATFORMINFOCOALESCER_H
+#define PLATFORMINFOCOALESCER_H
+
+#include <QObject>
+#include "MonotonicClock.h"
+
+// Latest-value-wins stage between AKSCore's platform info events and the GUI.
+// Every submitted position overwrites the pending one, and at most one position is published per
+// frame interval (normally the display refresh period), so the packet rate no longer drives the GUI.
+// A position that arrives after a quiet period is published at once; the timer only runs while a
+// newer position is waiting for the next frame.
+class PlatformInfoCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 'frameIntervalMs' is the shortest time between two published positions
+    explicit PlatformInfoCoalescer(MonotonicClock *clock, int frameIntervalMs, QObject *parent = nullptr);
+
+    // Change the pacing, e.g. when the window moves to a screen with another refresh rate
+    void setFrameInterval(int frameIntervalMs);
+    int frameInterval() const;
+
+    quint64 submittedCount() const; // Positions received
+    quint64 publishedCount() const; // Positions passed on; the difference was superseded before display
+
+public slots:
+    // Record the newest position (latest wins)
+    void submit(double latitude, double longitude, double altitude);
+
+signals:
+    void platformInfoReady(double latitude, double longitude, double altitude); // At most once per frame
+
+private slots:
+    void publish(); // Pass the pending position on
+
+private:
+    MonotonicClock *clock;  // Source of time and of the frame timer
+    ClockTimer *frameTimer; // Single-shot timer for the next frame with a pending position
+    qint64 frameIntervalNs; // Shortest time between two publications
+    qint64 lastPublishedNs; // Clock time of the last publication
+    bool pending;           // A position is waiting to be published
+    double latitude;        // Pending latitude
+    double longitude;       // Pending longitude
+    double altitude;        // Pending altitude
+    quint64 submitted;      // Positions received
+    quint64 published;      // Positions passed on
+};
+
+#endif
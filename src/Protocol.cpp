@@ -0,0 +1,446 @@
+#include "Protocol.h"
+#include <QtEndian>
+#include <cstring>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace
+{
+    // Compare a datagram against a literal without building temporaries
+    template <size_t N>
+    bool equalsLiteral(const char *data, qint64 size, const char (&literal)[N])
+    {
+        return size == qint64(N - 1) && std::memcmp(data, literal, N - 1) == 0;
+    }
+
+    // Check that a datagram starts with a literal
+    template <size_t N>
+    bool startsWithLiteral(const char *data, qint64 size, const char (&literal)[N])
+    {
+        return size >= qint64(N - 1) && std::memcmp(data, literal, N - 1) == 0;
+    }
+
+    // Match a heartbeat literal, alone or followed by ",fields"
+    template <size_t N>
+    bool matchesHeartbeat(const char *data, qint64 size, const char (&literal)[N])
+    {
+        return equalsLiteral(data, size, literal) ||
+               (size > qint64(N - 1) && data[N - 1] == ',' && std::memcmp(data, literal, N - 1) == 0);
+    }
+
+    // Text of a heartbeat type, nullptr for other types
+    const char *heartbeatText(quint8 type, int *length)
+    {
+        switch (type)
+        {
+        case Protocol::AKSHeartbeat:
+            *length = int(sizeof(Protocol::AKS_HEARTBEAT_TEXT) - 1);
+            return Protocol::AKS_HEARTBEAT_TEXT;
+        case Protocol::ANSHeartbeat:
+            *length = int(sizeof(Protocol::ANS_HEARTBEAT_TEXT) - 1);
+            return Protocol::ANS_HEARTBEAT_TEXT;
+        case Protocol::LauncherHeartbeat:
+            *length = int(sizeof(Protocol::LAUNCHER_HEARTBEAT_TEXT) - 1);
+            return Protocol::LAUNCHER_HEARTBEAT_TEXT;
+        default:
+            return nullptr;
+        }
+    }
+
+    // Parse a decimal integer occupying exactly [begin, end)
+    bool parseInteger(const char *begin, const char *end, qint64 *value)
+    {
+        bool negative = begin < end && *begin == '-';
+        if (negative)
+        {
+            ++begin;
+        }
+        if (begin == end || end - begin > 18)
+        {
+            return false; // Empty or beyond what the fields can hold
+        }
+        qint64 result = 0;
+        for (; begin < end; ++begin)
+        {
+            if (*begin < '0' || *begin > '9')
+            {
+                return false;
+            }
+            result = result * 10 + (*begin - '0');
+        }
+        *value = negative ? -result : result;
+        return true;
+    }
+
+    // Write a decimal integer; returns the number of characters
+    int writeInteger(qint64 value, char *out)
+    {
+        char digits[20];
+        int count = 0;
+        quint64 magnitude = value < 0 ? quint64(0) - quint64(value) : quint64(value);
+        do
+        {
+            digits[count++] = char('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        int length = 0;
+        if (value < 0)
+        {
+            out[length++] = '-';
+        }
+        while (count > 0)
+        {
+            out[length++] = digits[--count];
+        }
+        return length;
+    }
+
+    // Parse ",seq,timestampNs[,echoSeq,echoTimestampNs,echoDelayNs]" following a heartbeat literal
+    bool parseHeartbeatFields(const char *cursor, const char *end, Protocol::Message &message)
+    {
+        qint64 fields[5];
+        int count = 0;
+        while (cursor < end)
+        {
+            if (*cursor != ',' || count == 5)
+            {
+                return false;
+            }
+            ++cursor;
+            const char *fieldEnd = static_cast<const char *>(std::memchr(cursor, ',', size_t(end - cursor)));
+            if (!fieldEnd)
+            {
+                fieldEnd = end;
+            }
+            if (!parseInteger(cursor, fieldEnd, &fields[count++]))
+            {
+                return false;
+            }
+            cursor = fieldEnd;
+        }
+        if (count != 2 && count != 5)
+        {
+            return false; // Sequence and timestamp, optionally followed by a full echo
+        }
+
+        message.encoding = Protocol::ExtendedTextEncoding;
+        message.hasSequence = true;
+        message.sequence = quint32(fields[0]);
+        message.timestampNs = fields[1];
+        if (count == 5)
+        {
+            message.hasEcho = true;
+            message.echoSequence = quint32(fields[2]);
+            message.echoTimestampNs = fields[3];
+            message.echoDelayNs = fields[4];
+        }
+        return true;
+    }
+
+    // Read a little-endian double
+    double readDouble(const char *data)
+    {
+        quint64 bits = qFromLittleEndian<quint64>(reinterpret_cast<const uchar *>(data));
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Write a little-endian double
+    void writeDouble(double value, char *data)
+    {
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        qToLittleEndian(bits, reinterpret_cast<uchar *>(data));
+    }
+
+    // Minimum payload size of a binary message type, -1 for unknown types
+    int payloadSize(quint8 type)
+    {
+        switch (type)
+        {
+        case Protocol::AKSHeartbeat:
+        case Protocol::ANSHeartbeat:
+        case Protocol::LauncherHeartbeat:
+            return 0;
+        case Protocol::PlatformInfo:
+            return Protocol::PLATFORM_INFO_PAYLOAD_SIZE;
+        default:
+            return -1;
+        }
+    }
+
+#if !defined(__cpp_lib_to_chars)
+    // Fallback for standard libraries without floating-point std::from_chars.
+    // Exact for up to 15 significant digits with a decimal exponent of at most 22,
+    // which covers the fixed-point values the subsystems send.
+    bool parseDecimal(const char *begin, const char *end, double *value)
+    {
+        static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        const char *cursor = begin;
+        bool negative = false;
+        if (cursor < end && (*cursor == '-' || *cursor == '+'))
+        {
+            negative = (*cursor == '-');
+            ++cursor;
+        }
+
+        quint64 mantissa = 0;
+        int digits = 0;
+        int fractionDigits = 0;
+        bool seenPoint = false;
+        for (; cursor < end; ++cursor)
+        {
+            if (*cursor == '.' && !seenPoint)
+            {
+                seenPoint = true;
+                continue;
+            }
+            if (*cursor < '0' || *cursor > '9' || digits >= 19)
+            {
+                return false; // Unexpected character or too many digits
+            }
+            mantissa = mantissa * 10 + quint64(*cursor - '0');
+            ++digits;
+            if (seenPoint)
+            {
+                ++fractionDigits;
+            }
+        }
+        if (digits == 0 || fractionDigits > 22)
+        {
+            return false;
+        }
+
+        double result = double(mantissa) / powersOfTen[fractionDigits];
+        *value = negative ? -result : result;
+        return true;
+    }
+#endif
+}
+
+namespace Protocol
+{
+    // Classify a datagram by its content
+    MessageType classify(const char *data, qint64 size)
+    {
+        if (startsWithLiteral(data, size, PLATFORM_INFO_PREFIX))
+        {
+            return PlatformInfo;
+        }
+        if (matchesHeartbeat(data, size, ANS_HEARTBEAT_TEXT))
+        {
+            return ANSHeartbeat;
+        }
+        if (matchesHeartbeat(data, size, LAUNCHER_HEARTBEAT_TEXT))
+        {
+            return LauncherHeartbeat;
+        }
+        if (matchesHeartbeat(data, size, AKS_HEARTBEAT_TEXT))
+        {
+            return AKSHeartbeat;
+        }
+        return UnknownMessage;
+    }
+
+    // Decode a datagram in either encoding
+    bool decode(const char *data, qint64 size, Message &message)
+    {
+        if (isBinary(data, size))
+        {
+            return decodeBinary(data, size, message);
+        }
+
+        message.encoding = TextEncoding;
+        message.hasSequence = false;
+        message.hasEcho = false;
+        message.type = classify(data, size);
+        switch (message.type)
+        {
+        case PlatformInfo:
+            return parsePlatformInfo(data, size, &message.latitude, &message.longitude, &message.altitude);
+        case UnknownMessage:
+            return false;
+        default:
+        {
+            int length = 0;
+            heartbeatText(message.type, &length);
+            return size == length || parseHeartbeatFields(data + length, data + size, message); // Legacy or extended
+        }
+        }
+    }
+
+    // Check whether a datagram starts with the binary magic
+    bool isBinary(const char *data, qint64 size)
+    {
+        return size >= 2 && qFromLittleEndian<quint16>(reinterpret_cast<const uchar *>(data)) == BINARY_MAGIC;
+    }
+
+    // Decode a binary datagram
+    bool decodeBinary(const char *data, qint64 size, Message &message)
+    {
+        if (size < BINARY_HEADER_SIZE || !isBinary(data, size))
+        {
+            return false;
+        }
+        if (quint8(data[2]) != BINARY_VERSION)
+        {
+            return false; // Unsupported version
+        }
+        quint8 type = quint8(data[3]);
+        int expectedPayload = payloadSize(type);
+        if (expectedPayload < 0 || size < BINARY_HEADER_SIZE + expectedPayload)
+        {
+            return false; // Unknown type or truncated payload
+        }
+
+        message.type = MessageType(type);
+        message.encoding = BinaryEncoding;
+        message.hasSequence = true;
+        message.sequence = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(data + 4));
+        message.timestampNs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(data + 8));
+        message.hasEcho = expectedPayload == 0 && size >= BINARY_HEADER_SIZE + HEARTBEAT_ECHO_SIZE;
+        if (message.hasEcho)
+        {
+            const char *echo = data + BINARY_HEADER_SIZE;
+            message.echoSequence = qFromLittleEndian<quint32>(reinterpret_cast<const uchar *>(echo));
+            message.echoTimestampNs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(echo + 4));
+            message.echoDelayNs = qFromLittleEndian<qint64>(reinterpret_cast<const uchar *>(echo + 12));
+        }
+        if (type == PlatformInfo)
+        {
+            const char *payload = data + BINARY_HEADER_SIZE;
+            message.latitude = readDouble(payload);
+            message.longitude = readDouble(payload + 8);
+            message.altitude = readDouble(payload + 16);
+        }
+        return true;
+    }
+
+    // Encode a message in binary form
+    int encodeBinary(const Message &message, char *buffer, int capacity)
+    {
+        int payload = payloadSize(message.type);
+        if (payload == 0 && message.hasEcho)
+        {
+            payload = HEARTBEAT_ECHO_SIZE; // Heartbeat carrying an echo
+        }
+        if (payload < 0 || capacity < BINARY_HEADER_SIZE + payload)
+        {
+            return 0;
+        }
+
+        qToLittleEndian(BINARY_MAGIC, reinterpret_cast<uchar *>(buffer));
+        buffer[2] = char(BINARY_VERSION);
+        buffer[3] = char(message.type);
+        qToLittleEndian(message.sequence, reinterpret_cast<uchar *>(buffer + 4));
+        qToLittleEndian(message.timestampNs, reinterpret_cast<uchar *>(buffer + 8));
+        if (message.type == PlatformInfo)
+        {
+            char *out = buffer + BINARY_HEADER_SIZE;
+            writeDouble(message.latitude, out);
+            writeDouble(message.longitude, out + 8);
+            writeDouble(message.altitude, out + 16);
+        }
+        else if (payload == HEARTBEAT_ECHO_SIZE)
+        {
+            uchar *echo = reinterpret_cast<uchar *>(buffer + BINARY_HEADER_SIZE);
+            qToLittleEndian(message.echoSequence, echo);
+            qToLittleEndian(message.echoTimestampNs, echo + 4);
+            qToLittleEndian(message.echoDelayNs, echo + 12);
+        }
+        return BINARY_HEADER_SIZE + payload;
+    }
+
+    // Encode a heartbeat in (extended) text form
+    int encodeTextHeartbeat(const Message &message, char *buffer, int capacity)
+    {
+        int length = 0;
+        const char *text = heartbeatText(message.type, &length);
+        const int maxFieldsLength = 5 * 21; // Five comma-prefixed integers of at most 20 characters
+        if (!text || capacity < length + maxFieldsLength)
+        {
+            return 0;
+        }
+
+        std::memcpy(buffer, text, size_t(length));
+        if (message.hasSequence)
+        {
+            qint64 fields[5] = {message.sequence, message.timestampNs,
+                                message.echoSequence, message.echoTimestampNs, message.echoDelayNs};
+            int count = message.hasEcho ? 5 : 2;
+            for (int i = 0; i < count; ++i)
+            {
+                buffer[length++] = ',';
+                length += writeInteger(fields[i], buffer + length);
+            }
+        }
+        return length;
+    }
+
+    // Parse "PLATFORM_INFO,lat,lon,alt"
+    bool parsePlatformInfo(const char *data, qint64 size, double *latitude, double *longitude, double *altitude)
+    {
+        if (!startsWithLiteral(data, size, PLATFORM_INFO_PREFIX))
+        {
+            return false;
+        }
+
+        double *fields[] = {latitude, longitude, altitude};
+        const char *cursor = data + sizeof(PLATFORM_INFO_PREFIX) - 1;
+        const char *end = data + size;
+        for (int i = 0; i < 3; ++i)
+        {
+            const char *fieldEnd = static_cast<const char *>(std::memchr(cursor, ',', size_t(end - cursor)));
+            if (!fieldEnd)
+            {
+                fieldEnd = end;
+            }
+            if ((i < 2) != (fieldEnd < end))
+            {
+                return false; // Wrong number of fields
+            }
+            if (!parseDouble(cursor, fieldEnd, fields[i]))
+            {
+                return false;
+            }
+            cursor = fieldEnd + 1;
+        }
+        return true;
+    }
+
+    // Parse a decimal number occupying exactly [begin, end)
+    bool parseDouble(const char *begin, const char *end, double *value)
+    {
+        // Tolerate surrounding whitespace such as a trailing newline
+        while (begin < end && (*begin == ' ' || *begin == '\t'))
+        {
+            ++begin;
+        }
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n'))
+        {
+            --end;
+        }
+        if (begin == end)
+        {
+            return false;
+        }
+
+#if defined(__cpp_lib_to_chars)
+        if (*begin == '+')
+        {
+            ++begin; // std::from_chars does not accept a leading plus
+        }
+        std::from_chars_result result = std::from_chars(begin, end, *value);
+        return result.ec == std::errc() && result.ptr == end;
+#else
+        return parseDecimal(begin, end, value);
+#endif
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <QtGlobal>
+
+// Encoding and decoding of the messages exchanged with ANS and Launcher.
+// Everything here works in place on the caller's bytes and never allocates.
+//
+// Three encodings are understood:
+//   Text   (legacy) : "AKS_HEARTBEAT", "ANS_HEARTBEAT", "LAUNCHER_HEARTBEAT", "PLATFORM_INFO,lat,lon,alt"
+//   Extended text   : heartbeats carry ",seq,timestampNs" and optionally ",echoSeq,echoTimestampNs,echoDelayNs"
+//   Binary          : 16-byte header followed by a fixed-layout payload, all little-endian
+//       Header      : magic (u16, 0x4BA5), version (u8), type (u8, MessageType), sequence (u32), timestamp ns (i64)
+//       PlatformInfo: latitude, longitude, altitude (f64 each)
+//       Heartbeats  : optional echo: echoed sequence (u32), echoed timestamp ns (i64), hold time ns (i64)
+// The first magic byte is not ASCII, so a datagram's encoding is recognised from its first bytes.
+// Receivers ignore bytes after the fixed payload, which leaves room for compatible additions within a version.
+//
+// Echo: a peer returns the sequence and timestamp of the last AKS heartbeat it received, together with
+// how long it held it before replying, so the AKS can measure the round-trip time with its own clock.
+namespace Protocol
+{
+    // Kinds of messages the AKS understands; the values are the binary type codes
+    enum MessageType : quint8
+    {
+        UnknownMessage = 0,    // Anything we could not classify
+        AKSHeartbeat = 1,      // "AKS_HEARTBEAT"
+        ANSHeartbeat = 2,      // "ANS_HEARTBEAT"
+        LauncherHeartbeat = 3, // "LAUNCHER_HEARTBEAT"
+        PlatformInfo = 4       // "PLATFORM_INFO,lat,lon,alt"
+    };
+
+    // Wire encodings
+    enum Encoding
+    {
+        TextEncoding,         // Legacy ASCII messages
+        ExtendedTextEncoding, // ASCII heartbeats with sequence, timestamp and echo fields
+        BinaryEncoding        // Versioned fixed-layout messages
+    };
+
+    const quint16 BINARY_MAGIC = 0x4BA5;       // First two bytes of every binary message (A5 4B on the wire)
+    const quint8 BINARY_VERSION = 1;           // Current binary protocol version
+    const int BINARY_HEADER_SIZE = 16;         // Magic + version + type + sequence + timestamp
+    const int PLATFORM_INFO_PAYLOAD_SIZE = 24; // Three doubles
+    const int HEARTBEAT_ECHO_SIZE = 20;        // Echoed sequence + echoed timestamp + hold time
+    const int MAX_BINARY_MESSAGE_SIZE = BINARY_HEADER_SIZE + PLATFORM_INFO_PAYLOAD_SIZE; // Largest binary message
+    const int MAX_ENCODED_MESSAGE_SIZE = 128;  // Largest message we encode in any form
+
+    // A decoded message
+    struct Message
+    {
+        MessageType type = UnknownMessage; // Kind of message
+        Encoding encoding = TextEncoding;  // Encoding it arrived in
+        bool hasSequence = false;          // Sequence and timestamp are present (binary or extended text)
+        quint32 sequence = 0;              // Sender's sequence number
+        qint64 timestampNs = 0;            // Sender's monotonic send time
+        bool hasEcho = false;              // Heartbeats only: echo fields are present
+        quint32 echoSequence = 0;          // Sequence of the AKS heartbeat being echoed
+        qint64 echoTimestampNs = 0;        // Timestamp of the AKS heartbeat being echoed
+        qint64 echoDelayNs = 0;            // Time the peer held that heartbeat before replying
+        double latitude = 0.0;             // PlatformInfo only
+        double longitude = 0.0;            // PlatformInfo only
+        double altitude = 0.0;             // PlatformInfo only
+    };
+
+    // Wire text of the heartbeats
+    const char AKS_HEARTBEAT_TEXT[] = "AKS_HEARTBEAT";
+    const char ANS_HEARTBEAT_TEXT[] = "ANS_HEARTBEAT";
+    const char LAUNCHER_HEARTBEAT_TEXT[] = "LAUNCHER_HEARTBEAT";
+    const char PLATFORM_INFO_PREFIX[] = "PLATFORM_INFO,";
+
+    // Classify a datagram by its content
+    MessageType classify(const char *data, qint64 size);
+
+    // Decode a datagram in either encoding; returns false for unknown or malformed messages
+    bool decode(const char *data, qint64 size, Message &message);
+
+    // Check whether a datagram starts with the binary magic
+    bool isBinary(const char *data, qint64 size);
+
+    // Decode a binary datagram; returns false for a wrong magic, unsupported version or short payload
+    bool decodeBinary(const char *data, qint64 size, Message &message);
+
+    // Encode a message in binary form; returns the number of bytes written, or 0 if it does not fit
+    int encodeBinary(const Message &message, char *buffer, int capacity);
+
+    // Encode a heartbeat in (extended) text form; returns the number of bytes written, or 0 if it does not fit.
+    // Sequence and echo fields are written only when hasSequence / hasEcho are set.
+    int encodeTextHeartbeat(const Message &message, char *buffer, int capacity);
+
+    // Parse "PLATFORM_INFO,lat,lon,alt"; returns false if the format is wrong
+    bool parsePlatformInfo(const char *data, qint64 size, double *latitude, double *longitude, double *altitude);
+
+    // Parse a decimal number occupying exactly [begin, end), independent of the C locale
+    bool parseDouble(const char *begin, const char *end, double *value);
+}
+
+#endif
@@ -0,0 +1,187 @@
+#include "StartupTimeline.h"
+#include "CommunicationManager.h"
+#include "GlobalConstants.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <cstring>
+
+namespace
+{
+    const qint64 MILESTONE = -1; // Entry::lengthNs of a reached milestone
+    const qint64 PENDING = -2;   // Entry::lengthNs of a milestone not reached yet
+
+    // Milliseconds with one decimal
+    QString milliseconds(qint64 ns)
+    {
+        return QString::number(double(ns) / 1e6, 'f', 1);
+    }
+}
+
+// Start timing a phase
+StartupTimeline::Phase::Phase(StartupTimeline *timeline, const char *name)
+    : timeline(timeline), name(name), beginNs(timeline ? timeline->clock()->nowNs() : 0), trace(name)
+{
+}
+
+// Record the phase
+StartupTimeline::Phase::~Phase()
+{
+    if (timeline)
+    {
+        timeline->recordPhase(name, beginNs, timeline->clock()->nowNs());
+    }
+}
+
+// Constructor for StartupTimeline
+StartupTimeline::StartupTimeline(MonotonicClock *clock, qint64 startNs, QObject *parent)
+    : QObject(parent), timeClock(clock), startNs(startNs), timeoutTimer(clock->createTimer(this)), logged(false)
+{
+    linkUpMetric = &Metrics::Registry::instance().gauge("aks_startup_link_up_ms",
+                                                        "Milliseconds from process start until the first heartbeat of every peer.");
+    timeoutTimer->setSingleShot(true);
+    connect(timeoutTimer, &ClockTimer::timeout, this, &StartupTimeline::log);
+    timeoutTimer->start(GlobalConstants::STARTUP_TIMELINE_TIMEOUT_MS);
+}
+
+// Record a phase that ran from 'beginNs' to 'endNs'
+void StartupTimeline::recordPhase(const char *name, qint64 beginNs, qint64 endNs)
+{
+    entries.append(Entry{name, beginNs - startNs, endNs - beginNs});
+}
+
+// Wait for the first heartbeat of each peer of 'manager' before logging
+void StartupTimeline::watch(CommunicationManager *manager)
+{
+    expectMilestone("first ANS heartbeat");
+    expectMilestone("first Launcher heartbeat");
+    watchConnections << connect(manager, &CommunicationManager::ansHeartbeatReceived, this, [this]()
+                                { reachMilestone("first ANS heartbeat"); });
+    watchConnections << connect(manager, &CommunicationManager::launcherHeartbeatReceived, this, [this]()
+                                { reachMilestone("first Launcher heartbeat"); });
+}
+
+// Record a milestone now, the first time it is reached
+void StartupTimeline::reachMilestone(const char *name)
+{
+    for (Entry &entry : entries)
+    {
+        if (std::strcmp(entry.name, name) == 0)
+        {
+            if (entry.lengthNs != PENDING)
+            {
+                return; // Reached before; only until the last milestone, then the heartbeats are disconnected
+            }
+            entry.beginNs = timeClock->nowNs() - startNs;
+            entry.lengthNs = MILESTONE;
+            if (allMilestonesReached())
+            {
+                stopWatching(); // Nothing left to wait for, later heartbeats need not pass through here
+            }
+            if (logged)
+            {
+                // After the timeout: the timeline is out already, report the late milestone on its own
+                LOG_INFO(QString("Startup timeline: %1 at %2 ms").arg(name, milliseconds(entry.beginNs)));
+                exportLinkUp();
+            }
+            else if (allMilestonesReached())
+            {
+                log();
+            }
+            return;
+        }
+    }
+    entries.append(Entry{name, timeClock->nowNs() - startNs, MILESTONE}); // Not expected, recorded anyway
+}
+
+// "<phase> <duration> ms at <start> ms, ..., <milestone> at <time> ms, ..."
+QString StartupTimeline::toString() const
+{
+    QStringList parts;
+    for (const Entry &entry : entries)
+    {
+        if (entry.lengthNs == PENDING)
+        {
+            parts << QString("%1 pending").arg(entry.name);
+        }
+        else if (entry.lengthNs == MILESTONE)
+        {
+            parts << QString("%1 at %2 ms").arg(entry.name, milliseconds(entry.beginNs));
+        }
+        else
+        {
+            parts << QString("%1 %2 ms at %3 ms").arg(entry.name, milliseconds(entry.lengthNs), milliseconds(entry.beginNs));
+        }
+    }
+    return parts.join(", ");
+}
+
+// Write the timeline to the log, once
+void StartupTimeline::log()
+{
+    if (logged)
+    {
+        return;
+    }
+    logged = true;
+    timeoutTimer->stop();
+
+    exportLinkUp();
+    LOG_INFO("Startup timeline: " + toString());
+}
+
+// Export the time until the last milestone, once all of them were reached
+void StartupTimeline::exportLinkUp()
+{
+    qint64 linkUpNs = -1;
+    for (const Entry &entry : entries)
+    {
+        if (entry.lengthNs == PENDING)
+        {
+            return;
+        }
+        if (entry.lengthNs == MILESTONE)
+        {
+            linkUpNs = qMax(linkUpNs, entry.beginNs);
+        }
+    }
+    if (linkUpNs >= 0)
+    {
+        linkUpMetric->set(linkUpNs / 1000000);
+    }
+}
+
+// Disconnect the heartbeat signals watch() connected
+void StartupTimeline::stopWatching()
+{
+    for (const QMetaObject::Connection &connection : watchConnections)
+    {
+        disconnect(connection);
+    }
+    watchConnections.clear();
+}
+
+// True if no expected milestone is pending
+bool StartupTimeline::allMilestonesReached() const
+{
+    for (const Entry &entry : entries)
+    {
+        if (entry.lengthNs == PENDING)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Add a pending milestone
+void StartupTimeline::expectMilestone(const char *name)
+{
+    for (const Entry &entry : entries)
+    {
+        if (std::strcmp(entry.name, name) == 0)
+        {
+            return; // Already expected or reached
+        }
+    }
+    entries.append(Entry{name, 0, PENDING});
+}
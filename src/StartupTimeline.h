@@ -0,0 +1,93 @@
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include "MonotonicClock.h"
+#include "Trace.h"
+
+class CommunicationManager;
+
+namespace Metrics
+{
+    class Gauge;
+}
+
+// What happens between main() and the links coming up, logged once per boot.
+// Phases (building the widgets, loading the configuration, binding the socket) have a start and a
+// duration; milestones (the first heartbeat from each peer) are instants. Times are relative to the
+// process start passed to the constructor, read as early in main() as possible. The timeline is logged
+// as one line once every expected milestone has been reached, or STARTUP_TIMELINE_TIMEOUT_MS after the
+// start with the missing ones marked as pending, so a peer that never answers still gets a timeline.
+// The time until both peers were heard is also exported as the aks_startup_link_up_ms metric.
+class StartupTimeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Times a phase from construction to destruction, and traces it as a span
+    class Phase
+    {
+    public:
+        Phase(StartupTimeline *timeline, const char *name); // 'name' must outlive the timeline (a literal); 'timeline' may be null
+        ~Phase();
+
+        Phase(const Phase &) = delete;
+        Phase &operator=(const Phase &) = delete;
+
+    private:
+        StartupTimeline *timeline; // Records the phase, if not null
+        const char *name;          // Phase name
+        qint64 beginNs;            // Clock time at construction
+        Trace::Scope trace;        // The same phase in the trace, when tracing
+    };
+
+    // 'startNs' is the process start on 'clock'
+    StartupTimeline(MonotonicClock *clock, qint64 startNs, QObject *parent = nullptr);
+
+    // Record a phase that ran from 'beginNs' to 'endNs'
+    void recordPhase(const char *name, qint64 beginNs, qint64 endNs);
+
+    // Wait for the first heartbeat of each peer of 'manager' before logging;
+    // the heartbeat signals are disconnected again once every milestone is reached
+    void watch(CommunicationManager *manager);
+
+    // Record a milestone now, the first time it is reached; later calls are ignored
+    void reachMilestone(const char *name);
+
+    // True once the timeline was logged
+    bool isLogged() const { return logged; }
+
+    // "<phase> <duration> ms at <start> ms, ..., <milestone> at <time> ms, ..."
+    QString toString() const;
+
+    MonotonicClock *clock() const { return timeClock; } // Clock the times are read from
+
+private slots:
+    void log(); // Write the timeline to the log, once
+
+private:
+    // A phase or a milestone
+    struct Entry
+    {
+        const char *name; // Phase or milestone name
+        qint64 beginNs;   // Start, relative to the process start
+        qint64 lengthNs;  // Duration; -1 for a milestone, -2 for a milestone not reached yet
+    };
+
+    bool allMilestonesReached() const;      // True if no expected milestone is pending
+    void expectMilestone(const char *name); // Add a pending milestone
+    void exportLinkUp();                    // Set linkUpMetric once every milestone was reached
+    void stopWatching();                    // Disconnect the heartbeat signals watch() connected
+
+    MonotonicClock *timeClock;                         // Source of time
+    qint64 startNs;                                    // Process start
+    QVector<Entry> entries;                            // In the order they were recorded or expected
+    QVector<QMetaObject::Connection> watchConnections; // Heartbeat signals feeding the milestones
+    ClockTimer *timeoutTimer;                          // Logs the timeline if a milestone never comes
+    bool logged;                                       // The timeline was written
+    Metrics::Gauge *linkUpMetric;                      // Milliseconds until both peers were heard
+};
+
+#endif
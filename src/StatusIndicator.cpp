@@ -0,0 +1,54 @@
+#include "StatusIndicator.h"
+#include <QPainter>
+
+// Constructor for StatusIndicator
+StatusIndicator::StatusIndicator(QWidget *parent)
+    : QWidget(parent), m_active(false)
+{
+}
+
+// Set the state
+void StatusIndicator::setActive(bool active)
+{
+    if (active == m_active)
+    {
+        return; // Same state, nothing to repaint
+    }
+    m_active = active;
+    update(); // Schedule a repaint of the new state
+}
+
+// Default lamp size
+QSize StatusIndicator::sizeHint() const
+{
+    return QSize(20, 20);
+}
+
+// Handle paint events
+void StatusIndicator::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);        // The whole lamp is one pixmap
+    QPainter painter(this); // Create a painter for the widget
+    painter.drawPixmap(0, 0, pixmapFor(m_active, size(), devicePixelRatioF()));
+}
+
+// Lamp image for a state
+const QPixmap &StatusIndicator::pixmapFor(bool active, const QSize &size, qreal devicePixelRatio)
+{
+    static QPixmap cache[2]; // Inactive, active
+    QPixmap &pixmap = cache[active ? 1 : 0];
+    const QSize pixelSize = size * devicePixelRatio;
+    if (pixmap.isNull() || pixmap.size() != pixelSize)
+    {
+        pixmap = QPixmap(pixelSize);
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing); // Smooth edge like the former border-radius
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(active ? QColor(0, 128, 0) : QColor(255, 0, 0)); // The stylesheet colours "green" and "red"
+        painter.drawEllipse(QRectF(QPointF(0, 0), QSizeF(size)));
+    }
+    return pixmap;
+}
@@ -0,0 +1,36 @@
+#ifndef STATUSINDICATOR_H
+#define STATUSINDICATOR_H
+
+#include <QWidget>
+#include <QPixmap>
+
+// Round connection status lamp: green when active, red otherwise.
+// Painted from one cached pixmap per state instead of a stylesheet, and only repainted when the
+// state actually changes, so status signals can arrive at any rate.
+class StatusIndicator : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StatusIndicator(QWidget *parent = nullptr); // Constructor, starts inactive
+
+    // Set the state; does nothing if it is unchanged
+    void setActive(bool active);
+
+    // Current state
+    bool isActive() const { return m_active; }
+
+    QSize sizeHint() const override; // Default lamp size
+
+protected:
+    // Handle paint events
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    // Lamp image for a state, rendered once per size and device pixel ratio and shared by all indicators
+    static const QPixmap &pixmapFor(bool active, const QSize &size, qreal devicePixelRatio);
+
+    bool m_active; // Current state
+};
+
+#endif
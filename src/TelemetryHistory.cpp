@@ -0,0 +1,224 @@
+#include "TelemetryHistory.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    const int RANGE_ATTEMPTS = 3; // Queries repeated when the writer overwrote the samples being searched
+
+    // Smallest power of two not below 'value'
+    quint64 roundUpToPowerOfTwo(int value)
+    {
+        quint64 size = 1;
+        while (size < quint64(std::max(value, 1)))
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    // Drop the first 'count' samples of 'snapshot'
+    void dropFront(TelemetryHistory::Snapshot &snapshot, size_t count)
+    {
+        count = std::min(count, snapshot.timestampsNs.size());
+        if (count == 0)
+        {
+            return;
+        }
+        snapshot.timestampsNs.erase(snapshot.timestampsNs.begin(), snapshot.timestampsNs.begin() + count);
+        snapshot.latitudes.erase(snapshot.latitudes.begin(), snapshot.latitudes.begin() + count);
+        snapshot.longitudes.erase(snapshot.longitudes.begin(), snapshot.longitudes.begin() + count);
+        snapshot.altitudes.erase(snapshot.altitudes.begin(), snapshot.altitudes.begin() + count);
+    }
+
+    // Keep the first 'count' samples of 'snapshot'
+    void keepFront(TelemetryHistory::Snapshot &snapshot, size_t count)
+    {
+        count = std::min(count, snapshot.timestampsNs.size());
+        snapshot.timestampsNs.resize(count);
+        snapshot.latitudes.resize(count);
+        snapshot.longitudes.resize(count);
+        snapshot.altitudes.resize(count);
+    }
+}
+
+// Empty, keeping the allocations
+void TelemetryHistory::Snapshot::clear()
+{
+    timestampsNs.clear();
+    latitudes.clear();
+    longitudes.clear();
+    altitudes.clear();
+}
+
+// Constructor for TelemetryHistory
+TelemetryHistory::TelemetryHistory(int capacity)
+    : mask(roundUpToPowerOfTwo(capacity) - 1),
+      timestamps(new std::atomic<qint64>[mask + 1]),
+      latitudes(new std::atomic<double>[mask + 1]),
+      longitudes(new std::atomic<double>[mask + 1]),
+      altitudes(new std::atomic<double>[mask + 1]),
+      started(0),
+      committed(0),
+      lastTimestampNs(std::numeric_limits<qint64>::min())
+{
+}
+
+// Append a sample, overwriting the oldest one when full
+void TelemetryHistory::append(qint64 timestampNs, double latitude, double longitude, double altitude)
+{
+    timestampNs = std::max(timestampNs, lastTimestampNs); // Keep the ring sorted for the binary search
+    lastTimestampNs = timestampNs;
+
+    const quint64 position = committed.load(std::memory_order_relaxed);
+    started.store(position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release); // Readers that see the new fields also see 'started'
+
+    const quint64 slot = position & mask;
+    timestamps[slot].store(timestampNs, std::memory_order_relaxed);
+    latitudes[slot].store(latitude, std::memory_order_relaxed);
+    longitudes[slot].store(longitude, std::memory_order_relaxed);
+    altitudes[slot].store(altitude, std::memory_order_relaxed);
+
+    committed.store(position + 1, std::memory_order_release);
+}
+
+// Copy the samples with fromNs <= timestamp <= toNs into 'snapshot'
+void TelemetryHistory::range(qint64 fromNs, qint64 toNs, Snapshot &snapshot) const
+{
+    snapshot.clear();
+    if (fromNs > toNs)
+    {
+        return;
+    }
+    for (int attempt = 0; attempt < RANGE_ATTEMPTS; ++attempt)
+    {
+        const quint64 end = committed.load(std::memory_order_acquire);
+        const quint64 oldest = end > mask ? end - mask - 1 : 0;
+        const quint64 begin = std::min(end, oldest + (quint64(attempt) * (mask + 1) / 8)); // Stay ahead of a writer lapping the ring
+        const quint64 first = search(begin, end, fromNs, false);
+        const quint64 last = search(first, end, toNs, true);
+
+        const quint64 intact = copyRange(first, last, snapshot);
+        if (intact <= begin)
+        {
+            return; // Nothing the searches read was overwritten, so the bounds are exact
+        }
+        if (attempt + 1 == RANGE_ATTEMPTS)
+        {
+            // Keep what is intact and still in range
+            const auto below = std::lower_bound(snapshot.timestampsNs.begin(), snapshot.timestampsNs.end(), fromNs);
+            dropFront(snapshot, size_t(below - snapshot.timestampsNs.begin()));
+            const auto above = std::upper_bound(snapshot.timestampsNs.begin(), snapshot.timestampsNs.end(), toNs);
+            keepFront(snapshot, size_t(above - snapshot.timestampsNs.begin()));
+        }
+    }
+}
+
+// Copy the newest 'count' samples into 'snapshot'
+void TelemetryHistory::latest(int count, Snapshot &snapshot) const
+{
+    snapshot.clear();
+    const quint64 end = committed.load(std::memory_order_acquire);
+    const quint64 wanted = std::min(quint64(std::max(count, 0)), std::min(end, mask + 1));
+    copyRange(end - wanted, end, snapshot);
+}
+
+// Newest sample
+bool TelemetryHistory::newest(Sample &sample) const
+{
+    for (;;)
+    {
+        const quint64 end = committed.load(std::memory_order_acquire);
+        if (end == 0)
+        {
+            return false;
+        }
+        const quint64 slot = (end - 1) & mask;
+        sample.timestampNs = timestamps[slot].load(std::memory_order_relaxed);
+        sample.latitude = latitudes[slot].load(std::memory_order_relaxed);
+        sample.longitude = longitudes[slot].load(std::memory_order_relaxed);
+        sample.altitude = altitudes[slot].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (started.load(std::memory_order_relaxed) <= end + mask)
+        {
+            return true; // The slot was not reused while it was read
+        }
+    }
+}
+
+// Samples kept at most
+int TelemetryHistory::capacity() const
+{
+    return int(mask + 1);
+}
+
+// Samples kept now
+int TelemetryHistory::size() const
+{
+    return int(std::min(committed.load(std::memory_order_acquire), mask + 1));
+}
+
+// Samples appended since construction
+quint64 TelemetryHistory::appendedCount() const
+{
+    return committed.load(std::memory_order_acquire);
+}
+
+// Copy positions [begin, end) into 'snapshot', dropping those overwritten meanwhile
+quint64 TelemetryHistory::copyRange(quint64 begin, quint64 end, Snapshot &snapshot) const
+{
+    const size_t count = size_t(end - begin);
+    snapshot.timestampsNs.resize(count);
+    snapshot.latitudes.resize(count);
+    snapshot.longitudes.resize(count);
+    snapshot.altitudes.resize(count);
+
+    // One pass per field, so each pass streams through a single array
+    for (size_t i = 0; i < count; ++i)
+    {
+        snapshot.timestampsNs[i] = timestamps[(begin + i) & mask].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        snapshot.latitudes[i] = latitudes[(begin + i) & mask].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        snapshot.longitudes[i] = longitudes[(begin + i) & mask].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        snapshot.altitudes[i] = altitudes[(begin + i) & mask].load(std::memory_order_relaxed);
+    }
+
+    // Position p shares its slot with p + capacity, so every position below started - capacity
+    // may have been overwritten during the copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const quint64 writing = started.load(std::memory_order_relaxed);
+    const quint64 intact = writing > mask ? writing - mask - 1 : 0;
+    if (intact > begin)
+    {
+        dropFront(snapshot, size_t(std::min(intact, end) - begin));
+    }
+    return intact;
+}
+
+// First position in [begin, end) whose timestamp is not below 'timestampNs' (or above it, if 'after')
+quint64 TelemetryHistory::search(quint64 begin, quint64 end, qint64 timestampNs, bool after) const
+{
+    while (begin < end)
+    {
+        const quint64 middle = begin + (end - begin) / 2;
+        const qint64 value = timestamps[middle & mask].load(std::memory_order_relaxed);
+        if (after ? value <= timestampNs : value < timestampNs)
+        {
+            begin = middle + 1;
+        }
+        else
+        {
+            end = middle;
+        }
+    }
+    return begin;
+}
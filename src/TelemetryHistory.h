@@ -0,0 +1,84 @@
+#ifndef TELEMETRYHISTORY_H
+#define TELEMETRYHISTORY_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Recent platform positions, for trend display, diagnostics and export.
+// A fixed-capacity ring of timestamped samples, stored as one array per field (structure of arrays), so
+// a range query over one field touches only that field's cache lines. All memory is allocated by the
+// constructor; once full, each append overwrites the oldest sample.
+//
+// One thread appends (the core's thread); any number of threads may query at the same time without a
+// lock. The writer announces a slot before overwriting it, seqlock style, and a reader that copied a
+// sample while it was being overwritten notices and drops or re-reads it, so snapshots never contain torn
+// samples. Timestamps must not decrease (they come from a MonotonicClock), which keeps time-range queries
+// a binary search.
+class TelemetryHistory
+{
+public:
+    // One sample
+    struct Sample
+    {
+        qint64 timestampNs; // Clock time of the sample
+        double latitude;    // Latitude in degrees
+        double longitude;   // Longitude in degrees
+        double altitude;    // Altitude in meters
+    };
+
+    // Copy of a range of samples, oldest first, one vector per field; reused across queries
+    struct Snapshot
+    {
+        std::vector<qint64> timestampsNs; // Clock time of each sample
+        std::vector<double> latitudes;    // Latitude in degrees
+        std::vector<double> longitudes;   // Longitude in degrees
+        std::vector<double> altitudes;    // Altitude in meters
+
+        int size() const { return int(timestampsNs.size()); }
+        void clear(); // Empty, keeping the allocations
+    };
+
+    // Room for at least 'capacity' samples (rounded up to a power of two)
+    explicit TelemetryHistory(int capacity);
+
+    TelemetryHistory(const TelemetryHistory &) = delete;
+    TelemetryHistory &operator=(const TelemetryHistory &) = delete;
+
+    // Append a sample, overwriting the oldest one when full (writer only; O(1), no allocation).
+    // A timestamp older than the previous sample's is raised to it.
+    void append(qint64 timestampNs, double latitude, double longitude, double altitude);
+
+    // Copy the samples with fromNs <= timestamp <= toNs into 'snapshot' (replacing its content)
+    void range(qint64 fromNs, qint64 toNs, Snapshot &snapshot) const;
+
+    // Copy the newest 'count' samples (fewer if not that many are kept) into 'snapshot'
+    void latest(int count, Snapshot &snapshot) const;
+
+    // Newest sample; returns false if nothing was appended yet
+    bool newest(Sample &sample) const;
+
+    int capacity() const;          // Samples kept at most
+    int size() const;              // Samples kept now
+    quint64 appendedCount() const; // Samples appended since construction
+
+private:
+    // Copy positions [begin, end) into 'snapshot', dropping those overwritten meanwhile; returns the oldest
+    // position still intact
+    quint64 copyRange(quint64 begin, quint64 end, Snapshot &snapshot) const;
+
+    // First position in [begin, end) whose timestamp is not below 'timestampNs' (or above it, if 'after')
+    quint64 search(quint64 begin, quint64 end, qint64 timestampNs, bool after) const;
+
+    const quint64 mask;                                // Capacity - 1, used to wrap positions
+    std::unique_ptr<std::atomic<qint64>[]> timestamps; // Timestamp per slot
+    std::unique_ptr<std::atomic<double>[]> latitudes;  // Latitude per slot
+    std::unique_ptr<std::atomic<double>[]> longitudes; // Longitude per slot
+    std::unique_ptr<std::atomic<double>[]> altitudes;  // Altitude per slot
+    alignas(64) std::atomic<quint64> started;          // Positions the writer has begun to write
+    alignas(64) std::atomic<quint64> committed;        // Positions completely written
+    qint64 lastTimestampNs;                            // Timestamp of the newest sample (writer only)
+};
+
+#endif
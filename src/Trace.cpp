@@ -0,0 +1,140 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "GlobalConstants.h"
+#include "Logger.h"
+
+namespace
+{
+    // Spans of one thread. Only the owning thread appends; stop() reads up to 'count' from any thread.
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Trace::Event[]> events; // TRACE_BUFFER_EVENTS slots, allocated by the first record()
+        std::atomic<int> count{0};              // Slots filled, published with release
+        std::atomic<quint64> dropped{0};        // Spans lost because the buffer was full
+        int threadId = 0;                       // Small id shown as the trace's tid
+        QByteArray threadName;                  // Name shown in the trace (guarded by bufferMutex)
+    };
+
+    std::mutex bufferMutex;                             // Guards buffers and tracePath
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; // Every thread that recorded or was named; kept after the thread exits
+    QString tracePath;                                  // File written by stop()
+    thread_local ThreadBuffer *currentBuffer = nullptr; // Buffer of the calling thread
+
+    // Buffer of the calling thread, created on first use without its event slots
+    ThreadBuffer *threadBuffer()
+    {
+        if (!currentBuffer)
+        {
+            std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            buffer->threadId = int(buffers.size()) + 1;
+            buffer->threadName = "thread " + QByteArray::number(buffer->threadId);
+            currentBuffer = buffer.get();
+            buffers.push_back(std::move(buffer));
+        }
+        return currentBuffer;
+    }
+
+    // Microseconds with nanosecond precision, as the trace-event format expects
+    QByteArray microseconds(qint64 ns)
+    {
+        return QByteArray::number(double(ns) / 1000.0, 'f', 3);
+    }
+}
+
+namespace Trace
+{
+    std::atomic<bool> enabled(false);
+
+    // Start recording spans
+    void start(const QString &path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            tracePath = path;
+        }
+        setThreadName("main"); // Started from the main thread
+        enabled.store(true, std::memory_order_relaxed);
+        LOG_INFO(QString("Trace: Recording spans to %1").arg(path));
+    }
+
+    // Stop recording and write the spans as Chrome trace-event JSON
+    bool stop()
+    {
+        if (!enabled.exchange(false, std::memory_order_relaxed))
+        {
+            return true; // Not tracing
+        }
+
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+        QByteArray json;
+        json.reserve(1024 * 1024);
+        json.append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        quint64 spans = 0;
+        quint64 dropped = 0;
+        bool first = true;
+        for (const std::unique_ptr<ThreadBuffer> &buffer : buffers)
+        {
+            const QByteArray tid = QByteArray::number(buffer->threadId);
+            json.append(first ? "" : ",\n");
+            json.append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid +
+                        ",\"args\":{\"name\":\"" + buffer->threadName + "\"}}");
+            first = false;
+
+            const int count = buffer->count.load(std::memory_order_acquire);
+            for (int i = 0; i < count; ++i)
+            {
+                const Event &event = buffer->events[i];
+                json.append(",\n{\"ph\":\"X\",\"name\":\"");
+                json.append(event.name);
+                json.append("\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":" + microseconds(event.startNs) +
+                            ",\"dur\":" + microseconds(event.durationNs) + "}");
+            }
+            spans += quint64(count);
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        json.append("\n]}\n");
+
+        QFile file(tracePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size())
+        {
+            LOG_ERROR(QString("Trace: Cannot write %1: %2").arg(tracePath, file.errorString()));
+            return false;
+        }
+        LOG_INFO(QString("Trace: Wrote %1 spans to %2 (%3 dropped on full buffers)").arg(spans).arg(tracePath).arg(dropped));
+        return true;
+    }
+
+    // Name the calling thread in the trace
+    void setThreadName(const char *name)
+    {
+        ThreadBuffer *buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        buffer->threadName = name;
+    }
+
+    // Append a completed span to the calling thread's buffer
+    void record(const char *name, qint64 startNs, qint64 endNs)
+    {
+        ThreadBuffer *buffer = threadBuffer();
+        if (!buffer->events)
+        {
+            // Only threads that trace pay for the slots; naming a thread, or one running while tracing is off, costs none.
+            // Published to stop() by the release store of 'count' below.
+            buffer->events.reset(new Event[GlobalConstants::TRACE_BUFFER_EVENTS]);
+        }
+        const int index = buffer->count.load(std::memory_order_relaxed); // Only this thread writes 'count'
+        if (index >= GlobalConstants::TRACE_BUFFER_EVENTS)
+        {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed); // Keep the start of the trace, never block
+            return;
+        }
+        buffer->events[index] = {name, startNs, endNs - startNs};
+        buffer->count.store(index + 1, std::memory_order_release); // Publish the slot to stop()
+    }
+}
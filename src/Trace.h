@@ -0,0 +1,80 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <atomic>
+#include "MonotonicTime.h"
+
+// Set to 0 (DEFINES += AKS_TRACE_COMPILED=0) to compile every TRACE_SCOPE out
+#ifndef AKS_TRACE_COMPILED
+#define AKS_TRACE_COMPILED 1
+#endif
+
+// Scoped trace spans for following a datagram through the application, written as Chrome trace-event
+// JSON that chrome://tracing and Perfetto (ui.perfetto.dev) open directly.
+//
+// Tracing is off unless started with AKS_TRACE=<file> or --trace <file>. A disabled TRACE_SCOPE costs
+// one relaxed atomic load. An enabled one reads the steady clock twice and appends the span to a buffer
+// owned by the calling thread, without locks; the buffers are written to the file by stop().
+namespace Trace
+{
+    // One completed span
+    struct Event
+    {
+        const char *name;  // Span name, a string literal
+        qint64 startNs;    // Steady clock at entry
+        qint64 durationNs; // Time spent inside the span
+    };
+
+    extern std::atomic<bool> enabled; // Spans are recorded; use isEnabled()
+
+    // True while spans are recorded
+    inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Start recording spans; stop() writes them to 'path'
+    void start(const QString &path);
+
+    // Stop recording and write every span recorded so far; returns false if the file cannot be written
+    bool stop();
+
+    // Name the calling thread in the trace (e.g. "network-io"); threads default to "thread <n>"
+    void setThreadName(const char *name);
+
+    // Append a completed span to the calling thread's buffer (used by Scope)
+    void record(const char *name, qint64 startNs, qint64 endNs);
+
+    // Records the time from its construction to its destruction as a span named 'name'
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name) : name(name), startNs(isEnabled() ? MonotonicTime::nowNs() : -1) {}
+        ~Scope()
+        {
+            if (startNs >= 0)
+            {
+                record(name, startNs, MonotonicTime::nowNs());
+            }
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *name; // Span name
+        qint64 startNs;   // Steady clock at entry, -1 when tracing was off
+    };
+}
+
+// Trace the rest of the enclosing block as a span named 'name' (a string literal)
+#if AKS_TRACE_COMPILED
+#define AKS_TRACE_CONCAT_INNER(a, b) a##b
+#define AKS_TRACE_CONCAT(a, b) AKS_TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope AKS_TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) \
+    do                    \
+    {                     \
+    } while (0)
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+#include "TrendPlotWidget.h"
+#include "GlobalConstants.h"
+#include "Trace.h"
+#include <QPainter>
+#include <QResizeEvent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const double SCALE_MARGIN = 0.1; // Headroom above and below the values shown, as a fraction of their range
+}
+
+// Constructor for TrendPlotWidget
+TrendPlotWidget::TrendPlotWidget(const QString &title, QWidget *parent)
+    : QWidget(parent), title(title), history(nullptr), field(Altitude), spanNs(GlobalConstants::TREND_PLOT_SPAN_MS * 1000000),
+      consumed(0), lastTimestampNs(std::numeric_limits<qint64>::min()), scaleMinimum(0), scaleMaximum(1), newestValue(0), hasValue(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent); // paintEvent() covers every pixel
+}
+
+// Plot 'field' of 'history'
+void TrendPlotWidget::setSource(const TelemetryHistory *history, Field field)
+{
+    this->history = history;
+    this->field = field;
+    consumed = 0;
+    lastTimestampNs = std::numeric_limits<qint64>::min();
+    hasValue = false;
+    decimator.clear();
+    refresh(); // Folds in what the history already holds
+    redrawAll();
+}
+
+// Time shown across the widget
+void TrendPlotWidget::setTimeSpan(qint64 spanMs)
+{
+    spanNs = std::max<qint64>(spanMs, 1) * 1000000;
+    fitColumnsToWidth();
+    redrawAll();
+}
+
+// Fold in the samples appended since the previous call and repaint what changed
+void TrendPlotWidget::refresh()
+{
+    TRACE_SCOPE("TrendPlotWidget::refresh");
+    if (!history)
+    {
+        return;
+    }
+    const quint64 appended = history->appendedCount();
+    if (appended == consumed)
+    {
+        return; // Nothing new
+    }
+    consumed = appended;
+
+    // From the newest sample already folded in, which changes no column, so none is missed
+    history->range(lastTimestampNs, std::numeric_limits<qint64>::max(), pulled);
+    if (pulled.size() == 0)
+    {
+        return;
+    }
+    const std::vector<double> &values = field == Latitude ? pulled.latitudes : (field == Longitude ? pulled.longitudes : pulled.altitudes);
+    for (int i = 0; i < pulled.size(); ++i)
+    {
+        decimator.add(pulled.timestampsNs[i], values[i]);
+    }
+    lastTimestampNs = pulled.timestampsNs.back();
+    newestValue = values.back();
+    hasValue = true;
+
+    if (plot.isNull())
+    {
+        return; // Not laid out yet; resizeEvent() draws everything
+    }
+    const MinMaxDecimator::Changes changes = decimator.takeChanges();
+    if (changes.scrolled >= decimator.columnCount() || !fitsScale(changes.firstDirty))
+    {
+        redrawAll();
+        return;
+    }
+    if (changes.scrolled > 0)
+    {
+        plot.scroll(-changes.scrolled, 0, plot.rect()); // Keep the columns already drawn
+    }
+    redrawColumns(changes.firstDirty);
+    update();
+}
+
+// Default plot size
+QSize TrendPlotWidget::sizeHint() const
+{
+    return QSize(300, 100);
+}
+
+// Smallest useful plot size
+QSize TrendPlotWidget::minimumSizeHint() const
+{
+    return QSize(100, 60);
+}
+
+// Handle paint events
+void TrendPlotWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event); // Copying the whole pixmap is cheaper than clipping it
+    QPainter painter(this);
+    if (plot.isNull())
+    {
+        painter.fillRect(rect(), palette().color(QPalette::Base));
+    }
+    else
+    {
+        painter.drawPixmap(rect(), plot); // Device pixels onto the same device pixels
+    }
+
+    const int decimals = field == Altitude ? 2 : 6; // As in the platform fields
+    const QRect textRect = rect().adjusted(4, 2, -4, -2);
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(textRect, Qt::AlignLeft | Qt::AlignTop, hasValue ? title + ": " + QString::number(newestValue, 'f', decimals) : title);
+    if (hasValue)
+    {
+        painter.drawText(textRect, Qt::AlignRight | Qt::AlignTop, QString::number(scaleMaximum, 'f', decimals));
+        painter.drawText(textRect, Qt::AlignRight | Qt::AlignBottom, QString::number(scaleMinimum, 'f', decimals));
+    }
+    painter.drawText(textRect, Qt::AlignLeft | Qt::AlignBottom, QString("-%1 min").arg(spanNs / 60000000000LL));
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+}
+
+// Handle resize events
+void TrendPlotWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    fitColumnsToWidth();
+    redrawAll();
+}
+
+// Match the decimator's columns to the widget's width in device pixels
+void TrendPlotWidget::fitColumnsToWidth()
+{
+    const QSize pixels = size() * devicePixelRatioF();
+    decimator.setGeometry(pixels.width(), spanNs);
+    if (pixels.isEmpty())
+    {
+        plot = QPixmap();
+    }
+    else if (plot.size() != pixels)
+    {
+        plot = QPixmap(pixels);
+    }
+}
+
+// Rescale to the values shown and redraw every column
+void TrendPlotWidget::redrawAll()
+{
+    decimator.takeChanges(); // Everything is drawn below
+    if (plot.isNull())
+    {
+        return;
+    }
+    double minimum;
+    double maximum;
+    if (decimator.valueRange(minimum, maximum))
+    {
+        const double margin = maximum > minimum ? (maximum - minimum) * SCALE_MARGIN : std::max(std::fabs(maximum), 1.0) * 1e-6;
+        scaleMinimum = minimum - margin;
+        scaleMaximum = maximum + margin;
+    }
+    redrawColumns(0);
+    update();
+}
+
+// Redraw the columns from 'firstX' to the newest
+void TrendPlotWidget::redrawColumns(int firstX)
+{
+    QPainter painter(&plot);
+    painter.fillRect(firstX, 0, plot.width() - firstX, plot.height(), palette().color(QPalette::Base));
+    painter.setPen(QColor(0, 90, 200));
+    for (int x = firstX; x < decimator.columnCount(); ++x)
+    {
+        const MinMaxDecimator::Column &column = decimator.column(x);
+        if (!column.valid)
+        {
+            continue;
+        }
+        double low = column.minimum;
+        double high = column.maximum;
+        if (x > 0 && decimator.column(x - 1).valid)
+        {
+            // Reach the previous column, so the trend reads as one line
+            low = std::min(low, decimator.column(x - 1).maximum);
+            high = std::max(high, decimator.column(x - 1).minimum);
+        }
+        painter.drawLine(x, qRound(toY(high)), x, qRound(toY(low)));
+    }
+}
+
+// True if the columns from 'firstX' fit the current scale
+bool TrendPlotWidget::fitsScale(int firstX) const
+{
+    for (int x = firstX; x < decimator.columnCount(); ++x)
+    {
+        const MinMaxDecimator::Column &column = decimator.column(x);
+        if (column.valid && (column.minimum < scaleMinimum || column.maximum > scaleMaximum))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pixmap row of a value
+double TrendPlotWidget::toY(double value) const
+{
+    return (scaleMaximum - value) / (scaleMaximum - scaleMinimum) * (plot.height() - 1);
+}
@@ -0,0 +1,71 @@
+#ifndef TRENDPLOTWIDGET_H
+#define TRENDPLOTWIDGET_H
+
+#include <QWidget>
+#include <QPixmap>
+#include "MinMaxDecimator.h"
+#include "TelemetryHistory.h"
+
+// Trend of one platform telemetry field over the last hour (GlobalConstants::TREND_PLOT_SPAN_MS).
+// Samples are pulled from a TelemetryHistory on refresh() and reduced to one min/max pair per pixel
+// column (see MinMaxDecimator), so hours of samples cost no more to draw than a few. The plot is kept
+// in a pixmap: a refresh scrolls it by the columns that went by and paints only the columns that
+// changed, and paintEvent() just copies it. The whole plot is redrawn only when the widget is resized
+// or a sample falls outside the current value scale.
+class TrendPlotWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // Plotted field
+    enum Field
+    {
+        Latitude,
+        Longitude,
+        Altitude
+    };
+
+    explicit TrendPlotWidget(const QString &title, QWidget *parent = nullptr); // Constructor, empty until setSource()
+
+    // Plot 'field' of 'history', starting with the samples it already holds
+    void setSource(const TelemetryHistory *history, Field field);
+
+    // Time shown across the widget
+    void setTimeSpan(qint64 spanMs);
+
+    // Fold in the samples appended since the previous call and repaint what changed
+    void refresh();
+
+    QSize sizeHint() const override;        // Default plot size
+    QSize minimumSizeHint() const override; // Smallest useful plot size
+
+protected:
+    // Handle paint events
+    void paintEvent(QPaintEvent *event) override;
+
+    // Handle resize events
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void fitColumnsToWidth();         // Match the decimator's columns to the widget's width in device pixels
+    void redrawAll();                 // Rescale to the values shown and redraw every column
+    void redrawColumns(int firstX);   // Redraw the columns from 'firstX' to the newest
+    bool fitsScale(int firstX) const; // True if the columns from 'firstX' fit the current scale
+    double toY(double value) const;   // Pixmap row of a value
+
+    QString title;                     // Shown in the top left corner
+    const TelemetryHistory *history;   // Sample source, null before setSource()
+    Field field;                       // Plotted field
+    qint64 spanNs;                     // Time shown across the widget
+    quint64 consumed;                  // history->appendedCount() at the previous refresh()
+    qint64 lastTimestampNs;            // Newest sample folded in
+    TelemetryHistory::Snapshot pulled; // New samples, reused by every refresh()
+    MinMaxDecimator decimator;         // One min/max pair per pixel column
+    QPixmap plot;                      // Drawn columns, in device pixels
+    double scaleMinimum;               // Value at the bottom row
+    double scaleMaximum;               // Value at the top row
+    double newestValue;                // Latest sample, shown next to the title
+    bool hasValue;                     // newestValue holds a sample
+};
+
+#endif
@@ -0,0 +1,65 @@
+# Core sources shared by the GUI application, the headless service and the benchmarks.
+# Everything listed here needs QtCore and QtNetwork only, never QtWidgets.
+
+QT += core network
+CONFIG += c++17
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/AKSCore.cpp \
+    $$PWD/AuditLog.cpp \
+    $$PWD/BinaryLogFormat.cpp \
+    $$PWD/CommunicationManager.cpp \
+    $$PWD/ConfigReader.cpp \
+    $$PWD/DatagramCapture.cpp \
+    $$PWD/DatagramReplayer.cpp \
+    $$PWD/DeadlineScheduler.cpp \
+    $$PWD/EventBus.cpp \
+    $$PWD/IngestQueue.cpp \
+    $$PWD/LinkStatistics.cpp \
+    $$PWD/LogArchiver.cpp \
+    $$PWD/Logger.cpp \
+    $$PWD/Metrics.cpp \
+    $$PWD/MetricsExporter.cpp \
+    $$PWD/MinMaxDecimator.cpp \
+    $$PWD/MonotonicClock.cpp \
+    $$PWD/NetworkConfig.cpp \
+    $$PWD/NetworkIOThread.cpp \
+    $$PWD/NumberFormat.cpp \
+    $$PWD/PlatformInfoCoalescer.cpp \
+    $$PWD/Protocol.cpp \
+    $$PWD/StartupTimeline.cpp \
+    $$PWD/TelemetryHistory.cpp \
+    $$PWD/Trace.cpp
+
+HEADERS += \
+    $$PWD/AKSCore.h \
+    $$PWD/AuditLog.h \
+    $$PWD/BinaryLogFormat.h \
+    $$PWD/CommunicationManager.h \
+    $$PWD/ConfigReader.h \
+    $$PWD/DatagramCapture.h \
+    $$PWD/DatagramReplayer.h \
+    $$PWD/DeadlineScheduler.h \
+    $$PWD/EventBus.h \
+    $$PWD/Events.h \
+    $$PWD/GlobalConstants.h \
+    $$PWD/IngestQueue.h \
+    $$PWD/LinkStatistics.h \
+    $$PWD/LockFreeQueue.h \
+    $$PWD/LogArchiver.h \
+    $$PWD/Logger.h \
+    $$PWD/Metrics.h \
+    $$PWD/MetricsExporter.h \
+    $$PWD/MinMaxDecimator.h \
+    $$PWD/MonotonicClock.h \
+    $$PWD/MonotonicTime.h \
+    $$PWD/NetworkConfig.h \
+    $$PWD/NetworkIOThread.h \
+    $$PWD/NumberFormat.h \
+    $$PWD/PlatformInfoCoalescer.h \
+    $$PWD/Protocol.h \
+    $$PWD/StartupTimeline.h \
+    $$PWD/TelemetryHistory.h \
+    $$PWD/Trace.h
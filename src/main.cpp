@@ -1,17 +1,42 @@
-#include <QApplication>
-#include "AKSApp.h"
-
-int main(int argc, char *argv[])
-{
-    // Initialize the QApplication object with command line arguments
-    QApplication app(argc, argv);
-
-    // Create an instance of the main application window
-    AKSApp mainWindow;
-
-    // Show the main application window
-    mainWindow.show();
-
-    // Enter the main event loop and wait for events
-    return app.exec();
-}
\ No newline at end of file
+#include <QApplication>
+#include "AKSApp.h"
+#include "Logger.h"
+#include "MonotonicClock.h"
+#include "StartupTimeline.h"
+#include "Trace.h"
+
+// Usage: AKS_Project [--trace <file>]
+// --trace (or AKS_TRACE=<file>) records trace spans and writes them as Chrome trace-event JSON on exit.
+int main(int argc, char *argv[])
+{
+    const qint64 startNs = MonotonicClock::system()->nowNs(); // Origin of the startup timeline
+
+    // Initialize the QApplication object with command line arguments
+    QApplication app(argc, argv);
+    StartupTimeline timeline(MonotonicClock::system(), startNs);
+    timeline.recordPhase("application", startNs, MonotonicClock::system()->nowNs());
+
+    const QStringList arguments = app.arguments();
+    const int traceIndex = arguments.indexOf("--trace");
+    const QString tracePath = traceIndex > 0 && traceIndex + 1 < arguments.size() ? arguments.at(traceIndex + 1)
+                                                                                 : qEnvironmentVariable("AKS_TRACE");
+    if (!tracePath.isEmpty())
+    {
+        Trace::start(tracePath); // Before the window, so startup is traced too
+    }
+
+    int result;
+    {
+        // Create an instance of the main application window; the core starts first, the widgets follow
+        // and the window shows itself once they are built
+        AKSApp mainWindow(&timeline);
+
+        // Enter the main event loop and wait for events
+        result = app.exec();
+    }
+
+    // Write the trace and any queued log entries before the process exits
+    Trace::stop();
+    Logger::instance().shutdown();
+    return result;
+}
@@ -0,0 +1,16 @@
+QT -= gui
+QT += core
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = aks_log_decoder
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    main.cpp \
+    ../../src/BinaryLogFormat.cpp
+
+HEADERS += \
+    ../../src/BinaryLogFormat.h
@@ -0,0 +1,90 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include "BinaryLogFormat.h"
+
+// Offline decoder for binary AKS logs (AKS_LOG_FORMAT=binary).
+// Usage: aks_log_decoder <aks_log.bin> [output.txt]
+// Writes the same "yyyy-MM-dd hh:mm:ss.zzz [LEVEL] message" lines the text logger produces.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    QTextStream err(stderr);
+
+    if (arguments.size() < 2 || arguments.size() > 3)
+    {
+        err << "Usage: aks_log_decoder <aks_log.bin> [output.txt]\n";
+        return 1;
+    }
+
+    QFile input(arguments[1]);
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        err << "Failed to open " << arguments[1] << ": " << input.errorString() << "\n";
+        return 1;
+    }
+    QByteArray data = input.readAll(); // Binary logs are compact, read them in one go
+
+    QFile output;
+    if (arguments.size() == 3)
+    {
+        output.setFileName(arguments[2]);
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            err << "Failed to open " << arguments[2] << ": " << output.errorString() << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+    QTextStream out(&output);
+
+    quint32 version = 0;
+    if (!BinaryLog::readFileHeader(data.constData(), data.size(), &version))
+    {
+        err << arguments[1] << " is not a binary AKS log\n";
+        return 1;
+    }
+    if (version != BinaryLog::FORMAT_VERSION)
+    {
+        err << "Unsupported log format version " << version << "\n";
+        return 1;
+    }
+
+    const char *cursor = data.constData() + BinaryLog::FILE_HEADER_SIZE;
+    const char *end = data.constData() + data.size();
+    qint64 wallClockAnchorMs = 0; // Anchors of the session currently being decoded
+    qint64 monotonicAnchorNs = 0;
+    qint64 recordCount = 0;
+
+    BinaryLog::Record record;
+    while (cursor < end)
+    {
+        if (!BinaryLog::readRecord(cursor, end, record))
+        {
+            err << "Truncated record at offset " << (cursor - data.constData()) << ", stopping\n";
+            break;
+        }
+
+        if (record.messageId == BinaryLog::SessionStart)
+        {
+            BinaryLog::readSessionAnchor(record.payload, record.payloadSize, &wallClockAnchorMs, &monotonicAnchorNs);
+            continue; // Anchors are metadata, not log lines
+        }
+
+        qint64 timestamp = wallClockAnchorMs + (record.timestampNs - monotonicAnchorNs) / 1000000;
+        out << QDateTime::fromMSecsSinceEpoch(timestamp).toString("yyyy-MM-dd hh:mm:ss.zzz")
+            << " [" << BinaryLog::levelName(record.level) << "] "
+            << BinaryLog::formatMessage(record.messageId, record.payload, record.payloadSize, record.argCount)
+            << "\n";
+        ++recordCount;
+    }
+
+    out.flush();
+    err << "Decoded " << recordCount << " records\n";
+    return 0;
+}